@@ -0,0 +1,121 @@
+/*
+   Runtime selection of the blake2b implementation.
+
+   On x86 the build compiles blake2b.c once per ISA level with its entry
+   points suffixed (_sse2, _sse41, _avx2). The public blake2b functions
+   below forward to the best one the running CPU supports, so a single
+   binary uses AVX2 where available and still runs on plain x86-64.
+*/
+
+#include <stddef.h>
+
+#include "blake2.h"
+#include "blake2b-dispatch.h"
+
+#if defined(BLAKE2B_DISPATCH)
+
+#include <stdatomic.h>
+
+#define BLAKE2B_DECLARE_KERNEL(suffix)                                              \
+  int blake2b_init_param_##suffix( blake2b_state *S, const blake2b_param *P );      \
+  int blake2b_init_##suffix( blake2b_state *S, size_t outlen );                     \
+  int blake2b_init_key_##suffix( blake2b_state *S, size_t outlen, const void *key,  \
+                                 size_t keylen );                                   \
+  int blake2b_update_##suffix( blake2b_state *S, const void *in, size_t inlen );    \
+  int blake2b_final_##suffix( blake2b_state *S, void *out, size_t outlen );         \
+  int blake2b_##suffix( void *out, size_t outlen, const void *in, size_t inlen,     \
+                        const void *key, size_t keylen );                           \
+  static const blake2b_kernel_t blake2b_kernel_##suffix = {                         \
+    #suffix, blake2b_init_param_##suffix, blake2b_init_##suffix,                    \
+    blake2b_init_key_##suffix, blake2b_update_##suffix, blake2b_final_##suffix,     \
+    blake2b_##suffix                                                                \
+  };
+
+typedef struct blake2b_kernel_t__
+{
+  const char *name;
+  int ( *init_param )( blake2b_state *, const blake2b_param * );
+  int ( *init )( blake2b_state *, size_t );
+  int ( *init_key )( blake2b_state *, size_t, const void *, size_t );
+  int ( *update )( blake2b_state *, const void *, size_t );
+  int ( *final )( blake2b_state *, void *, size_t );
+  int ( *hash )( void *, size_t, const void *, size_t, const void *, size_t );
+} blake2b_kernel_t;
+
+BLAKE2B_DECLARE_KERNEL(sse2)
+BLAKE2B_DECLARE_KERNEL(sse41)
+BLAKE2B_DECLARE_KERNEL(avx2)
+
+static _Atomic(const blake2b_kernel_t *) blake2b_selected = NULL;
+
+static const blake2b_kernel_t *blake2b_detect( void )
+{
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx2" ) )
+    return &blake2b_kernel_avx2;
+  if( __builtin_cpu_supports( "sse4.1" ) && __builtin_cpu_supports( "ssse3" ) )
+    return &blake2b_kernel_sse41;
+  return &blake2b_kernel_sse2;
+}
+
+/* Detection is idempotent, so racing first callers just store the same pointer */
+static const blake2b_kernel_t *blake2b_current( void )
+{
+  const blake2b_kernel_t *kernel =
+    atomic_load_explicit( &blake2b_selected, memory_order_acquire );
+  if( kernel == NULL )
+  {
+    kernel = blake2b_detect();
+    atomic_store_explicit( &blake2b_selected, kernel, memory_order_release );
+  }
+  return kernel;
+}
+
+int blake2b_init_param( blake2b_state *S, const blake2b_param *P )
+{
+  return blake2b_current()->init_param( S, P );
+}
+
+int blake2b_init( blake2b_state *S, size_t outlen )
+{
+  return blake2b_current()->init( S, outlen );
+}
+
+int blake2b_init_key( blake2b_state *S, size_t outlen, const void *key, size_t keylen )
+{
+  return blake2b_current()->init_key( S, outlen, key, keylen );
+}
+
+int blake2b_update( blake2b_state *S, const void *in, size_t inlen )
+{
+  return blake2b_current()->update( S, in, inlen );
+}
+
+int blake2b_final( blake2b_state *S, void *out, size_t outlen )
+{
+  return blake2b_current()->final( S, out, outlen );
+}
+
+int blake2b( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen )
+{
+  return blake2b_current()->hash( out, outlen, in, inlen, key, keylen );
+}
+
+int blake2( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen )
+{
+  return blake2b_current()->hash( out, outlen, in, inlen, key, keylen );
+}
+
+const char *blake2b_kernel( void )
+{
+  return blake2b_current()->name;
+}
+
+#else
+
+const char *blake2b_kernel( void )
+{
+  return BLAKE2B_KERNEL;
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef BLAKE2B_DISPATCH_H
+#define BLAKE2B_DISPATCH_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+  /* Name of the blake2b compress kernel in use: "ref", "sse2", "sse41" or "avx2" */
+  const char *blake2b_kernel( void );
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -9,9 +9,12 @@
 	void ed25519_hash(uint8_t *hash, const uint8_t *in, size_t inlen);
 */
 
+#include <blake2/blake2.h>
+
+/* the blake2b state lives inline so hashing never touches the heap */
 typedef struct ed25519_hash_context_t
 {
-    void * blake2;
+    blake2b_state blake2;
 } ed25519_hash_context;
 
 void ed25519_hash_init (ed25519_hash_context * ctx);
@@ -240,7 +240,8 @@ size_t rai::Block::Size() const
 
 bool rai::Block::CheckSignature_() const
 {
-    signature_error_ = rai::ValidateMessage(Account(), Hash(), Signature());
+    signature_error_ =
+        rai::ValidateMessageCached(Account(), Hash(), Signature());
     signature_checked_ = true;
     return signature_error_;
 }
@@ -729,6 +730,43 @@ void rai::TxBlock::SerializeJson(rai::Ptree& ptree) const
     ptree.put("signature", signature_.StringHex());
 }
 
+void rai::TxBlock::SerializeJson(rai::JsonWriter& writer) const
+{
+    writer.StartObject();
+    writer.Put("type", rai::BlockTypeToString(type_));
+    writer.Put("opcode", rai::BlockOpcodeToString(opcode_));
+    writer.Put("credit", credit_);
+    writer.Put("counter", counter_);
+    writer.Put("timestamp", timestamp_);
+    writer.Put("height", height_);
+    writer.Put("account", account_.StringAccount());
+    writer.Put("previous", previous_.StringHex());
+    writer.Put("representative", representative_.StringAccount());
+    writer.Put("balance", balance_.StringDec());
+    if (rai::BlockOpcode::SEND == opcode_)
+    {
+        writer.Put("link", link_.StringAccount());
+    }
+    else
+    {
+        writer.Put("link", link_.StringHex());
+    }
+    writer.Put("extensions_length", extensions_length_);
+    writer.Key("extensions");
+    if (extensions_.empty())
+    {
+        writer.String("");
+    }
+    else
+    {
+        rai::Ptree extensions;
+        rai::ExtensionsToPtree(extensions_, extensions);
+        writer.Value(extensions);
+    }
+    writer.Put("signature", signature_.StringHex());
+    writer.EndObject();
+}
+
 rai::ErrorCode rai::TxBlock::DeserializeJson(const rai::Ptree& ptree)
 {
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
@@ -1105,6 +1143,30 @@ void rai::RepBlock::SerializeJson(rai::Ptree& ptree) const
     ptree.put("signature", signature_.StringHex());
 }
 
+void rai::RepBlock::SerializeJson(rai::JsonWriter& writer) const
+{
+    writer.StartObject();
+    writer.Put("type", rai::BlockTypeToString(rai::BlockType::REP_BLOCK));
+    writer.Put("opcode", rai::BlockOpcodeToString(opcode_));
+    writer.Put("credit", credit_);
+    writer.Put("counter", counter_);
+    writer.Put("timestamp", timestamp_);
+    writer.Put("height", height_);
+    writer.Put("account", account_.StringAccount());
+    writer.Put("previous", previous_.StringHex());
+    writer.Put("balance", balance_.StringDec());
+    if (rai::BlockOpcode::SEND == opcode_)
+    {
+        writer.Put("link", link_.StringAccount());
+    }
+    else
+    {
+        writer.Put("link", link_.StringHex());
+    }
+    writer.Put("signature", signature_.StringHex());
+    writer.EndObject();
+}
+
 rai::ErrorCode rai::RepBlock::DeserializeJson(const rai::Ptree& ptree)
 {
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
@@ -1453,6 +1515,24 @@ void rai::AdBlock::SerializeJson(rai::Ptree& ptree) const
     ptree.put("signature", signature_.StringHex());
 }
 
+void rai::AdBlock::SerializeJson(rai::JsonWriter& writer) const
+{
+    writer.StartObject();
+    writer.Put("type", rai::BlockTypeToString(type_));
+    writer.Put("opcode", rai::BlockOpcodeToString(opcode_));
+    writer.Put("credit", credit_);
+    writer.Put("counter", counter_);
+    writer.Put("timestamp", timestamp_);
+    writer.Put("height", height_);
+    writer.Put("account", account_.StringAccount());
+    writer.Put("previous", previous_.StringHex());
+    writer.Put("representative", representative_.StringAccount());
+    writer.Put("balance", balance_.StringDec());
+    writer.Put("link", link_.StringHex());
+    writer.Put("signature", signature_.StringHex());
+    writer.EndObject();
+}
+
 rai::ErrorCode rai::AdBlock::DeserializeJson(const rai::Ptree& ptree)
 {
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
@@ -4,6 +4,7 @@
 #include <blake2/blake2.h>
 #include <boost/property_tree/json_parser.hpp>
 #include <rai/common/errors.hpp>
+#include <rai/common/json.hpp>
 #include <rai/common/numbers.hpp>
 #include <rai/common/util.hpp>
 
@@ -53,6 +54,7 @@ public:
     virtual void Serialize(rai::Stream&) const                = 0;
     virtual rai::ErrorCode Deserialize(rai::Stream&)          = 0;
     virtual void SerializeJson(rai::Ptree&) const             = 0;
+    virtual void SerializeJson(rai::JsonWriter&) const        = 0;
     virtual rai::ErrorCode DeserializeJson(const rai::Ptree&) = 0;
     virtual void SetSignature(const rai::uint512_union&)      = 0;
     virtual rai::Signature Signature() const                  = 0;
@@ -121,6 +123,7 @@ public:
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
     void SerializeJson(rai::Ptree&) const override;
+    void SerializeJson(rai::JsonWriter&) const override;
     rai::ErrorCode DeserializeJson(const rai::Ptree&) override;
     void SetSignature(const rai::uint512_union&) override;
     rai::Signature Signature() const override;
@@ -182,6 +185,7 @@ public:
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
     void SerializeJson(rai::Ptree&) const override;
+    void SerializeJson(rai::JsonWriter&) const override;
     rai::ErrorCode DeserializeJson(const rai::Ptree&) override;
     void SetSignature(const rai::uint512_union&) override;
     rai::Signature Signature() const override;
@@ -234,6 +238,7 @@ public:
     void Serialize(rai::Stream&) const override;
     rai::ErrorCode Deserialize(rai::Stream&) override;
     void SerializeJson(rai::Ptree&) const override;
+    void SerializeJson(rai::JsonWriter&) const override;
     rai::ErrorCode DeserializeJson(const rai::Ptree&) override;
     void SetSignature(const rai::uint512_union&) override;
     rai::Signature Signature() const override;
@@ -482,6 +482,99 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "Unknown event";
         }
+        case rai::ErrorCode::SNAPSHOT_FORMAT:
+        {
+            return "Invalid snapshot file";
+        }
+        case rai::ErrorCode::SNAPSHOT_VERSION:
+        {
+            return "Unknown snapshot version";
+        }
+        case rai::ErrorCode::SNAPSHOT_NETWORK:
+        {
+            return "The snapshot was exported from another network";
+        }
+        case rai::ErrorCode::SNAPSHOT_CHECKSUM:
+        {
+            return "Snapshot checksum mismatch";
+        }
+        case rai::ErrorCode::SNAPSHOT_LEDGER_NOT_EMPTY:
+        {
+            return "The ledger is not empty, please import the snapshot into "
+                   "an empty <data_path>";
+        }
+        case rai::ErrorCode::SNAPSHOT_GENESIS:
+        {
+            return "The genesis block in the snapshot is invalid";
+        }
+        case rai::ErrorCode::SNAPSHOT_ACCOUNT_HEAD:
+        {
+            return "Account head or tail in the snapshot is inconsistent";
+        }
+        case rai::ErrorCode::LEDGER_PUT:
+        {
+            return "Failed to put data to the ledger";
+        }
+        case rai::ErrorCode::LEDGER_PRUNE:
+        {
+            return "Failed to prune the ledger";
+        }
+        case rai::ErrorCode::CONFIG_STORAGE_VERSION:
+        {
+            return "Unknown storage config version";
+        }
+        case rai::ErrorCode::MDB_ENV_SET_FLAGS:
+        {
+            return "Failed to set flags of MDB environment";
+        }
+        case rai::ErrorCode::MDB_ENV_SYNC:
+        {
+            return "Failed to flush MDB environment to disk";
+        }
+        case rai::ErrorCode::MESSAGE_CONFIRM_BATCH_SIZE:
+        {
+            return "Confirm batch message with invalid number of entries";
+        }
+        case rai::ErrorCode::MESSAGE_CONFIRM_BATCH_SIGNATURE:
+        {
+            return "Confirm batch message with invalid signature";
+        }
+        case rai::ErrorCode::ELECTION_CONFIRM_BATCH_MISS:
+        {
+            return "Confirm batch entry doesn't match any election block";
+        }
+        case rai::ErrorCode::CALLBACK_QUEUE_FULL:
+        {
+            return "Callback queue is full, notification dropped";
+        }
+        case rai::ErrorCode::LEDGER_CALLBACK_PUT:
+        {
+            return "Failed to put callback outbox entry to ledger";
+        }
+        case rai::ErrorCode::LEDGER_CALLBACK_GET:
+        {
+            return "Failed to get callback outbox entry from ledger";
+        }
+        case rai::ErrorCode::LEDGER_CALLBACK_DEL:
+        {
+            return "Failed to delete callback outbox entry from ledger";
+        }
+        case rai::ErrorCode::WEBSOCKET_SLOW_CONSUMER:
+        {
+            return "Websocket client send queue is full, connection closed";
+        }
+        case rai::ErrorCode::WEBSOCKET_CONNECTIONS_FULL:
+        {
+            return "Websocket server connection limit reached";
+        }
+        case rai::ErrorCode::WEBSOCKET_ACCOUNTS_FULL:
+        {
+            return "Too many account subscriptions on this websocket connection";
+        }
+        case rai::ErrorCode::SIGNER_LOCK_MEMORY:
+        {
+            return "Failed to lock memory for the signing key, not cached";
+        }
         case rai::ErrorCode::JSON_GENERIC:
         {
             return "Failed to parse json";
@@ -724,6 +817,60 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "Failed to parse enable_delegator_list from config file";
         }
+        case rai::ErrorCode::JSON_CONFIG_ENABLE_PRUNING:
+        {
+            return "Failed to parse enable_pruning from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_PRUNING_DEPTH:
+        {
+            return "Failed to parse pruning_depth from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_STORAGE:
+        {
+            return "Failed to parse storage from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_STORAGE_VERSION:
+        {
+            return "Failed to parse storage version from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_STORAGE_PROFILE:
+        {
+            return "Failed to parse storage profile from config file, "
+                   "valid values: durable, fast_sync, bootstrap";
+        }
+        case rai::ErrorCode::JSON_CONFIG_STORAGE_MAP_SIZE:
+        {
+            return "Failed to parse storage map_size_gb from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_STORAGE_SYNC_INTERVAL:
+        {
+            return "Failed to parse storage sync_interval from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_STORAGE_OPTIONS:
+        {
+            return "Failed to parse storage write_map/no_read_ahead/"
+                   "bootstrap_on_sync from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_SIGNING_KEY_CACHE:
+        {
+            return "Failed to parse signing_key_cache from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_CALLBACK:
+        {
+            return "Failed to parse callback from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_WEBSOCKET:
+        {
+            return "Failed to parse websocket from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_RPC_WORKERS:
+        {
+            return "Failed to parse rpc workers from config file";
+        }
+        case rai::ErrorCode::JSON_CONFIG_RPC_QUEUE_SIZE:
+        {
+            return "Failed to parse rpc queue_size from config file";
+        }
         case rai::ErrorCode::RPC_GENERIC:
         {
             return "[RPC] Internal server error";
@@ -852,6 +999,46 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "[RPC] The event field is missing";
         }
+        case rai::ErrorCode::RPC_INVALID_FIELD_CURSOR:
+        {
+            return "[RPC] Invalid cursor field";
+        }
+        case rai::ErrorCode::RPC_MISS_FIELD_SEQUENCE:
+        {
+            return "[RPC] The sequence field is missing";
+        }
+        case rai::ErrorCode::RPC_INVALID_FIELD_SEQUENCE:
+        {
+            return "[RPC] Invalid sequence field";
+        }
+        case rai::ErrorCode::RPC_CALLBACK_OUTBOX_OFF:
+        {
+            return "[RPC] The callback outbox is not enabled";
+        }
+        case rai::ErrorCode::RPC_MISS_FIELD_ACTION:
+        {
+            return "[RPC] The action field is missing";
+        }
+        case rai::ErrorCode::RPC_MISS_FIELD_REQUESTS:
+        {
+            return "[RPC] The requests field is missing";
+        }
+        case rai::ErrorCode::RPC_INVALID_FIELD_REQUESTS:
+        {
+            return "[RPC] Invalid requests field";
+        }
+        case rai::ErrorCode::RPC_BATCH_ACTION:
+        {
+            return "[RPC] The action is not allowed in a batch";
+        }
+        case rai::ErrorCode::RPC_BUSY:
+        {
+            return "[RPC] Server busy, try again later";
+        }
+        case rai::ErrorCode::RPC_ACTION_TIMEOUT:
+        {
+            return "[RPC] The action exceeded its time limit";
+        }
         case rai::ErrorCode::BLOCK_PROCESS_GENERIC:
         {
             return "Error in block processor";
@@ -992,6 +1179,18 @@ std::string rai::ErrorString(rai::ErrorCode error_code)
         {
             return "Failed to put fork to ledger";
         }
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_CALLBACK_PUT:
+        {
+            return "Failed to put callback outbox entry to ledger";
+        }
+        case rai::ErrorCode::BLOCK_PROCESS_EVENTS_SKIPPED:
+        {
+            return "Block event consumer fell behind, events skipped";
+        }
+        case rai::ErrorCode::BLOCK_PROCESS_EVENTS_RESYNC:
+        {
+            return "Block event spill queue overflowed, consumer resynced";
+        }
         case rai::ErrorCode::BLOCK_PROCESS_ROLLBACK_REWARDED:
         {
             return "Rollback rewarded block";
@@ -126,6 +126,29 @@ enum class ErrorCode : int
     KEEPLIVE_ACK                         = 116,
     NODE_ACCOUNT_DUPLICATED              = 117,
     SUBSCRIPTION_EVENT                   = 118,
+    SNAPSHOT_FORMAT                      = 119,
+    SNAPSHOT_VERSION                     = 120,
+    SNAPSHOT_NETWORK                     = 121,
+    SNAPSHOT_CHECKSUM                    = 122,
+    SNAPSHOT_LEDGER_NOT_EMPTY            = 123,
+    SNAPSHOT_GENESIS                     = 124,
+    SNAPSHOT_ACCOUNT_HEAD                = 125,
+    LEDGER_PUT                           = 126,
+    LEDGER_PRUNE                         = 127,
+    CONFIG_STORAGE_VERSION               = 128,
+    MDB_ENV_SET_FLAGS                    = 129,
+    MDB_ENV_SYNC                         = 130,
+    MESSAGE_CONFIRM_BATCH_SIZE           = 131,
+    MESSAGE_CONFIRM_BATCH_SIGNATURE      = 132,
+    ELECTION_CONFIRM_BATCH_MISS          = 133,
+    CALLBACK_QUEUE_FULL                  = 134,
+    LEDGER_CALLBACK_PUT                  = 135,
+    LEDGER_CALLBACK_GET                  = 136,
+    LEDGER_CALLBACK_DEL                  = 137,
+    WEBSOCKET_SLOW_CONSUMER              = 138,
+    WEBSOCKET_CONNECTIONS_FULL           = 139,
+    WEBSOCKET_ACCOUNTS_FULL              = 140,
+    SIGNER_LOCK_MEMORY                   = 141,
 
     // json parsing errors: 200 ~ 299
     JSON_GENERIC                 = 200,
@@ -189,6 +212,19 @@ enum class ErrorCode : int
     JSON_CONFIG_RECEIVE_MINIMUM          = 287,
     JSON_CONFIG_ENABLE_RICH_LIST         = 288,
     JSON_CONFIG_ENABLE_DELEGATOR_LIST    = 289,
+    JSON_CONFIG_ENABLE_PRUNING           = 290,
+    JSON_CONFIG_PRUNING_DEPTH            = 291,
+    JSON_CONFIG_STORAGE                  = 292,
+    JSON_CONFIG_STORAGE_VERSION          = 293,
+    JSON_CONFIG_STORAGE_PROFILE          = 294,
+    JSON_CONFIG_STORAGE_MAP_SIZE         = 295,
+    JSON_CONFIG_STORAGE_SYNC_INTERVAL    = 296,
+    JSON_CONFIG_STORAGE_OPTIONS          = 297,
+    JSON_CONFIG_SIGNING_KEY_CACHE        = 298,
+    JSON_CONFIG_CALLBACK                 = 299,
+    JSON_CONFIG_WEBSOCKET                = 249,
+    JSON_CONFIG_RPC_WORKERS              = 248,
+    JSON_CONFIG_RPC_QUEUE_SIZE           = 247,
 
     // RPC errors: 300 ~ 399
     RPC_GENERIC                 = 300,
@@ -223,6 +259,16 @@ enum class ErrorCode : int
     RPC_INVALID_FIELD_AMOUNT    = 329,
     RPC_INVALID_FIELD_REP       = 330,
     RPC_MISS_FIELD_EVENT        = 331,
+    RPC_INVALID_FIELD_CURSOR    = 332,
+    RPC_MISS_FIELD_SEQUENCE     = 333,
+    RPC_INVALID_FIELD_SEQUENCE  = 334,
+    RPC_CALLBACK_OUTBOX_OFF     = 335,
+    RPC_MISS_FIELD_ACTION       = 336,
+    RPC_MISS_FIELD_REQUESTS     = 337,
+    RPC_INVALID_FIELD_REQUESTS  = 338,
+    RPC_BATCH_ACTION            = 339,
+    RPC_BUSY                    = 340,
+    RPC_ACTION_TIMEOUT          = 341,
 
     // Block process errors: 400 ~ 499
     BLOCK_PROCESS_GENERIC                     = 400,
@@ -261,6 +307,9 @@ enum class ErrorCode : int
     BLOCK_PROCESS_LEDGER_FORK_DEL             = 433,
     BLOCK_PROCESS_LEDGER_FORK_GET             = 434,
     BLOCK_PROCESS_LEDGER_FORK_PUT             = 435,
+    BLOCK_PROCESS_LEDGER_CALLBACK_PUT         = 436,
+    BLOCK_PROCESS_EVENTS_SKIPPED              = 437,
+    BLOCK_PROCESS_EVENTS_RESYNC               = 438,
 
     BLOCK_PROCESS_ROLLBACK_REWARDED          = 488,
     BLOCK_PROCESS_CONFIRM_BLOCK_MISS         = 489,
@@ -0,0 +1,715 @@
+#include <rai/common/json.hpp>
+
+#include <cstring>
+
+rai::JsonWriter::JsonWriter(std::string& out) : out_(out), after_key_(false)
+{
+    members_.reserve(8);
+}
+
+void rai::JsonWriter::StartObject()
+{
+    Separator_();
+    out_ += '{';
+    members_.push_back(false);
+}
+
+void rai::JsonWriter::EndObject()
+{
+    members_.pop_back();
+    out_ += '}';
+}
+
+void rai::JsonWriter::StartArray()
+{
+    Separator_();
+    out_ += '[';
+    members_.push_back(false);
+}
+
+void rai::JsonWriter::EndArray()
+{
+    members_.pop_back();
+    out_ += ']';
+}
+
+void rai::JsonWriter::Key(const char* key)
+{
+    Separator_();
+    out_ += '"';
+    Escape_(key, std::strlen(key));
+    out_ += "\":";
+    after_key_ = true;
+}
+
+void rai::JsonWriter::Key(const std::string& key)
+{
+    Separator_();
+    out_ += '"';
+    Escape_(key.data(), key.size());
+    out_ += "\":";
+    after_key_ = true;
+}
+
+void rai::JsonWriter::String(const char* str)
+{
+    Separator_();
+    out_ += '"';
+    Escape_(str, std::strlen(str));
+    out_ += '"';
+}
+
+void rai::JsonWriter::String(const std::string& str)
+{
+    Separator_();
+    out_ += '"';
+    Escape_(str.data(), str.size());
+    out_ += '"';
+}
+
+void rai::JsonWriter::Uint(uint64_t value)
+{
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    char* begin = end;
+    do
+    {
+        *--begin = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    Separator_();
+    out_ += '"';
+    out_.append(begin, end - begin);
+    out_ += '"';
+}
+
+void rai::JsonWriter::Raw(const std::string& json)
+{
+    Separator_();
+    out_ += json;
+}
+
+void rai::JsonWriter::Value(const rai::Ptree& ptree)
+{
+    if (ptree.empty())
+    {
+        String(ptree.data());
+    }
+    else if (ptree.count(std::string()) == ptree.size())
+    {
+        StartArray();
+        for (const auto& i : ptree)
+        {
+            Value(i.second);
+        }
+        EndArray();
+    }
+    else
+    {
+        StartObject();
+        for (const auto& i : ptree)
+        {
+            Key(i.first);
+            Value(i.second);
+        }
+        EndObject();
+    }
+}
+
+void rai::JsonWriter::Put(const char* key, const std::string& value)
+{
+    Key(key);
+    String(value);
+}
+
+void rai::JsonWriter::Put(const char* key, uint64_t value)
+{
+    Key(key);
+    Uint(value);
+}
+
+void rai::JsonWriter::Separator_()
+{
+    if (after_key_)
+    {
+        after_key_ = false;
+        return;
+    }
+
+    if (members_.empty())
+    {
+        return;
+    }
+
+    if (members_.back())
+    {
+        out_ += ',';
+    }
+    else
+    {
+        members_.back() = true;
+    }
+}
+
+void rai::JsonWriter::Escape_(const char* str, size_t size)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    const char* run = str;
+    const char* end = str + size;
+    for (const char* i = str; i != end; ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(*i);
+        if (c >= 0x20 && c != '"' && c != '\\' && c != '/')
+        {
+            continue;
+        }
+
+        out_.append(run, i - run);
+        run = i + 1;
+        switch (c)
+        {
+            case '"':
+            {
+                out_ += "\\\"";
+                break;
+            }
+            case '\\':
+            {
+                out_ += "\\\\";
+                break;
+            }
+            case '/':
+            {
+                out_ += "\\/";
+                break;
+            }
+            case '\b':
+            {
+                out_ += "\\b";
+                break;
+            }
+            case '\f':
+            {
+                out_ += "\\f";
+                break;
+            }
+            case '\n':
+            {
+                out_ += "\\n";
+                break;
+            }
+            case '\r':
+            {
+                out_ += "\\r";
+                break;
+            }
+            case '\t':
+            {
+                out_ += "\\t";
+                break;
+            }
+            default:
+            {
+                out_ += "\\u00";
+                out_ += hex[c >> 4];
+                out_ += hex[c & 0x0F];
+                break;
+            }
+        }
+    }
+    out_.append(run, end - run);
+}
+
+std::string rai::PtreeToJson(const rai::Ptree& ptree)
+{
+    if (ptree.empty())
+    {
+        // write_json only accepts a container at the root
+        return "{}";
+    }
+
+    std::string result;
+    result.reserve(256);
+    rai::JsonWriter writer(result);
+    writer.Value(ptree);
+    return result;
+}
+
+rai::JsonReader::JsonReader(size_t max_depth)
+    : max_depth_(max_depth),
+      depth_exceeded_(false),
+      pos_(nullptr),
+      end_(nullptr)
+{
+}
+
+bool rai::JsonReader::Parse(const std::string& json, rai::JsonHandler& handler)
+{
+    depth_exceeded_ = false;
+    pos_ = json.data();
+    end_ = json.data() + json.size();
+
+    bool error = ParseValue_(handler, 0);
+    IF_ERROR_RETURN(error, true);
+
+    SkipSpace_();
+    return pos_ != end_;
+}
+
+bool rai::JsonReader::DepthExceeded() const
+{
+    return depth_exceeded_;
+}
+
+bool rai::JsonReader::ParseValue_(rai::JsonHandler& handler, size_t depth)
+{
+    SkipSpace_();
+    if (pos_ == end_)
+    {
+        return true;
+    }
+
+    std::string value;
+    bool error = false;
+    switch (*pos_)
+    {
+        case '{':
+        {
+            return ParseObject_(handler, depth + 1);
+        }
+        case '[':
+        {
+            return ParseArray_(handler, depth + 1);
+        }
+        case '"':
+        {
+            error = ParseString_(value);
+            break;
+        }
+        case 't':
+        {
+            error = ParseLiteral_("true", value);
+            break;
+        }
+        case 'f':
+        {
+            error = ParseLiteral_("false", value);
+            break;
+        }
+        case 'n':
+        {
+            error = ParseLiteral_("null", value);
+            break;
+        }
+        default:
+        {
+            error = ParseNumber_(value);
+            break;
+        }
+    }
+    IF_ERROR_RETURN(error, true);
+
+    handler.Value(value);
+    return false;
+}
+
+bool rai::JsonReader::ParseObject_(rai::JsonHandler& handler, size_t depth)
+{
+    if (depth > max_depth_)
+    {
+        depth_exceeded_ = true;
+        return true;
+    }
+
+    ++pos_;
+    handler.StartObject();
+    SkipSpace_();
+    if (pos_ != end_ && *pos_ == '}')
+    {
+        ++pos_;
+        handler.EndObject();
+        return false;
+    }
+
+    std::string key;
+    while (true)
+    {
+        SkipSpace_();
+        if (pos_ == end_ || *pos_ != '"')
+        {
+            return true;
+        }
+        key.clear();
+        bool error = ParseString_(key);
+        IF_ERROR_RETURN(error, true);
+        handler.Key(key);
+
+        SkipSpace_();
+        if (pos_ == end_ || *pos_ != ':')
+        {
+            return true;
+        }
+        ++pos_;
+
+        error = ParseValue_(handler, depth);
+        IF_ERROR_RETURN(error, true);
+
+        SkipSpace_();
+        if (pos_ == end_)
+        {
+            return true;
+        }
+        if (*pos_ == ',')
+        {
+            ++pos_;
+            continue;
+        }
+        if (*pos_ == '}')
+        {
+            ++pos_;
+            handler.EndObject();
+            return false;
+        }
+        return true;
+    }
+}
+
+bool rai::JsonReader::ParseArray_(rai::JsonHandler& handler, size_t depth)
+{
+    if (depth > max_depth_)
+    {
+        depth_exceeded_ = true;
+        return true;
+    }
+
+    ++pos_;
+    handler.StartArray();
+    SkipSpace_();
+    if (pos_ != end_ && *pos_ == ']')
+    {
+        ++pos_;
+        handler.EndArray();
+        return false;
+    }
+
+    while (true)
+    {
+        bool error = ParseValue_(handler, depth);
+        IF_ERROR_RETURN(error, true);
+
+        SkipSpace_();
+        if (pos_ == end_)
+        {
+            return true;
+        }
+        if (*pos_ == ',')
+        {
+            ++pos_;
+            continue;
+        }
+        if (*pos_ == ']')
+        {
+            ++pos_;
+            handler.EndArray();
+            return false;
+        }
+        return true;
+    }
+}
+
+bool rai::JsonReader::ParseString_(std::string& str)
+{
+    ++pos_;
+    const char* run = pos_;
+    while (pos_ != end_)
+    {
+        unsigned char c = static_cast<unsigned char>(*pos_);
+        if (c == '"')
+        {
+            str.append(run, pos_ - run);
+            ++pos_;
+            return false;
+        }
+        if (c < 0x20)
+        {
+            return true;
+        }
+        if (c != '\\')
+        {
+            ++pos_;
+            continue;
+        }
+
+        str.append(run, pos_ - run);
+        ++pos_;
+        if (pos_ == end_)
+        {
+            return true;
+        }
+        switch (*pos_++)
+        {
+            case '"':
+            {
+                str += '"';
+                break;
+            }
+            case '\\':
+            {
+                str += '\\';
+                break;
+            }
+            case '/':
+            {
+                str += '/';
+                break;
+            }
+            case 'b':
+            {
+                str += '\b';
+                break;
+            }
+            case 'f':
+            {
+                str += '\f';
+                break;
+            }
+            case 'n':
+            {
+                str += '\n';
+                break;
+            }
+            case 'r':
+            {
+                str += '\r';
+                break;
+            }
+            case 't':
+            {
+                str += '\t';
+                break;
+            }
+            case 'u':
+            {
+                uint32_t code = 0;
+                bool error = ParseHex4_(code);
+                IF_ERROR_RETURN(error, true);
+                if (code >= 0xD800 && code <= 0xDBFF)
+                {
+                    if (end_ - pos_ < 2 || pos_[0] != '\\' || pos_[1] != 'u')
+                    {
+                        return true;
+                    }
+                    pos_ += 2;
+                    uint32_t low = 0;
+                    error = ParseHex4_(low);
+                    IF_ERROR_RETURN(error, true);
+                    if (low < 0xDC00 || low > 0xDFFF)
+                    {
+                        return true;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                else if (code >= 0xDC00 && code <= 0xDFFF)
+                {
+                    return true;
+                }
+
+                if (code < 0x80)
+                {
+                    str += static_cast<char>(code);
+                }
+                else if (code < 0x800)
+                {
+                    str += static_cast<char>(0xC0 | (code >> 6));
+                    str += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    str += static_cast<char>(0xE0 | (code >> 12));
+                    str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    str += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    str += static_cast<char>(0xF0 | (code >> 18));
+                    str += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    str += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    str += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+            {
+                return true;
+            }
+        }
+        run = pos_;
+    }
+    return true;
+}
+
+bool rai::JsonReader::ParseNumber_(std::string& str)
+{
+    const char* begin = pos_;
+    auto digits = [this]() {
+        const char* begin = pos_;
+        while (pos_ != end_ && *pos_ >= '0' && *pos_ <= '9')
+        {
+            ++pos_;
+        }
+        return pos_ != begin;
+    };
+
+    if (pos_ != end_ && *pos_ == '-')
+    {
+        ++pos_;
+    }
+    if (pos_ != end_ && *pos_ == '0')
+    {
+        ++pos_;
+    }
+    else if (!digits())
+    {
+        return true;
+    }
+
+    if (pos_ != end_ && *pos_ == '.')
+    {
+        ++pos_;
+        if (!digits())
+        {
+            return true;
+        }
+    }
+
+    if (pos_ != end_ && (*pos_ == 'e' || *pos_ == 'E'))
+    {
+        ++pos_;
+        if (pos_ != end_ && (*pos_ == '+' || *pos_ == '-'))
+        {
+            ++pos_;
+        }
+        if (!digits())
+        {
+            return true;
+        }
+    }
+
+    str.assign(begin, pos_ - begin);
+    return false;
+}
+
+bool rai::JsonReader::ParseLiteral_(const char* literal, std::string& str)
+{
+    size_t size = std::strlen(literal);
+    if (static_cast<size_t>(end_ - pos_) < size
+        || std::memcmp(pos_, literal, size) != 0)
+    {
+        return true;
+    }
+    pos_ += size;
+    str.assign(literal, size);
+    return false;
+}
+
+bool rai::JsonReader::ParseHex4_(uint32_t& code)
+{
+    if (end_ - pos_ < 4)
+    {
+        return true;
+    }
+
+    code = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        char c = *pos_++;
+        code <<= 4;
+        if (c >= '0' && c <= '9')
+        {
+            code |= c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            code |= c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            code |= c - 'A' + 10;
+        }
+        else
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void rai::JsonReader::SkipSpace_()
+{
+    while (pos_ != end_
+           && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\n' || *pos_ == '\r'))
+    {
+        ++pos_;
+    }
+}
+
+rai::JsonPtreeHandler::JsonPtreeHandler(rai::Ptree& root) : root_(root)
+{
+    stack_.reserve(8);
+}
+
+void rai::JsonPtreeHandler::StartObject()
+{
+    Start_(false);
+}
+
+void rai::JsonPtreeHandler::EndObject()
+{
+    stack_.pop_back();
+}
+
+void rai::JsonPtreeHandler::StartArray()
+{
+    Start_(true);
+}
+
+void rai::JsonPtreeHandler::EndArray()
+{
+    stack_.pop_back();
+}
+
+void rai::JsonPtreeHandler::Key(std::string& key)
+{
+    key_.swap(key);
+}
+
+void rai::JsonPtreeHandler::Value(std::string& value)
+{
+    if (stack_.empty())
+    {
+        root_.data().swap(value);
+        return;
+    }
+
+    rai::Ptree* parent = stack_.back().first;
+    bool array = stack_.back().second;
+    auto it = parent->push_back(
+        std::make_pair(array ? std::string() : key_, rai::Ptree()));
+    it->second.data().swap(value);
+}
+
+void rai::JsonPtreeHandler::Start_(bool array)
+{
+    if (stack_.empty())
+    {
+        stack_.emplace_back(&root_, array);
+        return;
+    }
+
+    rai::Ptree* parent = stack_.back().first;
+    bool parent_array = stack_.back().second;
+    auto it = parent->push_back(
+        std::make_pair(parent_array ? std::string() : key_, rai::Ptree()));
+    stack_.emplace_back(&it->second, array);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <rai/common/util.hpp>
+
+namespace rai
+{
+// Appends compact JSON to a caller owned buffer. Values are written the way
+// boost::property_tree::write_json writes them (numbers as strings, same
+// escapes), so output can replace a ptree round trip byte for byte.
+class JsonWriter
+{
+public:
+    JsonWriter(std::string&);
+    void StartObject();
+    void EndObject();
+    void StartArray();
+    void EndArray();
+    void Key(const char*);
+    void Key(const std::string&);
+    void String(const char*);
+    void String(const std::string&);
+    void Uint(uint64_t);
+    // an already serialized JSON value
+    void Raw(const std::string&);
+    void Value(const rai::Ptree&);
+    void Put(const char*, const std::string&);
+    void Put(const char*, uint64_t);
+
+private:
+    void Separator_();
+    void Escape_(const char*, size_t);
+
+    std::string& out_;
+    // one entry per open object/array, true once it has a member
+    std::vector<bool> members_;
+    bool after_key_;
+};
+
+// Compact equivalent of write_json(stream, ptree, false) without the newline
+std::string PtreeToJson(const rai::Ptree&);
+
+// Receives the events of a JsonReader. Numbers, true, false and null are
+// passed to Value() as their literal text, like read_json stores them.
+class JsonHandler
+{
+public:
+    virtual ~JsonHandler() = default;
+    virtual void StartObject() = 0;
+    virtual void EndObject() = 0;
+    virtual void StartArray() = 0;
+    virtual void EndArray() = 0;
+    virtual void Key(std::string&) = 0;
+    virtual void Value(std::string&) = 0;
+};
+
+// Single pass SAX style parser, nesting deeper than the limit is rejected
+// before anything below it is parsed
+class JsonReader
+{
+public:
+    JsonReader(size_t);
+    bool Parse(const std::string&, rai::JsonHandler&);
+    bool DepthExceeded() const;
+
+private:
+    bool ParseValue_(rai::JsonHandler&, size_t);
+    bool ParseObject_(rai::JsonHandler&, size_t);
+    bool ParseArray_(rai::JsonHandler&, size_t);
+    bool ParseString_(std::string&);
+    bool ParseNumber_(std::string&);
+    bool ParseLiteral_(const char*, std::string&);
+    bool ParseHex4_(uint32_t&);
+    void SkipSpace_();
+
+    size_t max_depth_;
+    bool depth_exceeded_;
+    const char* pos_;
+    const char* end_;
+};
+
+// Builds the same tree read_json would
+class JsonPtreeHandler : public JsonHandler
+{
+public:
+    JsonPtreeHandler(rai::Ptree&);
+    void StartObject() override;
+    void EndObject() override;
+    void StartArray() override;
+    void EndArray() override;
+    void Key(std::string&) override;
+    void Value(std::string&) override;
+
+private:
+    void Start_(bool);
+
+    rai::Ptree& root_;
+    // open containers, flagged true for arrays
+    std::vector<std::pair<rai::Ptree*, bool>> stack_;
+    std::string key_;
+};
+}  // namespace rai
@@ -6,6 +6,7 @@
 
 
 #include <blake2/blake2.h>
+#include <blake2/blake2b-dispatch.h>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <ed25519-donna/ed25519.h>
@@ -66,16 +67,126 @@ size_t MaxFracLen(rai::uint128_t scale)
         return 0;
     }
 }
+
+#if defined(__SIZEOF_INT128__)
+#define RAI_NATIVE_UINT128
+using native_uint128_t = unsigned __int128;
+#endif
+
+// uint128_union stores the number in big endian, split it into two native
+// 64-bit halves so that the arithmetic doesn't go through rai::uint128_t
+uint64_t High64(const rai::uint128_union& value)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        result = (result << 8) | value.bytes[i];
+    }
+    return result;
+}
+
+uint64_t Low64(const rai::uint128_union& value)
+{
+    uint64_t result = 0;
+    for (size_t i = 8; i < 16; ++i)
+    {
+        result = (result << 8) | value.bytes[i];
+    }
+    return result;
+}
+
+void Set128(rai::uint128_union& value, uint64_t high, uint64_t low)
+{
+    for (size_t i = 8; i-- > 0;)
+    {
+        value.bytes[i] = static_cast<uint8_t>(high);
+        high >>= 8;
+    }
+    for (size_t i = 16; i-- > 8;)
+    {
+        value.bytes[i] = static_cast<uint8_t>(low);
+        low >>= 8;
+    }
+}
+
+int Compare128(const rai::uint128_union& lhs, const rai::uint128_union& rhs)
+{
+    uint64_t lhs_high = High64(lhs);
+    uint64_t rhs_high = High64(rhs);
+    if (lhs_high != rhs_high)
+    {
+        return lhs_high < rhs_high ? -1 : 1;
+    }
+    uint64_t lhs_low = Low64(lhs);
+    uint64_t rhs_low = Low64(rhs);
+    if (lhs_low != rhs_low)
+    {
+        return lhs_low < rhs_low ? -1 : 1;
+    }
+    return 0;
+}
+
+// Returns true on carry out of bit 127
+bool Add128(const rai::uint128_union& lhs, const rai::uint128_union& rhs,
+            rai::uint128_union& result)
+{
+#ifdef RAI_NATIVE_UINT128
+    native_uint128_t a =
+        (static_cast<native_uint128_t>(High64(lhs)) << 64) | Low64(lhs);
+    native_uint128_t b =
+        (static_cast<native_uint128_t>(High64(rhs)) << 64) | Low64(rhs);
+    native_uint128_t sum = a + b;
+    Set128(result, static_cast<uint64_t>(sum >> 64),
+           static_cast<uint64_t>(sum));
+    return sum < a;
+#else
+    uint64_t lhs_high = High64(lhs);
+    uint64_t low = Low64(lhs) + Low64(rhs);
+    uint64_t carry = low < Low64(rhs) ? 1 : 0;
+    uint64_t high = lhs_high + High64(rhs);
+    bool overflow = high < lhs_high;
+    high += carry;
+    overflow = overflow || high < carry;
+    Set128(result, high, low);
+    return overflow;
+#endif
+}
+
+// Returns true on borrow, i.e. rhs > lhs
+bool Sub128(const rai::uint128_union& lhs, const rai::uint128_union& rhs,
+            rai::uint128_union& result)
+{
+#ifdef RAI_NATIVE_UINT128
+    native_uint128_t a =
+        (static_cast<native_uint128_t>(High64(lhs)) << 64) | Low64(lhs);
+    native_uint128_t b =
+        (static_cast<native_uint128_t>(High64(rhs)) << 64) | Low64(rhs);
+    native_uint128_t diff = a - b;
+    Set128(result, static_cast<uint64_t>(diff >> 64),
+           static_cast<uint64_t>(diff));
+    return b > a;
+#else
+    uint64_t lhs_low = Low64(lhs);
+    uint64_t lhs_high = High64(lhs);
+    uint64_t rhs_high = High64(rhs);
+    uint64_t low = lhs_low - Low64(rhs);
+    uint64_t borrow = low > lhs_low ? 1 : 0;
+    uint64_t high = lhs_high - rhs_high - borrow;
+    bool underflow = rhs_high > lhs_high || (rhs_high == lhs_high && borrow);
+    Set128(result, high, low);
+    return underflow;
+#endif
+}
 }  // namespace
 
 rai::uint128_union::uint128_union()
 {
-    *this = rai::uint128_t(0);
+    qwords.fill(0);
 }
 
 rai::uint128_union::uint128_union(uint64_t value)
 {
-    *this = rai::uint128_t(value);
+    Set128(*this, 0, value);
 }
 
 rai::uint128_union::uint128_union(const rai::uint128_t& value)
@@ -101,61 +212,122 @@ bool rai::uint128_union::operator!=(const rai::uint128_union& other) const
 
 bool rai::uint128_union::operator<(const rai::uint128_union& other) const
 {
-    return Number() < other.Number();
+    return Compare128(*this, other) < 0;
 }
 
 bool rai::uint128_union::operator>(const rai::uint128_union& other) const
 {
-    return Number() > other.Number();
+    return Compare128(*this, other) > 0;
 }
 
 bool rai::uint128_union::operator<=(const rai::uint128_union& other) const
 {
-    return Number() <= other.Number();
+    return Compare128(*this, other) <= 0;
 }
 
 bool rai::uint128_union::operator>=(const rai::uint128_union& other) const
 {
-    return Number() >= other.Number();
+    return Compare128(*this, other) >= 0;
 }
 
 rai::uint128_union rai::uint128_union::operator+(
     const rai::uint128_union& other) const
 {
-    return rai::uint128_union(Number() + other.Number());
+    rai::uint128_union result;
+    Add128(*this, other, result);
+    return result;
 }
 
 rai::uint128_union rai::uint128_union::operator-(
     const rai::uint128_union& other) const
 {
-    return rai::uint128_union(Number() - other.Number());
+    rai::uint128_union result;
+    Sub128(*this, other, result);
+    return result;
 }
 
 rai::uint128_union& rai::uint128_union::operator+=(
     const rai::uint128_union& other)
 {
-    *this = *this + other;
+    Add128(*this, other, *this);
     return *this;
 }
 
 rai::uint128_union& rai::uint128_union::operator-=(
     const rai::uint128_union& other)
 {
-    *this = *this - other;
+    Sub128(*this, other, *this);
     return *this;
 }
 
-rai::uint128_t rai::uint128_union::Number() const
+bool rai::uint128_union::CheckedAdd(const rai::uint128_union& other)
 {
-    rai::uint128_t result;
-    int shift = 0;
+    rai::uint128_union result;
+    bool overflow = Add128(*this, other, result);
+    IF_ERROR_RETURN(overflow, true);
+    *this = result;
+    return false;
+}
 
-    for (auto i(bytes.begin()), n(bytes.end()); i != n; ++i)
+bool rai::uint128_union::CheckedSub(const rai::uint128_union& other)
+{
+    rai::uint128_union result;
+    bool underflow = Sub128(*this, other, result);
+    IF_ERROR_RETURN(underflow, true);
+    *this = result;
+    return false;
+}
+
+bool rai::uint128_union::MulDiv(uint64_t numerator, uint64_t denominator,
+                                rai::uint128_union& result) const
+{
+    if (denominator == 0)
     {
-        result <<= shift;
-        result |= *i;
-        shift = 8;
+        return true;
+    }
+
+#ifdef RAI_NATIVE_UINT128
+    // 128 x 64 bit product in three 64-bit limbs, then long division by the
+    // 64-bit denominator
+    native_uint128_t product_low =
+        static_cast<native_uint128_t>(Low64(*this)) * numerator;
+    native_uint128_t product_high =
+        static_cast<native_uint128_t>(High64(*this)) * numerator;
+    native_uint128_t middle = (product_low >> 64)
+                              + static_cast<uint64_t>(product_high);
+    uint64_t limb0 = static_cast<uint64_t>(product_low);
+    uint64_t limb1 = static_cast<uint64_t>(middle);
+    uint64_t limb2 =
+        static_cast<uint64_t>((product_high >> 64) + (middle >> 64));
+
+    if (limb2 >= denominator)
+    {
+        return true;
+    }
+    native_uint128_t remainder = limb2;
+    native_uint128_t current = (remainder << 64) | limb1;
+    uint64_t quotient_high = static_cast<uint64_t>(current / denominator);
+    remainder = current % denominator;
+    current = (remainder << 64) | limb0;
+    uint64_t quotient_low = static_cast<uint64_t>(current / denominator);
+    Set128(result, quotient_high, quotient_low);
+#else
+    rai::uint256_t product(Number());
+    product = product * numerator / denominator;
+    if (product > std::numeric_limits<rai::uint128_t>::max())
+    {
+        return true;
     }
+    result = rai::uint128_union(static_cast<rai::uint128_t>(product));
+#endif
+    return false;
+}
+
+rai::uint128_t rai::uint128_union::Number() const
+{
+    rai::uint128_t result(High64(*this));
+    result <<= 64;
+    result |= Low64(*this);
     return result;
 }
 
@@ -861,6 +1033,131 @@ rai::PublicKey rai::GeneratePublicKey(const rai::PrivateKey& private_key)
     return result;
 }
 
+size_t constexpr rai::SignatureCache::SHARDS;
+size_t constexpr rai::SignatureCache::SLOTS_PER_SHARD;
+
+rai::SignatureCache::SignatureCache()
+    : shards_(new Shard[rai::SignatureCache::SHARDS])
+{
+    random_pool.GenerateBlock(salt_.bytes.data(), salt_.bytes.size());
+    for (size_t i = 0; i < SHARDS; ++i)
+    {
+        Shard& shard = shards_[i];
+        shard.hits_ = 0;
+        shard.misses_ = 0;
+        for (auto& slot : shard.slots_)
+        {
+            for (auto& word : slot.words_)
+            {
+                word = 0;
+            }
+        }
+    }
+}
+
+bool rai::SignatureCache::Validate(const rai::PublicKey& public_key,
+                                   const rai::uint256_union& message,
+                                   const rai::Signature& signature)
+{
+    Digest digest = Digest_(public_key, message, signature);
+    Shard* shard = nullptr;
+    Slot& slot = Slot_(digest, shard);
+
+    bool hit = true;
+    for (size_t i = 0; i < digest.size(); ++i)
+    {
+        if (slot.words_[i].load(std::memory_order_relaxed) != digest[i])
+        {
+            hit = false;
+            break;
+        }
+    }
+    if (hit)
+    {
+        shard->hits_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    shard->misses_.fetch_add(1, std::memory_order_relaxed);
+    bool error = rai::ValidateMessage(public_key, message, signature);
+    if (!error)
+    {
+        for (size_t i = 0; i < digest.size(); ++i)
+        {
+            slot.words_[i].store(digest[i], std::memory_order_relaxed);
+        }
+    }
+    return error;
+}
+
+uint64_t rai::SignatureCache::Hits() const
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < SHARDS; ++i)
+    {
+        result += shards_[i].hits_.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+uint64_t rai::SignatureCache::Misses() const
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < SHARDS; ++i)
+    {
+        result += shards_[i].misses_.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+rai::SignatureCache& rai::SignatureCache::Instance()
+{
+    static rai::SignatureCache instance;
+    return instance;
+}
+
+rai::SignatureCache::Digest rai::SignatureCache::Digest_(
+    const rai::PublicKey& public_key, const rai::uint256_union& message,
+    const rai::Signature& signature) const
+{
+    Digest result;
+    blake2b_state state;
+    blake2b_init_key(&state, sizeof(result), salt_.bytes.data(),
+                     salt_.bytes.size());
+    blake2b_update(&state, public_key.bytes.data(), public_key.bytes.size());
+    blake2b_update(&state, message.bytes.data(), message.bytes.size());
+    blake2b_update(&state, signature.bytes.data(), signature.bytes.size());
+    blake2b_final(&state, result.data(), sizeof(result));
+    // an all-zero digest would match an empty slot
+    result[0] |= 1;
+    return result;
+}
+
+rai::SignatureCache::Slot& rai::SignatureCache::Slot_(const Digest& digest,
+                                                      Shard*& shard) const
+{
+    shard = &shards_[digest[0] % SHARDS];
+    return shard->slots_[digest[1] % SLOTS_PER_SHARD];
+}
+
+bool rai::ValidateMessageCached(const rai::PublicKey& public_key,
+                                const rai::uint256_union& message,
+                                const rai::uint512_union& signature)
+{
+    return rai::SignatureCache::Instance().Validate(public_key, message,
+                                                    signature);
+}
+
+std::string rai::Blake2bKernel()
+{
+    return blake2b_kernel();
+}
+
+std::string rai::Ed25519Kernel()
+{
+    return ed25519_kernel();
+}
+
 uint64_t rai::Random(uint64_t min, uint64_t max)
 {
     if (min > max)
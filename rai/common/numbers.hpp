@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <memory>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <cryptopp/osrng.h>
 
@@ -32,6 +34,12 @@ public:
     rai::uint128_union operator-(const rai::uint128_union&) const;
     rai::uint128_union& operator+=(const rai::uint128_union&);
     rai::uint128_union& operator-=(const rai::uint128_union&);
+    // Return true on overflow/underflow and leave the value unchanged
+    bool CheckedAdd(const rai::uint128_union&);
+    bool CheckedSub(const rai::uint128_union&);
+    // result = value * numerator / denominator, with a wide intermediate
+    // product, return true if the result doesn't fit in 128 bits
+    bool MulDiv(uint64_t, uint64_t, rai::uint128_union&) const;
     rai::uint128_t Number() const;
     void Clear();
     bool IsZero() const;
@@ -155,6 +163,53 @@ bool ValidateMessage(const rai::PublicKey&, const rai::uint256_union&,
 
 rai::PublicKey GeneratePublicKey(const rai::PrivateKey&);
 uint64_t Random(uint64_t, uint64_t);
+
+// Fixed-size cache of recently verified (public key, message, signature)
+// triples. Slots hold salted blake2b digests in atomics, so lookups and
+// inserts never lock; an evicted or torn slot only costs a re-verification.
+class SignatureCache
+{
+public:
+    SignatureCache();
+    bool Validate(const rai::PublicKey&, const rai::uint256_union&,
+                  const rai::Signature&);
+    uint64_t Hits() const;
+    uint64_t Misses() const;
+
+    static rai::SignatureCache& Instance();
+
+    static size_t constexpr SHARDS = 16;
+    static size_t constexpr SLOTS_PER_SHARD = 4096;
+
+private:
+    using Digest = std::array<uint64_t, 4>;
+    struct Slot
+    {
+        std::array<std::atomic<uint64_t>, 4> words_;
+    };
+    struct Shard
+    {
+        std::atomic<uint64_t> hits_;
+        std::atomic<uint64_t> misses_;
+        std::array<Slot, SLOTS_PER_SHARD> slots_;
+    };
+
+    Digest Digest_(const rai::PublicKey&, const rai::uint256_union&,
+                   const rai::Signature&) const;
+    Slot& Slot_(const Digest&, Shard*&) const;
+
+    rai::uint256_union salt_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+// Same as ValidateMessage, but consults rai::SignatureCache first and records
+// valid signatures in it. Use for signatures that are likely seen again.
+bool ValidateMessageCached(const rai::PublicKey&, const rai::uint256_union&,
+                           const rai::uint512_union&);
+
+// Names of the crypto kernels selected for this CPU
+std::string Blake2bKernel();
+std::string Ed25519Kernel();
 }  // namespace rai
 
 namespace boost
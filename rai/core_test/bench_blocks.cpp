@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <rai/common/blocks.hpp>
+#include <rai/core_test/bench_util.hpp>
+
+static void BM_TxBlockSerialize(benchmark::State& state)
+{
+    auto block = BenchTxBlock(1);
+    std::vector<uint8_t> bytes;
+    bytes.reserve(block->Size());
+    for (auto _ : state)
+    {
+        bytes.clear();
+        {
+            rai::VectorStream stream(bytes);
+            block->Serialize(stream);
+        }
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_TxBlockSerialize);
+
+static void BM_TxBlockDeserialize(benchmark::State& state)
+{
+    std::vector<uint8_t> bytes = BenchBytes(*BenchTxBlock(1));
+    for (auto _ : state)
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::BufferStream stream(bytes.data(), bytes.size());
+        auto block = rai::DeserializeBlockUnverify(error_code, stream);
+        benchmark::DoNotOptimize(block);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_TxBlockDeserialize);
+
+static void BM_TxBlockDeserializeVerify(benchmark::State& state)
+{
+    std::vector<uint8_t> bytes = BenchBytes(*BenchTxBlock(1));
+    for (auto _ : state)
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::BufferStream stream(bytes.data(), bytes.size());
+        auto block = rai::DeserializeBlock(error_code, stream);
+        benchmark::DoNotOptimize(block);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TxBlockDeserializeVerify);
+
+static void BM_TxBlockHash(benchmark::State& state)
+{
+    auto block = BenchTxBlock(1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(block->Hash());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TxBlockHash);
+
+static void BM_TxBlockSerializeJson(benchmark::State& state)
+{
+    auto block = BenchTxBlock(1);
+    for (auto _ : state)
+    {
+        rai::Ptree ptree;
+        block->SerializeJson(ptree);
+        benchmark::DoNotOptimize(ptree);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TxBlockSerializeJson);
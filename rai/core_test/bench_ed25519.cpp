@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+#include <blake2/blake2.h>
+#include <ed25519-donna/ed25519.h>
+#include <rai/common/numbers.hpp>
+#include <rai/core_test/bench_util.hpp>
+#include <rai/secure/common.hpp>
+
+#include <vector>
+
+namespace
+{
+class BenchMessages
+{
+public:
+    BenchMessages()
+    {
+        const BenchKey& key = BenchSigner();
+        for (uint64_t i = 0; i < 64; ++i)
+        {
+            rai::uint256_union message(i * 0x9E3779B97F4A7C15);
+            messages_.push_back(message);
+            signatures_.push_back(
+                rai::SignMessage(key.private_key_, key.public_key_, message));
+        }
+    }
+
+    std::vector<rai::uint256_union> messages_;
+    std::vector<rai::Signature> signatures_;
+};
+}  // namespace
+
+static void BM_Blake2b512(benchmark::State& state)
+{
+    std::vector<uint8_t> data(state.range(0), 0x5A);
+    uint8_t out[64];
+    for (auto _ : state)
+    {
+        blake2b(out, sizeof(out), data.data(), data.size(), nullptr, 0);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Blake2b512)->Arg(32)->Arg(128)->Arg(1024);
+
+static void BM_Ed25519Sign(benchmark::State& state)
+{
+    const BenchKey& key = BenchSigner();
+    BenchMessages bench;
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(rai::SignMessage(
+            key.private_key_, key.public_key_,
+            bench.messages_[index++ % bench.messages_.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Ed25519Sign);
+
+static void BM_Ed25519SignBatch(benchmark::State& state)
+{
+    const BenchKey& key = BenchSigner();
+    rai::Fan fan(key.private_key_.data_, rai::Fan::FAN_OUT);
+    rai::Signer signer(fan, 60);
+    BenchMessages bench;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(signer.Sign(bench.messages_));
+    }
+    state.SetItemsProcessed(state.iterations() * bench.messages_.size());
+}
+BENCHMARK(BM_Ed25519SignBatch);
+
+static void BM_Ed25519Verify(benchmark::State& state)
+{
+    const BenchKey& key = BenchSigner();
+    BenchMessages bench;
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        size_t i = index++ % bench.messages_.size();
+        benchmark::DoNotOptimize(rai::ValidateMessage(
+            key.public_key_, bench.messages_[i], bench.signatures_[i]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Ed25519Verify);
+
+static void BM_Ed25519VerifyBatch(benchmark::State& state)
+{
+    const BenchKey& key = BenchSigner();
+    BenchMessages bench;
+    size_t count = bench.messages_.size();
+    std::vector<const uint8_t*> messages;
+    std::vector<size_t> lengths;
+    std::vector<const uint8_t*> public_keys;
+    std::vector<const uint8_t*> signatures;
+    for (size_t i = 0; i < count; ++i)
+    {
+        messages.push_back(bench.messages_[i].bytes.data());
+        lengths.push_back(bench.messages_[i].bytes.size());
+        public_keys.push_back(key.public_key_.bytes.data());
+        signatures.push_back(bench.signatures_[i].bytes.data());
+    }
+    std::vector<int> valid(count);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ed25519_sign_open_batch(
+            messages.data(), lengths.data(), public_keys.data(),
+            signatures.data(), count, valid.data()));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Ed25519VerifyBatch);
+
+static void BM_Ed25519VerifyCached(benchmark::State& state)
+{
+    const BenchKey& key = BenchSigner();
+    BenchMessages bench;
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        size_t i = index++ % bench.messages_.size();
+        benchmark::DoNotOptimize(rai::ValidateMessageCached(
+            key.public_key_, bench.messages_[i], bench.signatures_[i]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Ed25519VerifyCached);
@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <boost/property_tree/json_parser.hpp>
+#include <rai/common/blocks.hpp>
+#include <rai/common/json.hpp>
+#include <rai/core_test/bench_util.hpp>
+
+namespace
+{
+// Shaped like a block_confirm notification / block RPC response
+rai::Ptree BenchNotify()
+{
+    rai::Ptree ptree;
+    ptree.put("notify", "block_confirm");
+    ptree.put("account", BenchTxBlock(1)->Account().StringAccount());
+    rai::Ptree block;
+    BenchTxBlock(1)->SerializeJson(block);
+    ptree.put_child("block", block);
+    return ptree;
+}
+
+std::string BenchRequest()
+{
+    return R"%%%({"action":"account_info","account":"rai_1e5aqegc1jb7qe964u4adzmcezyo6o146zb8hm6dft8tkp79za3sxwjym5rx","request_id":"12345","client_id":"bench","count":"100"})%%%";
+}
+}  // namespace
+
+static void BM_JsonWritePtree(benchmark::State& state)
+{
+    rai::Ptree ptree = BenchNotify();
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        std::stringstream stream;
+        boost::property_tree::write_json(stream, ptree, false);
+        std::string json = stream.str();
+        bytes = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_JsonWritePtree);
+
+static void BM_JsonWriteWriter(benchmark::State& state)
+{
+    rai::Ptree ptree = BenchNotify();
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        std::string json = rai::PtreeToJson(ptree);
+        bytes = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_JsonWriteWriter);
+
+static void BM_JsonBlockPtree(benchmark::State& state)
+{
+    auto block = BenchTxBlock(1);
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        rai::Ptree ptree;
+        block->SerializeJson(ptree);
+        std::stringstream stream;
+        boost::property_tree::write_json(stream, ptree, false);
+        std::string json = stream.str();
+        bytes = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_JsonBlockPtree);
+
+static void BM_JsonBlockWriter(benchmark::State& state)
+{
+    auto block = BenchTxBlock(1);
+    std::string json;
+    json.reserve(1024);
+    for (auto _ : state)
+    {
+        json.clear();
+        rai::JsonWriter writer(json);
+        block->SerializeJson(writer);
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JsonBlockWriter);
+
+static void BM_JsonReadPtree(benchmark::State& state)
+{
+    std::string json = BenchRequest();
+    for (auto _ : state)
+    {
+        rai::Ptree ptree;
+        std::stringstream stream(json);
+        boost::property_tree::read_json(stream, ptree);
+        benchmark::DoNotOptimize(ptree);
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JsonReadPtree);
+
+static void BM_JsonReadReader(benchmark::State& state)
+{
+    std::string json = BenchRequest();
+    rai::JsonReader reader(20);
+    for (auto _ : state)
+    {
+        rai::Ptree ptree;
+        rai::JsonPtreeHandler handler(ptree);
+        bool error = reader.Parse(json, handler);
+        benchmark::DoNotOptimize(error);
+        benchmark::DoNotOptimize(ptree);
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JsonReadReader);
@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <rai/core_test/bench_util.hpp>
+#include <rai/secure/ledger.hpp>
+
+#include <stdexcept>
+
+namespace
+{
+// A throwaway store in the temp directory, shared by the ledger benchmarks
+class BenchLedger
+{
+public:
+    BenchLedger()
+        : path_(boost::filesystem::temp_directory_path()
+                / boost::filesystem::unique_path()),
+          error_code_(rai::ErrorCode::SUCCESS),
+          store_(error_code_, Create_(path_) / "data.ldb"),
+          ledger_(error_code_, store_, false)
+    {
+        if (error_code_ != rai::ErrorCode::SUCCESS)
+        {
+            throw std::runtime_error("Failed to open benchmark ledger");
+        }
+
+        for (uint64_t i = 0; i < BLOCKS; ++i)
+        {
+            blocks_.push_back(BenchTxBlock(i));
+            hashes_.push_back(blocks_.back()->Hash());
+        }
+    }
+
+    ~BenchLedger()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(path_, ec);
+    }
+
+    static size_t constexpr BLOCKS = 4096;
+
+    boost::filesystem::path path_;
+    rai::ErrorCode error_code_;
+    rai::Store store_;
+    rai::Ledger ledger_;
+    std::vector<std::shared_ptr<rai::TxBlock>> blocks_;
+    std::vector<rai::BlockHash> hashes_;
+
+private:
+    static const boost::filesystem::path& Create_(
+        const boost::filesystem::path& path)
+    {
+        boost::filesystem::create_directories(path);
+        return path;
+    }
+};
+
+size_t constexpr BenchLedger::BLOCKS;
+
+BenchLedger& Ledger()
+{
+    static BenchLedger ledger;
+    return ledger;
+}
+}  // namespace
+
+static void BM_LedgerBlockPut(benchmark::State& state)
+{
+    BenchLedger& bench = Ledger();
+    size_t batch = state.range(0);
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, bench.ledger_, true);
+        for (size_t i = 0; i < batch; ++i, ++index)
+        {
+            size_t n = index % BenchLedger::BLOCKS;
+            bench.ledger_.BlockPut(transaction, bench.hashes_[n],
+                                   *bench.blocks_[n]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_LedgerBlockPut)->Arg(1)->Arg(64);
+
+static void BM_LedgerBlockGet(benchmark::State& state)
+{
+    BenchLedger& bench = Ledger();
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, bench.ledger_, true);
+        for (size_t i = 0; i < BenchLedger::BLOCKS; ++i)
+        {
+            bench.ledger_.BlockPut(transaction, bench.hashes_[i],
+                                   *bench.blocks_[i]);
+        }
+    }
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, bench.ledger_, false);
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        std::shared_ptr<rai::Block> block;
+        bool error = bench.ledger_.BlockGet(
+            transaction, bench.hashes_[index++ % BenchLedger::BLOCKS], block);
+        benchmark::DoNotOptimize(error);
+        benchmark::DoNotOptimize(block);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LedgerBlockGet);
+
+static void BM_LedgerAccountInfoPutGet(benchmark::State& state)
+{
+    BenchLedger& bench = Ledger();
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, bench.ledger_, true);
+        size_t n = index++ % BenchLedger::BLOCKS;
+        rai::Account account(n);
+        rai::AccountInfo info(rai::BlockType::TX_BLOCK, bench.hashes_[n]);
+        bench.ledger_.AccountInfoPut(transaction, account, info);
+        rai::AccountInfo info_get;
+        bool error =
+            bench.ledger_.AccountInfoGet(transaction, account, info_get);
+        benchmark::DoNotOptimize(error);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LedgerAccountInfoPutGet);
@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+#include <rai/core_test/bench_util.hpp>
+#include <rai/node/message.hpp>
+
+namespace
+{
+class NullVisitor : public rai::MessageVisitor
+{
+public:
+    void Handshake(const rai::HandshakeMessage&) override
+    {
+    }
+    void Keeplive(const rai::KeepliveMessage&) override
+    {
+    }
+    void Publish(const rai::PublishMessage&) override
+    {
+    }
+    void Relay(rai::RelayMessage&) override
+    {
+    }
+    void Confirm(const rai::ConfirmMessage&) override
+    {
+    }
+    void Query(const rai::QueryMessage&) override
+    {
+    }
+    void Fork(const rai::ForkMessage&) override
+    {
+    }
+    void Conflict(const rai::ConflictMessage&) override
+    {
+    }
+    void ConfirmBatch(const rai::ConfirmBatchMessage&) override
+    {
+    }
+};
+
+std::vector<uint8_t> HandshakeBytes()
+{
+    rai::HandshakeMessage message(BenchSigner().public_key_,
+                                  rai::uint256_union(12345));
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    return bytes;
+}
+
+std::vector<uint8_t> KeepliveBytes()
+{
+    rai::KeepliveMessage message(rai::BlockHash(1), BenchSigner().public_key_);
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    return bytes;
+}
+
+std::vector<uint8_t> PublishBytes()
+{
+    rai::PublishMessage message(BenchTxBlock(1));
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    return bytes;
+}
+
+std::vector<uint8_t> ConfirmBytes()
+{
+    const BenchKey& key = BenchSigner();
+    rai::ConfirmMessage message(1541128318, key.public_key_, BenchTxBlock(1));
+    message.SetSignature(
+        rai::SignMessage(key.private_key_, key.public_key_, message.Hash()));
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    return bytes;
+}
+
+std::vector<uint8_t> ConfirmBatchBytes()
+{
+    const BenchKey& key = BenchSigner();
+    std::vector<rai::ConfirmEntry> entries;
+    for (uint64_t i = 0; i < rai::ConfirmBatchMessage::MAX_ENTRIES; ++i)
+    {
+        entries.emplace_back(rai::Account(i), i, 1541128318 + i,
+                             rai::BlockHash(i));
+    }
+    rai::ConfirmBatchMessage message(key.public_key_, entries);
+    message.SetSignature(
+        rai::SignMessage(key.private_key_, key.public_key_, message.Hash()));
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    return bytes;
+}
+
+std::vector<uint8_t> QueryBytes()
+{
+    rai::QueryMessage message(1, rai::QueryBy::HASH, BenchSigner().public_key_,
+                              1, rai::BlockHash(1));
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    return bytes;
+}
+
+std::vector<uint8_t> ForkBytes()
+{
+    rai::ForkMessage message(BenchTxBlock(1, 1541128318),
+                             BenchTxBlock(1, 1541128319));
+    std::vector<uint8_t> bytes;
+    message.ToBytes(bytes);
+    return bytes;
+}
+
+// Signed messages hit rai::SignatureCache after the first iteration, which
+// matches the relay path where the same vote arrives from many peers
+void ParseMessage(benchmark::State& state, std::vector<uint8_t> (*make)())
+{
+    std::vector<uint8_t> bytes = make();
+    NullVisitor visitor;
+    rai::MessageParser parser(visitor);
+    for (auto _ : state)
+    {
+        rai::BufferStream stream(bytes.data(), bytes.size());
+        rai::ErrorCode error_code = parser.Parse(stream);
+        if (error_code != rai::ErrorCode::SUCCESS)
+        {
+            state.SkipWithError(rai::ErrorString(error_code).c_str());
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(ParseMessage, handshake, HandshakeBytes);
+BENCHMARK_CAPTURE(ParseMessage, keeplive, KeepliveBytes);
+BENCHMARK_CAPTURE(ParseMessage, publish, PublishBytes);
+BENCHMARK_CAPTURE(ParseMessage, confirm, ConfirmBytes);
+BENCHMARK_CAPTURE(ParseMessage, confirm_batch, ConfirmBatchBytes);
+BENCHMARK_CAPTURE(ParseMessage, query, QueryBytes);
+BENCHMARK_CAPTURE(ParseMessage, fork, ForkBytes);
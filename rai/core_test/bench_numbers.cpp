@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+#include <rai/common/numbers.hpp>
+
+#include <vector>
+
+namespace
+{
+std::vector<rai::Amount> BenchAmounts(size_t count)
+{
+    std::vector<rai::Amount> result;
+    result.reserve(count);
+    rai::uint128_t value("0x34F0A37AAD20F4A260F0A5B3CB3D7FB5");
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.push_back(rai::Amount((value >> (i % 64)) + i));
+    }
+    return result;
+}
+}  // namespace
+
+static void BM_AmountAdd(benchmark::State& state)
+{
+    auto amounts = BenchAmounts(1024);
+    for (auto _ : state)
+    {
+        rai::Amount sum(0);
+        for (const auto& i : amounts)
+        {
+            sum += i;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * amounts.size());
+}
+BENCHMARK(BM_AmountAdd);
+
+static void BM_AmountAddNumber(benchmark::State& state)
+{
+    auto amounts = BenchAmounts(1024);
+    for (auto _ : state)
+    {
+        rai::uint128_t sum(0);
+        for (const auto& i : amounts)
+        {
+            sum += i.Number();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * amounts.size());
+}
+BENCHMARK(BM_AmountAddNumber);
+
+static void BM_AmountCheckedSub(benchmark::State& state)
+{
+    auto amounts = BenchAmounts(1024);
+    for (auto _ : state)
+    {
+        rai::Amount remain(rai::uint128_t(-1));
+        for (const auto& i : amounts)
+        {
+            benchmark::DoNotOptimize(remain.CheckedSub(i));
+        }
+        benchmark::DoNotOptimize(remain);
+    }
+    state.SetItemsProcessed(state.iterations() * amounts.size());
+}
+BENCHMARK(BM_AmountCheckedSub);
+
+static void BM_AmountCompare(benchmark::State& state)
+{
+    auto amounts = BenchAmounts(1024);
+    for (auto _ : state)
+    {
+        size_t count = 0;
+        for (size_t i = 1; i < amounts.size(); ++i)
+        {
+            count += amounts[i - 1] < amounts[i] ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * (amounts.size() - 1));
+}
+BENCHMARK(BM_AmountCompare);
+
+static void BM_AmountMulDiv(benchmark::State& state)
+{
+    auto amounts = BenchAmounts(1024);
+    for (auto _ : state)
+    {
+        rai::Amount result;
+        uint64_t factor = 0;
+        for (const auto& i : amounts)
+        {
+            i.MulDiv(factor, 100, result);
+            benchmark::DoNotOptimize(result);
+            factor = factor == 100 ? 0 : factor + 1;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * amounts.size());
+}
+BENCHMARK(BM_AmountMulDiv);
+
+static void BM_AmountMulDivUint256(benchmark::State& state)
+{
+    auto amounts = BenchAmounts(1024);
+    for (auto _ : state)
+    {
+        uint64_t factor = 0;
+        for (const auto& i : amounts)
+        {
+            rai::uint256_t weight(i.Number());
+            weight = weight * factor / 100;
+            rai::Amount result(static_cast<rai::uint128_t>(weight));
+            benchmark::DoNotOptimize(result);
+            factor = factor == 100 ? 0 : factor + 1;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * amounts.size());
+}
+BENCHMARK(BM_AmountMulDivUint256);
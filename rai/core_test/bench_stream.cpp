@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <rai/common/numbers.hpp>
+#include <rai/common/util.hpp>
+
+#include <vector>
+
+namespace
+{
+enum class BenchEnum : uint8_t
+{
+    FIRST  = 1,
+    SECOND = 2,
+};
+
+// One record roughly shaped like a block header
+struct BenchRecord
+{
+    BenchEnum type_;
+    uint16_t credit_;
+    uint32_t counter_;
+    uint64_t timestamp_;
+    rai::Account account_;
+    rai::Amount balance_;
+};
+
+void WriteRecord(rai::Stream& stream, const BenchRecord& record)
+{
+    rai::Write(stream, record.type_);
+    rai::Write(stream, record.credit_);
+    rai::Write(stream, record.counter_);
+    rai::Write(stream, record.timestamp_);
+    rai::Write(stream, record.account_.bytes);
+    rai::Write(stream, record.balance_.bytes);
+}
+
+bool ReadRecord(rai::Stream& stream, BenchRecord& record)
+{
+    bool error = rai::Read(stream, record.type_);
+    error |= rai::Read(stream, record.credit_);
+    error |= rai::Read(stream, record.counter_);
+    error |= rai::Read(stream, record.timestamp_);
+    error |= rai::Read(stream, record.account_.bytes);
+    error |= rai::Read(stream, record.balance_.bytes);
+    return error;
+}
+
+BenchRecord MakeRecord()
+{
+    BenchRecord record;
+    record.type_ = BenchEnum::SECOND;
+    record.credit_ = 7;
+    record.counter_ = 0x01020304;
+    record.timestamp_ = 1541128318;
+    record.account_ = rai::Account(0x5A5A5A5A);
+    record.balance_ = rai::Amount(rai::RAI);
+    return record;
+}
+}  // namespace
+
+static void BM_StreamWrite(benchmark::State& state)
+{
+    BenchRecord record = MakeRecord();
+    std::vector<uint8_t> bytes;
+    for (auto _ : state)
+    {
+        bytes.clear();
+        {
+            rai::VectorStream stream(bytes);
+            for (int i = 0; i < 64; ++i)
+            {
+                WriteRecord(stream, record);
+            }
+        }
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_StreamWrite);
+
+static void BM_StreamRead(benchmark::State& state)
+{
+    BenchRecord record = MakeRecord();
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        for (int i = 0; i < 64; ++i)
+        {
+            WriteRecord(stream, record);
+        }
+    }
+    for (auto _ : state)
+    {
+        rai::BufferStream stream(bytes.data(), bytes.size());
+        bool error = false;
+        for (int i = 0; i < 64; ++i)
+        {
+            error |= ReadRecord(stream, record);
+        }
+        benchmark::DoNotOptimize(error);
+        benchmark::DoNotOptimize(record);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_StreamRead);
@@ -0,0 +1,38 @@
+#include <rai/core_test/bench_util.hpp>
+
+BenchKey::BenchKey()
+{
+    private_key_.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    public_key_ = rai::GeneratePublicKey(private_key_.data_);
+}
+
+const BenchKey& BenchSigner()
+{
+    static BenchKey key;
+    return key;
+}
+
+std::shared_ptr<rai::TxBlock> BenchTxBlock(uint64_t height,
+                                           uint64_t timestamp)
+{
+    const BenchKey& key = BenchSigner();
+    rai::BlockHash previous(height);
+    rai::Account representative(0x5A5A5A5A);
+    rai::Amount balance(rai::RAI * (height + 1));
+    rai::uint256_union link(height * 0x9E3779B97F4A7C15);
+    return std::make_shared<rai::TxBlock>(
+        rai::BlockOpcode::SEND, 1, 1, timestamp, height, key.public_key_,
+        previous, representative, balance, link, 0, std::vector<uint8_t>(),
+        key.private_key_, key.public_key_);
+}
+
+std::vector<uint8_t> BenchBytes(const rai::Block& block)
+{
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        block.Serialize(stream);
+    }
+    return bytes;
+}
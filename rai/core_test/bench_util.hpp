@@ -0,0 +1,19 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <rai/common/blocks.hpp>
+
+// Deterministic fixtures shared by the core_bench benchmarks
+class BenchKey
+{
+public:
+    BenchKey();
+
+    rai::RawKey private_key_;
+    rai::PublicKey public_key_;
+};
+
+const BenchKey& BenchSigner();
+std::shared_ptr<rai::TxBlock> BenchTxBlock(uint64_t height,
+                                           uint64_t timestamp = 1541128318);
+std::vector<uint8_t> BenchBytes(const rai::Block&);
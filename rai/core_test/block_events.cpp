@@ -0,0 +1,158 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include <rai/node/blockprocessor.hpp>
+
+namespace
+{
+rai::BlockEventConsumerStat TestConsumerStat(const rai::BlockEventBus& bus,
+                                             const std::string& name)
+{
+    for (const auto& i : bus.Stats())
+    {
+        if (i.name_ == name)
+        {
+            return i;
+        }
+    }
+    return rai::BlockEventConsumerStat{name, 0, 0, 0, 0, 0, 0};
+}
+}  // namespace
+
+TEST(block_events, flood)
+{
+    size_t constexpr capacity = 16;
+    uint64_t constexpr events = 1000;
+    rai::BlockEventBus bus(capacity, rai::BlockEventBus::DEFAULT_MAX_SPILL);
+
+    // Both consumers are held until the ring has been lapped many times
+    std::atomic<bool> released(false);
+    auto wait = [&released]() {
+        while (!released)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    // Stands in for the syncer and rewarder, which track every append
+    std::vector<uint64_t> appended;
+    bus.Subscribe(
+        "observers",
+        [&](const rai::BlockEvent& event) {
+            wait();
+            appended.push_back(event.result_.last_confirm_height_);
+        },
+        true);
+    std::atomic<uint64_t> notified(0);
+    bus.Subscribe("notifications", [&](const rai::BlockEvent& event) {
+        wait();
+        ++notified;
+    });
+    bus.Start();
+
+    for (uint64_t i = 0; i < events; ++i)
+    {
+        rai::BlockProcessResult result{rai::BlockOperation::APPEND,
+                                       rai::ErrorCode::SUCCESS, i};
+        bus.Publish(result, nullptr);
+    }
+    released = true;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        rai::BlockEventConsumerStat stat =
+            TestConsumerStat(bus, "notifications");
+        if (TestConsumerStat(bus, "observers").processed_ == events
+            && stat.processed_ + stat.skipped_ == events)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    rai::BlockEventConsumerStat observers = TestConsumerStat(bus, "observers");
+    rai::BlockEventConsumerStat notifications =
+        TestConsumerStat(bus, "notifications");
+    bus.Stop();
+
+    ASSERT_EQ(events, appended.size());
+    for (uint64_t i = 0; i < events; ++i)
+    {
+        ASSERT_EQ(i, appended[i]);
+    }
+    ASSERT_EQ(0, observers.skipped_);
+    ASSERT_GT(observers.spilled_, 0);
+    ASSERT_EQ(0, observers.lag_);
+
+    ASSERT_GT(notifications.skipped_, 0);
+    ASSERT_EQ(0, notifications.spilled_);
+    ASSERT_EQ(events, notifications.processed_ + notifications.skipped_);
+    ASSERT_EQ(notifications.processed_, notified);
+}
+
+TEST(block_events, spill_overflow)
+{
+    size_t constexpr capacity = 16;
+    size_t constexpr max_spill = 32;
+    uint64_t constexpr events = 1000;
+    rai::BlockEventBus bus(capacity, max_spill);
+
+    std::atomic<bool> released(false);
+    std::vector<rai::BlockEvent> received;
+    bus.Subscribe(
+        "observers",
+        [&](const rai::BlockEvent& event) {
+            while (!released)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            received.push_back(event);
+        },
+        true);
+    bus.Start();
+
+    for (uint64_t i = 0; i < events; ++i)
+    {
+        rai::BlockProcessResult result{rai::BlockOperation::APPEND,
+                                       rai::ErrorCode::SUCCESS, i};
+        bus.Publish(result, nullptr);
+    }
+    rai::BlockEventConsumerStat stat = TestConsumerStat(bus, "observers");
+    ASSERT_LE(stat.spill_, max_spill);
+    released = true;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        stat = TestConsumerStat(bus, "observers");
+        if (stat.lag_ == 0 && stat.processed_ + stat.skipped_ >= events)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stat = TestConsumerStat(bus, "observers");
+    bus.Stop();
+
+    ASSERT_GT(stat.skipped_, 0);
+    ASSERT_EQ(0, stat.spill_);
+
+    // Events after the resync marker arrive in order and end with the last one
+    size_t resync = received.size();
+    for (size_t i = 0; i < received.size(); ++i)
+    {
+        if (received[i].type_ == rai::BlockEventType::RESYNC)
+        {
+            resync = i;
+        }
+    }
+    ASSERT_LT(resync, received.size());
+    ASSERT_LT(resync + 1, received.size());
+    for (size_t i = resync + 2; i < received.size(); ++i)
+    {
+        ASSERT_EQ(received[i - 1].result_.last_confirm_height_ + 1,
+                  received[i].result_.last_confirm_height_);
+    }
+    ASSERT_EQ(events - 1, received.back().result_.last_confirm_height_);
+}
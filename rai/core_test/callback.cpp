@@ -0,0 +1,201 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include <rai/node/callback.hpp>
+
+namespace
+{
+// A local HTTP server answering every POST with 200 and closing each
+// connection after one request, whether or not the response said so
+class TestServer
+{
+public:
+    TestServer(bool keep_alive)
+        : keep_alive_(keep_alive),
+          acceptor_(service_, boost::asio::ip::tcp::endpoint(
+                                  boost::asio::ip::address_v4::loopback(), 0)),
+          stopped_(false),
+          connections_(0),
+          requests_(0)
+    {
+        thread_ = std::thread([this]() { Run_(); });
+    }
+
+    ~TestServer()
+    {
+        stopped_ = true;
+        // wake the blocking accept
+        boost::system::error_code ignore;
+        boost::asio::ip::tcp::socket socket(service_);
+        socket.connect(acceptor_.local_endpoint(), ignore);
+        thread_.join();
+    }
+
+    rai::Url Url() const
+    {
+        rai::Url url;
+        bool error = url.Parse(
+            "http://127.0.0.1:"
+            + std::to_string(acceptor_.local_endpoint().port()) + "/");
+        EXPECT_FALSE(error);
+        return url;
+    }
+
+    bool keep_alive_;
+    boost::asio::io_service service_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::atomic<bool> stopped_;
+    std::atomic<size_t> connections_;
+    std::atomic<size_t> requests_;
+    std::thread thread_;
+
+private:
+    void Run_()
+    {
+        while (true)
+        {
+            boost::system::error_code ec;
+            boost::asio::ip::tcp::socket socket(service_);
+            acceptor_.accept(socket, ec);
+            if (stopped_)
+            {
+                return;
+            }
+            if (ec)
+            {
+                continue;
+            }
+            ++connections_;
+
+            boost::beast::flat_buffer buffer;
+            boost::beast::http::request<boost::beast::http::string_body>
+                request;
+            boost::beast::http::read(socket, buffer, request, ec);
+            if (!ec)
+            {
+                ++requests_;
+                boost::beast::http::response<
+                    boost::beast::http::string_body>
+                    response(boost::beast::http::status::ok, 11);
+                response.keep_alive(keep_alive_);
+                response.prepare_payload();
+                boost::beast::http::write(socket, response, ec);
+            }
+            socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+            socket.close(ec);
+        }
+    }
+};
+
+class TestClient
+{
+public:
+    TestClient(const rai::Url& url)
+        : work_(service_), succeeded_(0), failed_(0)
+    {
+        rai::CallbackConfig config;
+        config.connections_ = 1;
+        // any counted attempt would fail the event
+        config.retries_ = 0;
+        dispatcher_ =
+            std::make_shared<rai::CallbackDispatcher>(service_, url, config);
+        thread_ = std::thread([this]() { service_.run(); });
+    }
+
+    ~TestClient()
+    {
+        dispatcher_->Stop();
+        service_.stop();
+        thread_.join();
+    }
+
+    void Send()
+    {
+        dispatcher_->Send("{}", [this](bool success) {
+            if (success)
+            {
+                ++succeeded_;
+            }
+            else
+            {
+                ++failed_;
+            }
+        });
+    }
+
+    bool Wait(size_t done)
+    {
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            if (succeeded_ + failed_ >= done)
+            {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    boost::asio::io_service service_;
+    boost::asio::io_service::work work_;
+    std::shared_ptr<rai::CallbackDispatcher> dispatcher_;
+    std::atomic<size_t> succeeded_;
+    std::atomic<size_t> failed_;
+    std::thread thread_;
+};
+}  // namespace
+
+TEST(callback, connection_close)
+{
+    TestServer server(false);
+    TestClient client(server.Url());
+
+    // Without a keep-alive response nothing is pipelined, each request gets
+    // a connection of its own and none is cut off by the close
+    size_t constexpr events = 5;
+    for (size_t i = 0; i < events; ++i)
+    {
+        client.Send();
+    }
+    ASSERT_TRUE(client.Wait(events));
+    rai::CallbackStat stat = client.dispatcher_->Stat();
+
+    ASSERT_EQ(events, client.succeeded_);
+    ASSERT_EQ(0, client.failed_);
+    ASSERT_EQ(events, stat.sent_);
+    ASSERT_EQ(0, stat.failed_);
+    ASSERT_EQ(0, stat.retried_);
+    ASSERT_EQ(events, server.requests_);
+    ASSERT_EQ(events, server.connections_);
+}
+
+TEST(callback, idle_close)
+{
+    TestServer server(true);
+    TestClient client(server.Url());
+
+    client.Send();
+    ASSERT_TRUE(client.Wait(1));
+    ASSERT_EQ(1, client.succeeded_);
+
+    // The server has closed the kept-alive connection in the meantime, the
+    // request written to it is sent again at once on a new connection
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto start = std::chrono::steady_clock::now();
+    client.Send();
+    ASSERT_TRUE(client.Wait(2));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    rai::CallbackStat stat = client.dispatcher_->Stat();
+
+    ASSERT_EQ(2, client.succeeded_);
+    ASSERT_EQ(0, client.failed_);
+    ASSERT_EQ(2, stat.sent_);
+    ASSERT_EQ(0, stat.failed_);
+    ASSERT_EQ(1, stat.retried_);
+    ASSERT_LT(elapsed, rai::CallbackDispatcher::RECONNECT_DELAY);
+    ASSERT_EQ(2, server.requests_);
+    ASSERT_EQ(2, server.connections_);
+}
@@ -65,6 +65,37 @@ TEST(ed25519, sign)
    ASSERT_NE(0, valid2);
 }
 
+TEST(ed25519, sign_expanded)
+{
+    ed25519_secret_key private_key;
+    bool ret = TestDecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4",
+        private_key, 32);
+    ASSERT_EQ(false, ret);
+    ed25519_public_key public_key;
+    ed25519_publickey(private_key, public_key);
+    ed25519_expanded_key expanded_key;
+    ed25519_expand_key(private_key, expanded_key);
+
+    for (size_t len = 0; len <= 128; len += 16)
+    {
+        std::vector<unsigned char> message(len);
+        for (size_t i = 0; i < len; ++i)
+        {
+            message[i] = static_cast<unsigned char>(i * 7 + len);
+        }
+        ed25519_signature sign_expect;
+        ed25519_sign(message.data(), len, private_key, public_key,
+                     sign_expect);
+        ed25519_signature sign;
+        ed25519_sign_expanded(message.data(), len, expanded_key, public_key,
+                              sign);
+        std::vector<unsigned char> v1(sign_expect, sign_expect + 64);
+        std::vector<unsigned char> v2(sign, sign + 64);
+        ASSERT_EQ(v1, v2);
+    }
+}
+
 #if EXECUTE_LONG_TIME_CASE
 TEST(ed25519, perfmance)
 {
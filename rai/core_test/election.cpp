@@ -0,0 +1,452 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <rai/node/election.hpp>
+#include <set>
+
+namespace
+{
+std::shared_ptr<rai::Block> TestBlock(uint64_t account, uint64_t height,
+                                      uint16_t credit, uint64_t balance,
+                                      uint64_t link = 0)
+{
+    rai::RawKey private_key;
+    private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key = rai::GeneratePublicKey(private_key.data_);
+    return std::make_shared<rai::TxBlock>(
+        rai::BlockOpcode::SEND, credit, 1, 1541128318, height,
+        rai::Account(account), rai::BlockHash(height), rai::Account(1),
+        rai::Amount(balance), rai::Account(link), 0, std::vector<uint8_t>(),
+        private_key, public_key);
+}
+
+void TestPush(rai::ElectionBacklog& backlog,
+              const std::shared_ptr<rai::Block>& block)
+{
+    backlog.Push(block->Account(), block->Height(),
+                 std::vector<std::shared_ptr<rai::Block>>{block});
+}
+
+// Reps' weights and online state as Elections sees them
+class TestWeights
+{
+public:
+    rai::Amount Weight(const rai::Account& rep) const
+    {
+        auto it = weights_.find(rep);
+        return it == weights_.end() ? rai::Amount(0) : it->second;
+    }
+
+    bool Online(const rai::Account& rep) const
+    {
+        return online_.find(rep) != online_.end();
+    }
+
+    rai::RepTallyChange Change(const rai::Account& rep,
+                               const rai::Amount& weight, bool online)
+    {
+        rai::RepTallyChange change;
+        change.representative_ = rep;
+        change.weight_old_ = Weight(rep);
+        change.weight_new_ = weight;
+        change.online_old_ = Online(rep);
+        change.online_new_ = online;
+        weights_[rep] = weight;
+        if (online)
+        {
+            online_.insert(rep);
+        }
+        else
+        {
+            online_.erase(rep);
+        }
+        return change;
+    }
+
+    std::map<rai::Account, rai::Amount> weights_;
+    std::set<rai::Account> online_;
+};
+
+// Counts the votes of the election from scratch the way Elections::Tally_
+// did before the tally was kept incrementally, and checks the incremental
+// tally against it
+void TestRecount(const rai::Election& election, const TestWeights& weights,
+                 uint64_t base)
+{
+    rai::Amount conflict(0);
+    rai::Amount online(0);
+    std::map<rai::BlockHash, rai::Amount> totals;
+    for (const auto& i : election.votes_)
+    {
+        rai::Amount weight = weights.Weight(i.first);
+        if (weights.Online(i.first))
+        {
+            online += weight;
+        }
+        if (i.second.conflict_found_)
+        {
+            conflict += weight;
+        }
+        else if (!weight.IsZero())
+        {
+            totals[i.second.last_vote_.hash_] += weight;
+        }
+    }
+    ASSERT_EQ(conflict, election.tally_conflict_);
+    ASSERT_EQ(online, election.tally_online_);
+    ASSERT_EQ(totals.size(), election.candidates_.size());
+
+    for (const auto& total : totals)
+    {
+        auto it = election.candidates_.find(total.first);
+        ASSERT_NE(election.candidates_.end(), it);
+        ASSERT_EQ(total.second, it->second.total_);
+
+        for (uint64_t now : {base - 100, base, base + 30, base + 70,
+                             base + 150, base + 400})
+        {
+            for (uint64_t allow : {16, 32, 64})
+            {
+                rai::Amount expected(0);
+                for (const auto& i : election.votes_)
+                {
+                    const rai::Vote& vote = i.second.last_vote_;
+                    if (i.second.conflict_found_ || vote.hash_ != total.first)
+                    {
+                        continue;
+                    }
+                    uint64_t factor = rai::RepVoteInfo::WeightFactor(
+                        vote.timestamp_, now, allow);
+                    rai::Amount adjust;
+                    ASSERT_FALSE(
+                        weights.Weight(i.first).MulDiv(factor, 100, adjust));
+                    expected += adjust;
+                }
+                ASSERT_EQ(expected, it->second.Weight(now, allow));
+            }
+        }
+    }
+}
+
+std::vector<rai::Account> TestPopAll(rai::ElectionBacklog& backlog)
+{
+    std::vector<rai::Account> result;
+    rai::QueuedElection queued;
+    while (!backlog.Pop([](const rai::Account&) { return false; }, queued))
+    {
+        result.push_back(queued.account_);
+    }
+    return result;
+}
+}  // namespace
+
+TEST(election_backlog, order)
+{
+    rai::ElectionBacklog backlog(100);
+    TestPush(backlog, TestBlock(1, 0, 1, 1));
+    TestPush(backlog, TestBlock(2, 0, 2, 1));
+    TestPush(backlog, TestBlock(3, 0, 1, 5));
+    backlog.Push(rai::Account(4), 0,
+                 std::vector<std::shared_ptr<rai::Block>>{
+                     TestBlock(4, 0, 1, 1, 1), TestBlock(4, 0, 1, 1, 2)});
+    TestPush(backlog, TestBlock(5, 0, 1, 1));
+    ASSERT_EQ(5, backlog.Size());
+
+    // Forks, then credit, then balance, then the older
+    std::vector<rai::Account> expected{rai::Account(4), rai::Account(2),
+                                       rai::Account(3), rai::Account(1),
+                                       rai::Account(5)};
+    ASSERT_EQ(expected, TestPopAll(backlog));
+    ASSERT_TRUE(backlog.Empty());
+}
+
+TEST(election_backlog, skip_active)
+{
+    rai::ElectionBacklog backlog(100);
+    TestPush(backlog, TestBlock(1, 0, 2, 1));
+    TestPush(backlog, TestBlock(2, 0, 1, 1));
+
+    rai::QueuedElection queued;
+    auto active = [](const rai::Account& account) {
+        return account == rai::Account(1);
+    };
+    ASSERT_FALSE(backlog.Pop(active, queued));
+    ASSERT_EQ(rai::Account(2), queued.account_);
+    // The active account keeps its place until its election ends
+    ASSERT_TRUE(backlog.Pop(active, queued));
+    ASSERT_EQ(1, backlog.Size());
+    ASSERT_FALSE(
+        backlog.Pop([](const rai::Account&) { return false; }, queued));
+    ASSERT_EQ(rai::Account(1), queued.account_);
+}
+
+TEST(election_backlog, merge)
+{
+    rai::ElectionBacklog backlog(100);
+    TestPush(backlog, TestBlock(1, 5, 1, 1));
+    TestPush(backlog, TestBlock(2, 0, 2, 1));
+
+    // A higher block of the same account waits for the lower one
+    TestPush(backlog, TestBlock(1, 7, 3, 1));
+    ASSERT_EQ(2, backlog.Size());
+
+    // A second block at the same height makes it a fork
+    TestPush(backlog, TestBlock(1, 5, 1, 1, 1));
+    TestPush(backlog, TestBlock(1, 5, 1, 1));
+    rai::QueuedElection queued;
+    ASSERT_FALSE(
+        backlog.Pop([](const rai::Account&) { return false; }, queued));
+    ASSERT_EQ(rai::Account(1), queued.account_);
+    ASSERT_EQ(5, queued.height_);
+    ASSERT_EQ(2, queued.blocks_.size());
+    ASSERT_TRUE(queued.priority_.fork_);
+
+    // A lower block replaces the queued ones
+    TestPush(backlog, TestBlock(1, 5, 1, 1));
+    TestPush(backlog, TestBlock(1, 3, 1, 1));
+    ASSERT_FALSE(
+        backlog.Pop([](const rai::Account&) { return false; }, queued));
+    ASSERT_FALSE(
+        backlog.Pop([](const rai::Account&) { return false; }, queued));
+    ASSERT_EQ(rai::Account(1), queued.account_);
+    ASSERT_EQ(3, queued.height_);
+    ASSERT_EQ(1, queued.blocks_.size());
+    ASSERT_TRUE(backlog.Empty());
+}
+
+TEST(election_backlog, limit)
+{
+    rai::ElectionBacklog backlog(3);
+    TestPush(backlog, TestBlock(1, 4, 1, 1));
+    TestPush(backlog, TestBlock(2, 0, 2, 1));
+    TestPush(backlog, TestBlock(3, 0, 3, 1));
+    ASSERT_EQ(0, backlog.Dropped());
+
+    // The lowest entry makes room for a higher one
+    TestPush(backlog, TestBlock(4, 0, 4, 1));
+    ASSERT_EQ(3, backlog.Size());
+    ASSERT_EQ(1, backlog.Dropped());
+    ASSERT_EQ(1, backlog.EvictedSize());
+
+    // One lower than all is dropped itself, both are remembered
+    TestPush(backlog, TestBlock(5, 0, 1, 1));
+    ASSERT_EQ(3, backlog.Size());
+    ASSERT_EQ(2, backlog.Dropped());
+    ASSERT_EQ(2, backlog.EvictedSize());
+    TestPush(backlog, TestBlock(1, 2, 1, 1));
+    ASSERT_EQ(3, backlog.Dropped());
+    ASSERT_EQ(2, backlog.EvictedSize());
+
+    // Queued again, it is no longer evicted
+    rai::QueuedElection queued;
+    ASSERT_FALSE(
+        backlog.Pop([](const rai::Account&) { return false; }, queued));
+    ASSERT_EQ(rai::Account(4), queued.account_);
+    TestPush(backlog, TestBlock(5, 0, 1, 1));
+    ASSERT_EQ(3, backlog.Size());
+    ASSERT_EQ(1, backlog.EvictedSize());
+
+    // The lowest evicted height of an account is kept
+    auto evicted = backlog.Evicted(10);
+    ASSERT_EQ(1, evicted.size());
+    ASSERT_EQ(rai::Account(1), evicted[0].first);
+    ASSERT_EQ(2, evicted[0].second);
+    ASSERT_EQ(0, backlog.EvictedSize());
+    ASSERT_TRUE(backlog.Evicted(10).empty());
+
+    std::vector<rai::Account> expected{rai::Account(3), rai::Account(2),
+                                       rai::Account(5)};
+    ASSERT_EQ(expected, TestPopAll(backlog));
+}
+
+TEST(elections, batch_votes)
+{
+    rai::RawKey private_key;
+    private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey representative =
+        rai::GeneratePublicKey(private_key.data_);
+    uint64_t now = 1541128318;
+
+    std::vector<rai::ConfirmEntry> entries{
+        rai::ConfirmEntry(rai::Account(1), 5, now, rai::BlockHash(11)),
+        rai::ConfirmEntry(rai::Account(2), 7, now - 3600, rai::BlockHash(12)),
+        rai::ConfirmEntry(rai::Account(3), 0, now + 10, rai::BlockHash(13))};
+    auto message =
+        std::make_shared<rai::ConfirmBatchMessage>(representative, entries);
+    message->SetSignature(
+        rai::SignMessage(private_key, representative, message->Hash()));
+
+    // Entries outside the timestamp window are dropped
+    auto votes = rai::Elections::BatchVotes(message, now);
+    ASSERT_EQ(2, votes.size());
+    ASSERT_EQ(rai::Account(1), votes[0].first.account_);
+    ASSERT_EQ(5, votes[0].first.height_);
+    ASSERT_EQ(rai::Account(3), votes[1].first.account_);
+
+    // Every vote keeps the batch, which proves it to any peer
+    for (const auto& i : votes)
+    {
+        const rai::Vote& vote = i.second;
+        ASSERT_EQ(i.first.timestamp_, vote.timestamp_);
+        ASSERT_EQ(i.first.hash_, vote.hash_);
+        ASSERT_EQ(message, vote.batch_);
+        ASSERT_EQ(message->signature_, vote.signature_);
+        ASSERT_FALSE(rai::ValidateMessage(representative, vote.batch_->Hash(),
+                                          vote.batch_->signature_));
+    }
+
+    // A vote received on its own has no batch
+    rai::Vote single(now, rai::Signature(0), rai::BlockHash(11));
+    ASSERT_FALSE(single.batch_);
+}
+
+TEST(candidate_tally, weight)
+{
+    uint64_t now = 1541128318;
+    rai::CandidateTally tally;
+    ASSERT_TRUE(tally.Empty());
+    tally.Add(now, rai::Amount(300));
+    tally.Add(now, rai::Amount(200));
+    tally.Add(now - 48, rai::Amount(100));
+    tally.Add(now + 40, rai::Amount(400));
+    tally.Add(now - 100, rai::Amount(0));
+    ASSERT_EQ(3, tally.timestamps_.size());
+    ASSERT_EQ(rai::Amount(1000), tally.total_);
+
+    // Full weight inside the window, linear decay over one more window
+    ASSERT_EQ(rai::Amount(1000), tally.Weight(now, 64));
+    ASSERT_EQ(rai::Amount(500 + 50 + 300), tally.Weight(now, 32));
+    ASSERT_EQ(rai::Amount(0), tally.Weight(now + 200, 64));
+    ASSERT_EQ(rai::Amount(0), tally.Weight(now, 0));
+    ASSERT_EQ(rai::Amount(0), tally.Weight(now, rai::MAX_TIMESTAMP_DIFF + 1));
+
+    tally.Del(now, rai::Amount(300));
+    ASSERT_EQ(3, tally.timestamps_.size());
+    tally.Del(now, rai::Amount(200));
+    ASSERT_EQ(2, tally.timestamps_.size());
+    ASSERT_EQ(rai::Amount(500), tally.total_);
+    tally.Del(now - 48, rai::Amount(100));
+    tally.Del(now + 40, rai::Amount(400));
+    ASSERT_TRUE(tally.Empty());
+    ASSERT_EQ(rai::Amount(0), tally.total_);
+}
+
+TEST(election, tally)
+{
+    uint64_t base = 1541128318;
+    rai::Election election;
+    TestWeights weights;
+    weights.Change(rai::Account(1), rai::Amount(300), true);
+    weights.Change(rai::Account(2), rai::Amount(500), false);
+    weights.Change(rai::Account(4), rai::Amount(900), true);
+
+    auto vote = [&](uint64_t rep, uint64_t timestamp, uint64_t hash) {
+        rai::RepVoteInfo info(false, weights.Weight(rai::Account(rep)),
+                              rai::Vote(timestamp, rai::Signature(0),
+                                        rai::BlockHash(hash)));
+        election.SetVote(rai::Account(rep), info,
+                         weights.Weight(rai::Account(rep)),
+                         weights.Online(rai::Account(rep)));
+    };
+
+    vote(1, base, 10);
+    vote(2, base + 10, 11);
+    vote(3, base, 10);  // no weight
+    TestRecount(election, weights, base);
+
+    // A newer vote replaces the old one
+    vote(1, base + 50, 10);
+    vote(1, base + 60, 11);
+    TestRecount(election, weights, base);
+
+    // A conflicting rep keeps its last vote but only counts as conflict
+    rai::RepVoteInfo info = election.votes_[rai::Account(2)];
+    info.conflict_found_ = true;
+    election.SetVote(rai::Account(2), info, weights.Weight(rai::Account(2)),
+                     weights.Online(rai::Account(2)));
+    TestRecount(election, weights, base);
+
+    // Weight and online changes, rep 4 hasn't voted
+    std::vector<rai::RepTallyChange> changes{
+        weights.Change(rai::Account(1), rai::Amount(700), false),
+        weights.Change(rai::Account(2), rai::Amount(200), true),
+        weights.Change(rai::Account(3), rai::Amount(100), true),
+        weights.Change(rai::Account(4), rai::Amount(0), false)};
+    election.TallyUpdate(changes);
+    TestRecount(election, weights, base);
+
+    vote(3, base + 5, 11);
+    vote(4, base + 5, 10);  // no weight any more
+    TestRecount(election, weights, base);
+}
+
+TEST(election, tally_replay)
+{
+    uint64_t base = 1541128318;
+    rai::Election election;
+    TestWeights weights;
+    std::mt19937 random(7);
+    auto pick = [&random](uint64_t n) {
+        return std::uniform_int_distribution<uint64_t>(0, n - 1)(random);
+    };
+
+    // Weights in multiples of 100 so that decaying a sum and summing the
+    // decayed weights round the same way
+    for (uint64_t rep = 1; rep <= 8; ++rep)
+    {
+        weights.Change(rai::Account(rep), rai::Amount(pick(10) * 100),
+                       pick(2) == 0);
+    }
+
+    for (size_t step = 0; step < 500; ++step)
+    {
+        rai::Account rep(1 + pick(8));
+        auto it = election.votes_.find(rep);
+        bool conflict = it != election.votes_.end()
+                        && it->second.conflict_found_;
+        switch (pick(4))
+        {
+            case 0:  // confirm, new or replacing
+            case 1:
+            {
+                if (conflict)
+                {
+                    break;
+                }
+                rai::RepVoteInfo info(
+                    false, weights.Weight(rep),
+                    rai::Vote(base + pick(120), rai::Signature(0),
+                              rai::BlockHash(1 + pick(3))));
+                election.SetVote(rep, info, weights.Weight(rep),
+                                 weights.Online(rep));
+                break;
+            }
+            case 2:  // conflict
+            {
+                if (it == election.votes_.end() || conflict)
+                {
+                    break;
+                }
+                rai::RepVoteInfo info(it->second);
+                info.conflict_found_ = true;
+                election.SetVote(rep, info, weights.Weight(rep),
+                                 weights.Online(rep));
+                break;
+            }
+            case 3:  // weight or online change
+            {
+                std::vector<rai::RepTallyChange> changes{weights.Change(
+                    rep, rai::Amount(pick(10) * 100), pick(2) == 0)};
+                election.TallyUpdate(changes);
+                break;
+            }
+        }
+        TestRecount(election, weights, base);
+        if (HasFatalFailure())
+        {
+            FAIL() << "step " << step;
+        }
+    }
+}
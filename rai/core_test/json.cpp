@@ -0,0 +1,153 @@
+#include <rai/common/json.hpp>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <boost/property_tree/json_parser.hpp>
+#include <rai/common/blocks.hpp>
+
+namespace
+{
+std::string WriteJson(const rai::Ptree& ptree)
+{
+    std::stringstream stream;
+    boost::property_tree::write_json(stream, ptree, false);
+    std::string result = stream.str();
+    if (!result.empty() && result.back() == '\n')
+    {
+        result.pop_back();
+    }
+    return result;
+}
+}  // namespace
+
+TEST(json, writer)
+{
+    rai::Ptree ptree;
+    ptree.put("action", "block_query");
+    ptree.put("count", "10");
+    ptree.put("escape", "a\"b\\c/d\n\t\x01\xe4\xb8\xad");
+    ptree.put("empty", "");
+    rai::Ptree array;
+    for (int i = 0; i < 3; ++i)
+    {
+        rai::Ptree entry;
+        entry.put("index", std::to_string(i));
+        array.push_back(std::make_pair("", entry));
+    }
+    rai::Ptree strings;
+    strings.push_back(std::make_pair("", rai::Ptree("x")));
+    strings.push_back(std::make_pair("", rai::Ptree("y")));
+    ptree.add_child("array", array);
+    ptree.add_child("strings", strings);
+    ptree.put("nested.child.leaf", "1");
+
+    ASSERT_EQ(WriteJson(ptree), rai::PtreeToJson(ptree));
+    ASSERT_EQ(WriteJson(rai::Ptree()), rai::PtreeToJson(rai::Ptree()));
+
+    std::string out;
+    rai::JsonWriter writer(out);
+    writer.StartObject();
+    writer.Put("height", 18446744073709551615ULL);
+    writer.Put("zero", 0);
+    writer.Key("list");
+    writer.StartArray();
+    writer.String("a");
+    writer.Raw("{\"b\":\"c\"}");
+    writer.EndArray();
+    writer.EndObject();
+    ASSERT_EQ(
+        "{\"height\":\"18446744073709551615\",\"zero\":\"0\","
+        "\"list\":[\"a\",{\"b\":\"c\"}]}",
+        out);
+}
+
+TEST(json, reader)
+{
+    std::string json = R"%%%({
+        "action" : "account_info",
+        "count": 10,
+        "flag": true,
+        "none": null,
+        "real": -1.5e3,
+        "text": "a\"b\\c\/d\n\u0041\u4e2d\ud83d\ude00",
+        "list": ["x", {"k": "v"}, []],
+        "object": {"inner": {"leaf": "1"}}
+    })%%%";
+
+    rai::Ptree expected;
+    std::stringstream stream(json);
+    boost::property_tree::read_json(stream, expected);
+
+    rai::Ptree ptree;
+    rai::JsonReader reader(20);
+    rai::JsonPtreeHandler handler(ptree);
+    ASSERT_EQ(false, reader.Parse(json, handler));
+    ASSERT_EQ(expected, ptree);
+    ASSERT_EQ("10", ptree.get<std::string>("count"));
+    ASSERT_EQ("true", ptree.get<std::string>("flag"));
+
+    std::vector<std::string> invalid{
+        "",          "{",         "{\"a\"}",      "{\"a\":}",
+        "[1,]",      "{\"a\":1,}", "[01]",        "[1.]",
+        "[tru]",     "[\"\\x\"]", "[\"\\ud800\"]", "{} {}",
+        "[\"a\nb\"]"};
+    for (const auto& i : invalid)
+    {
+        rai::Ptree ptree;
+        rai::JsonPtreeHandler handler(ptree);
+        ASSERT_EQ(true, reader.Parse(i, handler)) << i;
+        ASSERT_EQ(false, reader.DepthExceeded()) << i;
+    }
+
+    rai::JsonReader shallow(2);
+    {
+        rai::Ptree ptree;
+        rai::JsonPtreeHandler handler(ptree);
+        ASSERT_EQ(false, shallow.Parse("{\"a\":{\"b\":\"[[[\"}}", handler));
+    }
+    {
+        rai::Ptree ptree;
+        rai::JsonPtreeHandler handler(ptree);
+        ASSERT_EQ(true, shallow.Parse("{\"a\":{\"b\":[]}}", handler));
+        ASSERT_EQ(true, shallow.DepthExceeded());
+    }
+}
+
+TEST(json, block)
+{
+    rai::Account account;
+    rai::BlockHash hash;
+    rai::Account representive;
+    rai::Amount balance;
+    rai::uint256_union link;
+    rai::RawKey raw_key;
+    rai::PublicKey public_key;
+
+    account.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    representive.DecodeHex(
+        "0311B25E0D1E1D7724BBA5BD523954F1DBCFC01CB8671D55ED2D32C7549FB252");
+    balance.DecodeDec("1");
+    link.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+
+    std::vector<std::vector<uint8_t>> extensions{
+        {}, {0, 1, 0, 7, 'r', 'a', 'i', 'c', 'o', 'i', 'n'}};
+    for (const auto& i : extensions)
+    {
+        rai::TxBlock block(rai::BlockOpcode::SEND, 1, 1, 1541128318, 1,
+                           account, hash, representive, balance, link,
+                           static_cast<uint32_t>(i.size()), i, raw_key,
+                           public_key);
+        rai::Ptree ptree;
+        block.SerializeJson(ptree);
+        std::string out;
+        rai::JsonWriter writer(out);
+        block.SerializeJson(writer);
+        ASSERT_EQ(WriteJson(ptree), out);
+    }
+}
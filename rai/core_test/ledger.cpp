@@ -0,0 +1,580 @@
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <rai/secure/common.hpp>
+#include <rai/secure/ledger.hpp>
+
+namespace
+{
+// A throwaway node ledger in the temp directory
+class TestLedger
+{
+public:
+    TestLedger()
+        : path_(boost::filesystem::temp_directory_path()
+                / boost::filesystem::unique_path()),
+          error_code_(rai::ErrorCode::SUCCESS),
+          store_(error_code_, Create_(path_) / "data.ldb"),
+          ledger_(error_code_, store_, true)
+    {
+    }
+
+    ~TestLedger()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(path_, ec);
+    }
+
+    boost::filesystem::path path_;
+    rai::ErrorCode error_code_;
+    rai::Store store_;
+    rai::Ledger ledger_;
+
+private:
+    static const boost::filesystem::path& Create_(
+        const boost::filesystem::path& path)
+    {
+        boost::filesystem::create_directories(path);
+        return path;
+    }
+};
+
+class TestKey
+{
+public:
+    TestKey()
+    {
+        private_key_.data_.DecodeHex(
+            "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+        public_key_ = rai::GeneratePublicKey(private_key_.data_);
+    }
+
+    rai::RawKey private_key_;
+    rai::PublicKey public_key_;
+};
+
+// The genesis account and a confirmed chain of sends to it, every send is
+// still receivable and rewardable
+std::vector<std::shared_ptr<rai::Block>> TestPopulate(rai::Ledger& ledger,
+                                                      uint64_t count)
+{
+    rai::Genesis genesis;
+    rai::Account destination = genesis.block_->Account();
+    TestKey key;
+    rai::Account representative(0x5A5A5A5A);
+
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    rai::BlockHash previous(0);
+    for (uint64_t height = 0; height < count; ++height)
+    {
+        rai::Amount balance(rai::RAI * (count - height));
+        blocks.push_back(std::make_shared<rai::TxBlock>(
+            rai::BlockOpcode::SEND, 1, 1, 1541128318 + height, height,
+            key.public_key_, previous, representative, balance, destination,
+            0, std::vector<uint8_t>(), key.private_key_, key.public_key_));
+        previous = blocks.back()->Hash();
+    }
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, ledger, true);
+    EXPECT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+    rai::BlockHash genesis_hash = genesis.block_->Hash();
+    EXPECT_FALSE(ledger.BlockPut(transaction, genesis_hash, *genesis.block_));
+    rai::AccountInfo genesis_info(genesis.block_->Type(), genesis_hash);
+    genesis_info.confirmed_height_ = 0;
+    EXPECT_FALSE(ledger.AccountInfoPut(transaction, destination, genesis_info));
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        const rai::Block& block = *blocks[i];
+        rai::BlockHash successor(0);
+        if (i + 1 < blocks.size())
+        {
+            successor = blocks[i + 1]->Hash();
+        }
+        EXPECT_FALSE(
+            ledger.BlockPut(transaction, block.Hash(), block, successor));
+        rai::ReceivableInfo receivable(block.Account(), rai::RAI,
+                                       block.Timestamp());
+        EXPECT_FALSE(ledger.ReceivableInfoPut(transaction, destination,
+                                              block.Hash(), receivable));
+        rai::RewardableInfo rewardable(block.Account(), rai::RAI,
+                                       block.Timestamp());
+        EXPECT_FALSE(ledger.RewardableInfoPut(transaction, representative,
+                                              block.Hash(), rewardable));
+    }
+
+    rai::AccountInfo info(rai::BlockType::TX_BLOCK, blocks.front()->Hash());
+    info.head_ = blocks.back()->Hash();
+    info.head_height_ = count - 1;
+    info.confirmed_height_ = count - 1;
+    EXPECT_FALSE(ledger.AccountInfoPut(transaction, key.public_key_, info));
+    return blocks;
+}
+
+std::vector<uint8_t> TestInflate(const boost::filesystem::path& path)
+{
+    std::ifstream file(path.string(), std::ios::in | std::ios::binary);
+    boost::iostreams::filtering_istream in;
+    in.push(boost::iostreams::zlib_decompressor());
+    in.push(file);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                std::istreambuf_iterator<char>());
+}
+
+void TestDeflate(const boost::filesystem::path& path,
+                 const std::vector<uint8_t>& bytes)
+{
+    std::ofstream file(path.string(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::zlib_compressor());
+    out.push(file);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+// Imports into a fresh ledger, a failed import is rolled back
+rai::ErrorCode TestImport(const boost::filesystem::path& path)
+{
+    TestLedger target;
+    EXPECT_EQ(rai::ErrorCode::SUCCESS, target.error_code_);
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, target.ledger_, true);
+    EXPECT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    error_code = target.ledger_.SnapshotImport(transaction, path);
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        transaction.Abort();
+    }
+    return error_code;
+}
+}  // namespace
+
+TEST(ledger, snapshot_summaries)
+{
+    TestLedger source;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, source.error_code_);
+    TestPopulate(source.ledger_, 4);
+    boost::filesystem::path file = source.path_ / "snapshot.bin";
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, source.ledger_, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_FALSE(source.ledger_.CallbackPut(transaction, 1, "{}"));
+        ASSERT_FALSE(source.ledger_.CallbackAckedPut(transaction, 1));
+        ASSERT_EQ(rai::ErrorCode::SUCCESS,
+                  source.ledger_.SnapshotExport(transaction, file));
+    }
+
+    // The fresh store already holds the meta records written on open
+    TestLedger target;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, target.error_code_);
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, target.ledger_, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS,
+              target.ledger_.SnapshotImport(transaction, file));
+
+    rai::Genesis genesis;
+    rai::AmountSummary summary;
+    ASSERT_FALSE(target.ledger_.ReceivableSummaryGet(
+        transaction, genesis.block_->Account(), summary));
+    ASSERT_EQ(4, summary.count_);
+    ASSERT_EQ(rai::Amount(rai::RAI * 4), summary.amount_);
+    ASSERT_FALSE(target.ledger_.RewardableSummaryGet(
+        transaction, rai::Account(0x5A5A5A5A), summary));
+    ASSERT_EQ(4, summary.count_);
+
+    // The callbacks outbox stays with the exporting node
+    uint64_t acked = 0;
+    ASSERT_TRUE(target.ledger_.CallbackAckedGet(transaction, acked));
+    uint64_t first = 0;
+    ASSERT_TRUE(target.ledger_.CallbackFirst(transaction, first));
+}
+
+TEST(ledger, snapshot_round_trip)
+{
+    TestLedger source;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, source.error_code_);
+    auto blocks = TestPopulate(source.ledger_, 5);
+    boost::filesystem::path file = source.path_ / "snapshot.bin";
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, source.ledger_, false);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS,
+              source.ledger_.SnapshotExport(transaction, file));
+
+    TestLedger target;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, target.error_code_);
+    rai::Transaction transaction_target(error_code, target.ledger_, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS,
+              target.ledger_.SnapshotImport(transaction_target, file));
+
+    size_t count = 0;
+    size_t count_target = 0;
+    ASSERT_FALSE(source.ledger_.AccountCount(transaction, count));
+    ASSERT_FALSE(target.ledger_.AccountCount(transaction_target, count_target));
+    ASSERT_EQ(2, count);
+    ASSERT_EQ(count, count_target);
+    for (auto i = source.ledger_.AccountInfoBegin(transaction),
+              n = source.ledger_.AccountInfoEnd(transaction);
+         i != n; ++i)
+    {
+        rai::Account account;
+        rai::AccountInfo info;
+        ASSERT_FALSE(source.ledger_.AccountInfoGet(i, account, info));
+        rai::AccountInfo info_target;
+        ASSERT_FALSE(target.ledger_.AccountInfoGet(transaction_target, account,
+                                                   info_target));
+        ASSERT_EQ(info.head_, info_target.head_);
+        ASSERT_EQ(info.head_height_, info_target.head_height_);
+        ASSERT_EQ(info.tail_, info_target.tail_);
+        ASSERT_EQ(info.tail_height_, info_target.tail_height_);
+        ASSERT_EQ(info.confirmed_height_, info_target.confirmed_height_);
+    }
+
+    ASSERT_FALSE(source.ledger_.BlockCount(transaction, count));
+    ASSERT_FALSE(target.ledger_.BlockCount(transaction_target, count_target));
+    ASSERT_EQ(blocks.size() + 1, count);
+    ASSERT_EQ(count, count_target);
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        std::shared_ptr<rai::Block> block(nullptr);
+        rai::BlockHash successor;
+        ASSERT_FALSE(target.ledger_.BlockGet(
+            transaction_target, blocks[i]->Hash(), block, successor));
+        ASSERT_TRUE(*blocks[i] == *block);
+        if (i + 1 < blocks.size())
+        {
+            ASSERT_EQ(blocks[i + 1]->Hash(), successor);
+        }
+        // Heights are indexed too
+        ASSERT_FALSE(target.ledger_.BlockGet(
+            transaction_target, blocks[i]->Account(), i, block));
+        ASSERT_EQ(blocks[i]->Hash(), block->Hash());
+    }
+
+    ASSERT_FALSE(source.ledger_.ReceivableInfoCount(transaction, count));
+    ASSERT_FALSE(
+        target.ledger_.ReceivableInfoCount(transaction_target, count_target));
+    ASSERT_EQ(blocks.size(), count);
+    ASSERT_EQ(count, count_target);
+    rai::Genesis genesis;
+    for (const auto& block : blocks)
+    {
+        rai::ReceivableInfo info;
+        ASSERT_FALSE(source.ledger_.ReceivableInfoGet(
+            transaction, genesis.block_->Account(), block->Hash(), info));
+        rai::ReceivableInfo info_target;
+        ASSERT_FALSE(target.ledger_.ReceivableInfoGet(
+            transaction_target, genesis.block_->Account(), block->Hash(),
+            info_target));
+        ASSERT_EQ(info.source_, info_target.source_);
+        ASSERT_EQ(info.amount_, info_target.amount_);
+        ASSERT_EQ(info.timestamp_, info_target.timestamp_);
+    }
+}
+
+TEST(ledger, snapshot_format)
+{
+    TestLedger source;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, source.error_code_);
+    TestPopulate(source.ledger_, 3);
+    boost::filesystem::path file = source.path_ / "snapshot.bin";
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, source.ledger_, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS,
+                  source.ledger_.SnapshotExport(transaction, file));
+    }
+
+    // Header, records, END and a blake2b checksum over everything before it
+    std::vector<uint8_t> header;
+    {
+        rai::VectorStream stream(header);
+        rai::Genesis genesis;
+        rai::Write(stream, rai::Ledger::SNAPSHOT_MAGIC);
+        rai::Write(stream, rai::Ledger::SNAPSHOT_VERSION);
+        rai::Write(stream, static_cast<uint8_t>(rai::RAI_NETWORK));
+        rai::Write(stream, genesis.block_->Hash().bytes);
+    }
+    std::vector<uint8_t> bytes = TestInflate(file);
+    size_t checksum_size = sizeof(rai::uint256_union);
+    ASSERT_GT(bytes.size(), header.size() + 1 + checksum_size);
+    ASSERT_TRUE(std::equal(header.begin(), header.end(), bytes.begin()));
+    ASSERT_EQ(static_cast<uint8_t>(rai::SnapshotTable::ACCOUNTS),
+              bytes[header.size()]);
+    ASSERT_EQ(static_cast<uint8_t>(rai::SnapshotTable::END),
+              bytes[bytes.size() - checksum_size - 1]);
+
+    boost::filesystem::path corrupt = source.path_ / "corrupt.bin";
+    std::vector<uint8_t> bytes_l(bytes);
+    bytes_l[0] ^= 0xFF;
+    TestDeflate(corrupt, bytes_l);
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_FORMAT, TestImport(corrupt));
+
+    bytes_l = bytes;
+    bytes_l[sizeof(rai::Ledger::SNAPSHOT_MAGIC)] ^= 0xFF;
+    TestDeflate(corrupt, bytes_l);
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_VERSION, TestImport(corrupt));
+
+    bytes_l = bytes;
+    bytes_l[header.size()] = 0xFF;
+    TestDeflate(corrupt, bytes_l);
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_FORMAT, TestImport(corrupt));
+
+    // Truncated before END
+    bytes_l.assign(bytes.begin(), bytes.end() - checksum_size - 1);
+    TestDeflate(corrupt, bytes_l);
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_FORMAT, TestImport(corrupt));
+
+    // Not compressed at all
+    {
+        std::ofstream out(corrupt.string(), std::ios::out | std::ios::binary
+                                                | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_FORMAT, TestImport(corrupt));
+
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, TestImport(file));
+
+    // Only an empty ledger can be imported into
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, source.ledger_, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_LEDGER_NOT_EMPTY,
+              source.ledger_.SnapshotImport(transaction, file));
+    transaction.Abort();
+}
+
+TEST(ledger, snapshot_checksum)
+{
+    TestLedger source;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, source.error_code_);
+    TestPopulate(source.ledger_, 3);
+    boost::filesystem::path file = source.path_ / "snapshot.bin";
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, source.ledger_, false);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS,
+                  source.ledger_.SnapshotExport(transaction, file));
+    }
+    std::vector<uint8_t> bytes = TestInflate(file);
+    boost::filesystem::path corrupt = source.path_ / "corrupt.bin";
+
+    std::vector<uint8_t> bytes_l(bytes);
+    bytes_l.back() ^= 0x01;
+    TestDeflate(corrupt, bytes_l);
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_CHECKSUM, TestImport(corrupt));
+
+    // A byte of the first account info: table, key size, account, value size
+    size_t header_size = 4 + 4 + 1 + sizeof(rai::BlockHash);
+    bytes_l = bytes;
+    bytes_l[header_size + 1 + 4 + sizeof(rai::Account) + 4 + 10] ^= 0x01;
+    TestDeflate(corrupt, bytes_l);
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_CHECKSUM, TestImport(corrupt));
+
+    bytes_l.assign(bytes.begin(), bytes.end() - 1);
+    TestDeflate(corrupt, bytes_l);
+    ASSERT_EQ(rai::ErrorCode::SNAPSHOT_CHECKSUM, TestImport(corrupt));
+}
+
+TEST(ledger, callback_outbox)
+{
+    TestLedger test;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, test.error_code_);
+    rai::Ledger& ledger = test.ledger_;
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, ledger, true);
+        ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+
+        uint64_t sequence = 0;
+        ASSERT_TRUE(ledger.CallbackFirst(transaction, sequence));
+        ASSERT_TRUE(ledger.CallbackAckedGet(transaction, sequence));
+        ASSERT_FALSE(ledger.CallbackNext(transaction, sequence));
+        ASSERT_EQ(1, sequence);
+
+        for (uint64_t i = 1; i <= 5; ++i)
+        {
+            ASSERT_FALSE(
+                ledger.CallbackPut(transaction, i, std::to_string(i)));
+        }
+        // Sequences only grow
+        ASSERT_TRUE(ledger.CallbackPut(transaction, 3, "3"));
+        ASSERT_FALSE(ledger.CallbackNext(transaction, sequence));
+        ASSERT_EQ(6, sequence);
+        ASSERT_FALSE(ledger.CallbackFirst(transaction, sequence));
+        ASSERT_EQ(1, sequence);
+
+        std::vector<std::pair<uint64_t, std::string>> notifies;
+        ASSERT_FALSE(ledger.CallbackGet(transaction, 2, 2, notifies));
+        ASSERT_EQ(2, notifies.size());
+        ASSERT_EQ(2, notifies[0].first);
+        ASSERT_EQ("2", notifies[0].second);
+        ASSERT_EQ(3, notifies[1].first);
+        ASSERT_EQ("3", notifies[1].second);
+        notifies.clear();
+        ASSERT_FALSE(ledger.CallbackGet(transaction, 4, 10, notifies));
+        ASSERT_EQ(2, notifies.size());
+        ASSERT_EQ(5, notifies.back().first);
+        notifies.clear();
+        ASSERT_FALSE(ledger.CallbackGet(transaction, 6, 10, notifies));
+        ASSERT_TRUE(notifies.empty());
+
+        ASSERT_FALSE(ledger.CallbackAckedPut(transaction, 3));
+        ASSERT_FALSE(ledger.CallbackAckedGet(transaction, sequence));
+        ASSERT_EQ(3, sequence);
+        ASSERT_FALSE(ledger.CallbackNext(transaction, sequence));
+        ASSERT_EQ(6, sequence);
+
+        // Pruning stops at <max> and at the first sequence kept
+        size_t pruned = 0;
+        ASSERT_FALSE(ledger.CallbackPrune(transaction, 3, 1, pruned));
+        ASSERT_EQ(1, pruned);
+        ASSERT_FALSE(ledger.CallbackPrune(transaction, 3, 10, pruned));
+        ASSERT_EQ(2, pruned);
+        ASSERT_FALSE(ledger.CallbackPrune(transaction, 3, 10, pruned));
+        ASSERT_EQ(2, pruned);
+        ASSERT_FALSE(ledger.CallbackFirst(transaction, sequence));
+        ASSERT_EQ(3, sequence);
+    }
+
+    // Committed, and read only transactions can't write
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, ledger, false);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    uint64_t sequence = 0;
+    ASSERT_FALSE(ledger.CallbackAckedGet(transaction, sequence));
+    ASSERT_EQ(3, sequence);
+    std::vector<std::pair<uint64_t, std::string>> notifies;
+    ASSERT_FALSE(ledger.CallbackGet(transaction, 0, 10, notifies));
+    ASSERT_EQ(3, notifies.size());
+    ASSERT_EQ(3, notifies.front().first);
+    ASSERT_TRUE(ledger.CallbackPut(transaction, 6, "6"));
+    ASSERT_TRUE(ledger.CallbackAckedPut(transaction, 4));
+    size_t pruned = 0;
+    ASSERT_TRUE(ledger.CallbackPrune(transaction, 5, 10, pruned));
+    ASSERT_EQ(0, pruned);
+}
+
+namespace
+{
+// What receiving and rewarding the first <count> sends leaves behind
+void TestSettle(rai::Ledger& ledger,
+                const std::vector<std::shared_ptr<rai::Block>>& blocks,
+                size_t count)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, ledger, true);
+    EXPECT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const rai::Block& block = *blocks[i];
+        EXPECT_FALSE(
+            ledger.ReceivableInfoDel(transaction, block.Link(), block.Hash()));
+        EXPECT_FALSE(ledger.RewardableInfoDel(
+            transaction, block.Representative(), block.Hash()));
+    }
+}
+
+size_t TestPrune(rai::Ledger& ledger, const rai::Account& account,
+                 uint64_t depth)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, ledger, true);
+    EXPECT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    size_t pruned = 0;
+    EXPECT_EQ(rai::ErrorCode::SUCCESS,
+              ledger.PruneAccount(transaction, account, depth, 1000, pruned));
+    return pruned;
+}
+}  // namespace
+
+TEST(ledger, prune_receivable)
+{
+    TestLedger test;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, test.error_code_);
+    auto blocks = TestPopulate(test.ledger_, 5);
+    rai::Account account = blocks.front()->Account();
+
+    // Every send is still receivable, nothing can go
+    ASSERT_EQ(0, TestPrune(test.ledger_, account, 0));
+
+    TestSettle(test.ledger_, blocks, 2);
+    ASSERT_EQ(2, TestPrune(test.ledger_, account, 0));
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, test.ledger_, true);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::AccountInfo info;
+    ASSERT_FALSE(test.ledger_.AccountInfoGet(transaction, account, info));
+    ASSERT_EQ(2, info.tail_height_);
+    ASSERT_EQ(blocks[2]->Hash(), info.tail_);
+    ASSERT_FALSE(test.ledger_.BlockExists(transaction, blocks[1]->Hash()));
+
+    // The pending send can still be received
+    rai::Genesis genesis;
+    rai::Account destination = genesis.block_->Account();
+    rai::ReceivableInfo receivable;
+    ASSERT_FALSE(test.ledger_.ReceivableInfoGet(
+        transaction, destination, blocks[2]->Hash(), receivable));
+    std::shared_ptr<rai::Block> source(nullptr);
+    ASSERT_FALSE(
+        test.ledger_.BlockGet(transaction, blocks[2]->Hash(), source));
+    ASSERT_EQ(receivable.source_, source->Account());
+    ASSERT_FALSE(test.ledger_.ReceivableInfoDel(transaction, destination,
+                                                blocks[2]->Hash()));
+}
+
+TEST(ledger, prune_idempotent)
+{
+    TestLedger test;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, test.error_code_);
+    auto blocks = TestPopulate(test.ledger_, 6);
+    rai::Account account = blocks.front()->Account();
+    TestSettle(test.ledger_, blocks, blocks.size());
+
+    ASSERT_EQ(3, TestPrune(test.ledger_, account, 2));
+    ASSERT_EQ(0, TestPrune(test.ledger_, account, 2));
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, test.ledger_, false);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::AccountInfo info;
+    ASSERT_FALSE(test.ledger_.AccountInfoGet(transaction, account, info));
+    ASSERT_EQ(3, info.tail_height_);
+    ASSERT_EQ(blocks[3]->Hash(), info.tail_);
+    ASSERT_EQ(5, info.head_height_);
+    size_t count = 0;
+    ASSERT_FALSE(test.ledger_.BlockCount(transaction, count));
+    ASSERT_EQ(4, count);
+}
+
+TEST(ledger, prune_head)
+{
+    TestLedger test;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, test.error_code_);
+    auto blocks = TestPopulate(test.ledger_, 4);
+    rai::Account account = blocks.front()->Account();
+    TestSettle(test.ledger_, blocks, blocks.size());
+
+    ASSERT_EQ(3, TestPrune(test.ledger_, account, 0));
+    ASSERT_EQ(0, TestPrune(test.ledger_, account, 0));
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, test.ledger_, false);
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, error_code);
+    rai::AccountInfo info;
+    ASSERT_FALSE(test.ledger_.AccountInfoGet(transaction, account, info));
+    ASSERT_EQ(info.head_, info.tail_);
+    ASSERT_EQ(info.head_height_, info.tail_height_);
+    ASSERT_TRUE(test.ledger_.BlockExists(transaction, info.head_));
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <rai/node/message.hpp>
+#include <vector>
+
+namespace
+{
+rai::ConfirmBatchMessage TestConfirmBatch(size_t count)
+{
+    rai::RawKey raw_key;
+    raw_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    rai::PublicKey public_key;
+    public_key.DecodeHex(
+        "B0311EA55708D6A53C75CDBF88300259C6D018522FE3D4D0A242E431F9E8B6D0");
+
+    std::vector<rai::ConfirmEntry> entries;
+    for (size_t i = 0; i < count; ++i)
+    {
+        entries.emplace_back(rai::Account(i + 1), i + 10, 1541128318 + i,
+                             rai::BlockHash(i + 100));
+    }
+    rai::ConfirmBatchMessage message(public_key, entries);
+    message.SetSignature(
+        rai::SignMessage(raw_key, public_key, message.Hash()));
+    return message;
+}
+
+rai::ErrorCode TestParse(const std::vector<uint8_t>& bytes,
+                         std::unique_ptr<rai::ConfirmBatchMessage>& message)
+{
+    rai::BufferStream stream(bytes.data(), bytes.size());
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::MessageHeader header(error_code, stream);
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        return error_code;
+    }
+    message.reset(new rai::ConfirmBatchMessage(error_code, stream, header));
+    return error_code;
+}
+}  // namespace
+
+TEST(ConfirmBatchMessage, serialize)
+{
+    rai::ConfirmBatchMessage message = TestConfirmBatch(3);
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        message.Serialize(stream);
+    }
+    // header + representative + signature + entries
+    ASSERT_EQ(8 + 32 + 64 + 3 * (32 + 8 + 8 + 32), bytes.size());
+    ASSERT_EQ(static_cast<uint8_t>(rai::MessageType::CONFIRM_BATCH), bytes[4]);
+    ASSERT_EQ(0, bytes[6]);  // extension: entry count
+    ASSERT_EQ(3, bytes[7]);
+
+    std::unique_ptr<rai::ConfirmBatchMessage> message2;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, TestParse(bytes, message2));
+    ASSERT_EQ(message.representative_, message2->representative_);
+    ASSERT_EQ(message.signature_, message2->signature_);
+    ASSERT_EQ(message.Hash(), message2->Hash());
+    ASSERT_EQ(3, message2->entries_.size());
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const rai::ConfirmEntry& entry = message.entries_[i];
+        const rai::ConfirmEntry& entry2 = message2->entries_[i];
+        ASSERT_EQ(entry.account_, entry2.account_);
+        ASSERT_EQ(entry.height_, entry2.height_);
+        ASSERT_EQ(entry.timestamp_, entry2.timestamp_);
+        ASSERT_EQ(entry.hash_, entry2.hash_);
+    }
+
+    std::vector<uint8_t> bytes2;
+    {
+        rai::VectorStream stream(bytes2);
+        message2->Serialize(stream);
+    }
+    ASSERT_EQ(bytes, bytes2);
+}
+
+TEST(ConfirmBatchMessage, deserialize_error)
+{
+    rai::ConfirmBatchMessage message =
+        TestConfirmBatch(rai::ConfirmBatchMessage::MAX_ENTRIES);
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        message.Serialize(stream);
+    }
+    std::unique_ptr<rai::ConfirmBatchMessage> message2;
+    ASSERT_EQ(rai::ErrorCode::SUCCESS, TestParse(bytes, message2));
+
+    // The signature covers every entry
+    std::vector<uint8_t> tampered(bytes);
+    tampered.back() ^= 1;
+    ASSERT_EQ(rai::ErrorCode::MESSAGE_CONFIRM_BATCH_SIGNATURE,
+              TestParse(tampered, message2));
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+    ASSERT_EQ(rai::ErrorCode::STREAM, TestParse(truncated, message2));
+
+    std::vector<uint8_t> empty(bytes);
+    empty[6] = 0;
+    empty[7] = 0;
+    ASSERT_EQ(rai::ErrorCode::MESSAGE_CONFIRM_BATCH_SIZE,
+              TestParse(empty, message2));
+
+    std::vector<uint8_t> oversize(bytes);
+    oversize[7] = rai::ConfirmBatchMessage::MAX_ENTRIES + 1;
+    ASSERT_EQ(rai::ErrorCode::MESSAGE_CONFIRM_BATCH_SIZE,
+              TestParse(oversize, message2));
+}
@@ -112,6 +112,68 @@ TEST(uint128_union, arithmetic_operator)
     ASSERT_EQ(rai::uint128_t(-1), result.Number());
 }
 
+TEST(uint128_union, checked_arithmetic)
+{
+    rai::uint128_t number("0x34F0A37AAD20F4A260F0A5B3CB3D7FB5");
+    rai::uint128_union value(number);
+    rai::uint128_union max(rai::uint128_t(-1));
+
+    bool error = value.CheckedAdd(1);
+    ASSERT_EQ(false, error);
+    ASSERT_EQ(number + 1, value.Number());
+    error = value.CheckedSub(2);
+    ASSERT_EQ(false, error);
+    ASSERT_EQ(number - 1, value.Number());
+
+    rai::uint128_union result = max;
+    error = result.CheckedAdd(1);
+    ASSERT_EQ(true, error);
+    ASSERT_EQ(max, result);
+    result = rai::uint128_union(rai::uint128_t("0xFFFFFFFFFFFFFFFF"));
+    error = result.CheckedAdd(1);
+    ASSERT_EQ(false, error);
+    ASSERT_EQ(rai::uint128_t("0x10000000000000000"), result.Number());
+
+    result = rai::uint128_t("0x10000000000000000");
+    error = result.CheckedSub(1);
+    ASSERT_EQ(false, error);
+    ASSERT_EQ(rai::uint128_t("0xFFFFFFFFFFFFFFFF"), result.Number());
+    error = result.CheckedSub(max);
+    ASSERT_EQ(true, error);
+    ASSERT_EQ(rai::uint128_t("0xFFFFFFFFFFFFFFFF"), result.Number());
+}
+
+TEST(uint128_union, mul_div)
+{
+    rai::uint128_t number("0x34F0A37AAD20F4A260F0A5B3CB3D7FB5");
+    rai::uint128_union value(number);
+    rai::uint128_union result;
+
+    for (uint64_t factor = 0; factor <= 100; ++factor)
+    {
+        bool error = value.MulDiv(factor, 100, result);
+        ASSERT_EQ(false, error);
+        rai::uint256_t expect(number);
+        expect = expect * factor / 100;
+        ASSERT_EQ(static_cast<rai::uint128_t>(expect), result.Number());
+    }
+
+    bool error = value.MulDiv(3, 0, result);
+    ASSERT_EQ(true, error);
+    error = value.MulDiv(5, 1, result);
+    ASSERT_EQ(true, error);
+
+    rai::uint128_union max(rai::uint128_t(-1));
+    error = max.MulDiv(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, result);
+    ASSERT_EQ(false, error);
+    ASSERT_EQ(max, result);
+    error = max.MulDiv(7, 8, result);
+    ASSERT_EQ(false, error);
+    rai::uint256_t expect(max.Number());
+    expect = expect * 7 / 8;
+    ASSERT_EQ(static_cast<rai::uint128_t>(expect), result.Number());
+}
+
 TEST(uint128_union, hex)
 {
     bool ret;
@@ -599,4 +661,33 @@ TEST(AccountParser, parse)
     rai::AccountParser parser6(
         "Rai_3e3j5tkog48pnny9dmfzj1r16pg8t1e76dz5tmac6iq689wyjfpiij4txtd0");
     ASSERT_EQ(true, parser6.Error());
-}
\ No newline at end of file
+}
+
+TEST(SignatureCache, validate)
+{
+    rai::RawKey private_key;
+    bool error = private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    ASSERT_EQ(false, error);
+    rai::PublicKey public_key = rai::GeneratePublicKey(private_key.data_);
+    rai::uint256_union message(12345);
+    rai::Signature signature =
+        rai::SignMessage(private_key, public_key, message);
+
+    rai::SignatureCache cache;
+    ASSERT_EQ(false, cache.Validate(public_key, message, signature));
+    ASSERT_EQ(0, cache.Hits());
+    ASSERT_EQ(1, cache.Misses());
+    ASSERT_EQ(false, cache.Validate(public_key, message, signature));
+    ASSERT_EQ(1, cache.Hits());
+
+    rai::Signature bad(signature);
+    bad.bytes[0] ^= 1;
+    ASSERT_EQ(true, cache.Validate(public_key, message, bad));
+    ASSERT_EQ(true, cache.Validate(public_key, message, bad));
+    ASSERT_EQ(1, cache.Hits());
+    ASSERT_EQ(3, cache.Misses());
+
+    rai::uint256_union other(12346);
+    ASSERT_EQ(true, cache.Validate(public_key, other, signature));
+}
@@ -0,0 +1,163 @@
+#include <rai/secure/rpc.hpp>
+#include <string>
+#include <gtest/gtest.h>
+#include <rai/common/json.hpp>
+
+namespace
+{
+class TestRpcHandler : public rai::RpcHandler
+{
+public:
+    TestRpcHandler(rai::Rpc& rpc, const std::string& body,
+                   const std::function<void(const rai::Ptree&)>& send_response)
+        : rai::RpcHandler(rpc, body, boost::asio::ip::address_v4::loopback(),
+                          send_response)
+    {
+    }
+
+    void ProcessImpl() override
+    {
+        Call_(Actions());
+    }
+
+    void Batch()
+    {
+        Batch_<TestRpcHandler>(
+            Actions(),
+            [this](
+                const std::function<void(const rai::Ptree&)>& send_response) {
+                return std::unique_ptr<TestRpcHandler>(
+                    new TestRpcHandler(rpc_, "", send_response));
+            });
+    }
+
+    void Echo()
+    {
+        response_.put("value", request_.get<std::string>("value"));
+    }
+
+    void Write()
+    {
+        response_.put("success", "");
+    }
+
+    static const std::unordered_map<std::string,
+                                    rai::RpcAction<TestRpcHandler>>&
+    Actions()
+    {
+        // action: {handler, control, local, read only}
+        static const std::unordered_map<std::string,
+                                        rai::RpcAction<TestRpcHandler>>
+            actions = {
+                {"batch", {&TestRpcHandler::Batch, false, false, false}},
+                {"echo", {&TestRpcHandler::Echo, false, false, true}},
+                {"write", {&TestRpcHandler::Write, false, false, false}}
+            };
+        return actions;
+    }
+};
+
+rai::Ptree Request(rai::Rpc& rpc, const rai::Ptree& request)
+{
+    rai::Ptree result;
+    TestRpcHandler handler(
+        rpc, rai::PtreeToJson(request),
+        [&result](const rai::Ptree& response) { result = response; });
+    handler.Process();
+    return result;
+}
+
+rai::Ptree EchoRequest(const std::string& value)
+{
+    rai::Ptree request;
+    request.put("action", "echo");
+    request.put("value", value);
+    return request;
+}
+}  // namespace
+
+TEST(rpc, batch)
+{
+    boost::asio::io_service service;
+    rai::RpcConfig config{boost::asio::ip::address_v4::loopback(), 0, false,
+                          {}, 1, 1};
+    rai::Rpc rpc(service, config, rai::RpcHandlerMaker());
+
+    rai::Ptree requests;
+    requests.push_back(std::make_pair("", EchoRequest("first")));
+    rai::Ptree write;
+    write.put("action", "write");
+    requests.push_back(std::make_pair("", write));
+    rai::Ptree nested;
+    nested.put("action", "batch");
+    requests.push_back(std::make_pair("", nested));
+    rai::Ptree unknown;
+    unknown.put("action", "unknown");
+    requests.push_back(std::make_pair("", unknown));
+    requests.push_back(std::make_pair("", rai::Ptree()));
+    requests.push_back(std::make_pair("", EchoRequest("last")));
+
+    rai::Ptree request;
+    request.put("action", "batch");
+    request.put_child("requests", requests);
+    rai::Ptree response = Request(rpc, request);
+    ASSERT_EQ(0, response.count("error"));
+    EXPECT_EQ("batch", response.get<std::string>("ack"));
+
+    auto responses = response.get_child("responses");
+    ASSERT_EQ(6, responses.size());
+    auto i = responses.begin();
+    EXPECT_EQ("first", i->second.get<std::string>("value"));
+    EXPECT_EQ("echo", i->second.get<std::string>("ack"));
+    ++i;
+    EXPECT_EQ(static_cast<uint32_t>(rai::ErrorCode::RPC_BATCH_ACTION),
+              i->second.get<uint32_t>("error_code"));
+    EXPECT_EQ("write", i->second.get<std::string>("ack"));
+    ++i;
+    EXPECT_EQ(static_cast<uint32_t>(rai::ErrorCode::RPC_BATCH_ACTION),
+              i->second.get<uint32_t>("error_code"));
+    ++i;
+    EXPECT_EQ(static_cast<uint32_t>(rai::ErrorCode::RPC_BATCH_ACTION),
+              i->second.get<uint32_t>("error_code"));
+    ++i;
+    EXPECT_EQ(static_cast<uint32_t>(rai::ErrorCode::RPC_MISS_FIELD_ACTION),
+              i->second.get<uint32_t>("error_code"));
+    ++i;
+    EXPECT_EQ("last", i->second.get<std::string>("value"));
+}
+
+TEST(rpc, batch_limits)
+{
+    boost::asio::io_service service;
+    rai::RpcConfig config{boost::asio::ip::address_v4::loopback(), 0, false,
+                          {}, 1, 1};
+    rai::Rpc rpc(service, config, rai::RpcHandlerMaker());
+
+    rai::Ptree request;
+    request.put("action", "batch");
+    rai::Ptree response = Request(rpc, request);
+    EXPECT_EQ(static_cast<uint32_t>(rai::ErrorCode::RPC_MISS_FIELD_REQUESTS),
+              response.get<uint32_t>("error_code"));
+
+    rai::Ptree requests;
+    for (size_t i = 0; i < rai::RpcHandler::MAX_BATCH_REQUESTS; ++i)
+    {
+        requests.push_back(
+            std::make_pair("", EchoRequest(std::to_string(i))));
+    }
+    request.put_child("requests", requests);
+    response = Request(rpc, request);
+    ASSERT_EQ(0, response.count("error"));
+    auto responses = response.get_child("responses");
+    ASSERT_EQ(rai::RpcHandler::MAX_BATCH_REQUESTS, responses.size());
+    EXPECT_EQ(std::to_string(rai::RpcHandler::MAX_BATCH_REQUESTS - 1),
+              responses.back().second.get<std::string>("value"));
+
+    requests.push_back(std::make_pair("", EchoRequest("over")));
+    request.put_child("requests", requests);
+    response = Request(rpc, request);
+    EXPECT_EQ(
+        static_cast<uint32_t>(rai::ErrorCode::RPC_INVALID_FIELD_REQUESTS),
+        response.get<uint32_t>("error_code"));
+    EXPECT_EQ(0, response.count("responses"));
+}
@@ -17,4 +17,39 @@ TEST(secure, DeriveKey)
     rai::uint256_union expect;
     expect.DecodeHex("40F2F2E07B1DFB9C2DFC1132AFCD5EF697CA2FF24E403A0CF0091E25BD6A19DB");
     ASSERT_EQ(raw_key.data_, expect);
-}
\ No newline at end of file
+}
+TEST(secure, Signer)
+{
+    rai::RawKey private_key;
+    bool error = private_key.data_.DecodeHex(
+        "34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+    ASSERT_EQ(false, error);
+    rai::PublicKey public_key = rai::GeneratePublicKey(private_key.data_);
+    rai::Fan fan(private_key.data_, rai::Fan::FAN_OUT);
+
+    std::vector<rai::uint256_union> messages;
+    for (uint64_t i = 0; i < 8; ++i)
+    {
+        messages.push_back(rai::uint256_union(i * 0x9E3779B97F4A7C15));
+    }
+
+    // Cached and uncached keys sign alike
+    for (uint64_t window : {0, 60})
+    {
+        rai::Signer signer(fan, window);
+        std::vector<rai::Signature> signatures = signer.Sign(messages);
+        ASSERT_EQ(messages.size(), signatures.size());
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            rai::Signature expect =
+                rai::SignMessage(private_key, public_key, messages[i]);
+            ASSERT_EQ(expect, signer.Sign(messages[i]));
+            ASSERT_EQ(expect, signatures[i]);
+        }
+
+        signer.Wipe();
+        ASSERT_EQ(rai::SignMessage(private_key, public_key, messages[0]),
+                  signer.Sign(messages[0]));
+        ASSERT_TRUE(signer.Sign(std::vector<rai::uint256_union>()).empty());
+    }
+}
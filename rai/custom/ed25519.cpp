@@ -14,20 +14,18 @@ void ed25519_randombytes_unsafe(void* out, size_t outlen)
 
 void ed25519_hash_init(ed25519_hash_context* ctx)
 {
-    ctx->blake2 = new blake2b_state;
-    blake2b_init(reinterpret_cast<blake2b_state*>(ctx->blake2), 64);
+    blake2b_init(&ctx->blake2, 64);
 }
 
 void ed25519_hash_update(ed25519_hash_context* ctx, uint8_t const* in,
                          size_t inlen)
 {
-    blake2b_update(reinterpret_cast<blake2b_state*>(ctx->blake2), in, inlen);
+    blake2b_update(&ctx->blake2, in, inlen);
 }
 
 void ed25519_hash_final(ed25519_hash_context* ctx, uint8_t* out)
 {
-    blake2b_final(reinterpret_cast<blake2b_state*>(ctx->blake2), out, 64);
-    delete reinterpret_cast<blake2b_state*>(ctx->blake2);
+    blake2b_final(&ctx->blake2, out, 64);
 }
 
 void ed25519_hash(uint8_t* out, uint8_t const* in, size_t inlen)
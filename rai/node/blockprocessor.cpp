@@ -78,8 +78,230 @@ rai::BlockForced::BlockForced(uint64_t operation,
 {
 }
 
+size_t constexpr rai::BlockEventBus::DEFAULT_CAPACITY;
+size_t constexpr rai::BlockEventBus::DEFAULT_MAX_SPILL;
+size_t constexpr rai::BlockEventBus::MAX_BATCH;
+
+rai::BlockEventConsumer::BlockEventConsumer(
+    const std::string& name, const rai::BlockEventHandler& handler,
+    bool lossless)
+    : name_(name),
+      handler_(handler),
+      lossless_(lossless),
+      next_(0),
+      max_lag_(0),
+      processed_(0),
+      skipped_(0),
+      spilled_(0)
+{
+}
+
+rai::BlockEventBus::BlockEventBus(size_t capacity, size_t max_spill)
+    : ring_(capacity),
+      max_spill_(max_spill),
+      head_(0),
+      started_(false),
+      stopped_(false)
+{
+}
+
+rai::BlockEventBus::~BlockEventBus()
+{
+    Stop();
+}
+
+void rai::BlockEventBus::Subscribe(const std::string& name,
+                                   const rai::BlockEventHandler& handler,
+                                   bool lossless)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (started_)
+    {
+        return;
+    }
+    consumers_.emplace_back(
+        new rai::BlockEventConsumer(name, handler, lossless));
+}
+
+void rai::BlockEventBus::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (started_ || stopped_)
+    {
+        return;
+    }
+    started_ = true;
+    for (auto& i : consumers_)
+    {
+        rai::BlockEventConsumer& consumer = *i;
+        consumer.thread_ = std::thread([this, &consumer]() { Run_(consumer); });
+    }
+}
+
+void rai::BlockEventBus::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            return;
+        }
+        stopped_ = true;
+    }
+    condition_.notify_all();
+    for (auto& i : consumers_)
+    {
+        if (i->thread_.joinable())
+        {
+            i->thread_.join();
+        }
+    }
+}
+
+void rai::BlockEventBus::Publish(const rai::BlockProcessResult& result,
+                                 const std::shared_ptr<rai::Block>& block,
+                                 const rai::Account& root)
+{
+    rai::BlockEvent event{rai::BlockEventType::PROCESS, result, block, root,
+                          false, nullptr};
+    Publish_(event);
+}
+
+void rai::BlockEventBus::Publish(bool add,
+                                 const std::shared_ptr<rai::Block>& first,
+                                 const std::shared_ptr<rai::Block>& second)
+{
+    rai::BlockProcessResult result{rai::BlockOperation::INVALID,
+                                   rai::ErrorCode::SUCCESS, 0};
+    rai::BlockEvent event{rai::BlockEventType::FORK, result, first,
+                          rai::Account(), add, second};
+    Publish_(event);
+}
+
+uint64_t rai::BlockEventBus::Head() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return head_;
+}
+
+std::vector<rai::BlockEventConsumerStat> rai::BlockEventBus::Stats() const
+{
+    std::vector<rai::BlockEventConsumerStat> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& i : consumers_)
+    {
+        result.push_back(rai::BlockEventConsumerStat{
+            i->name_, head_ - i->next_ + i->spill_.size(), i->max_lag_,
+            i->processed_, i->skipped_, i->spilled_, i->spill_.size()});
+    }
+    return result;
+}
+
+void rai::BlockEventBus::Publish_(rai::BlockEvent& event)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            return;
+        }
+        rai::BlockEvent& slot = ring_[head_ % ring_.size()];
+        if (head_ >= ring_.size())
+        {
+            uint64_t overwritten = head_ - ring_.size();
+            for (auto& i : consumers_)
+            {
+                if (!i->lossless_ || i->next_ != overwritten)
+                {
+                    continue;
+                }
+
+                if (i->spill_.size() >= max_spill_)
+                {
+                    // give up on the backlog, the consumer rebuilds its state
+                    i->skipped_ += i->spill_.size() + 1;
+                    i->spill_.clear();
+                    rai::BlockProcessResult result{
+                        rai::BlockOperation::INVALID, rai::ErrorCode::SUCCESS,
+                        0};
+                    i->spill_.push_back(
+                        rai::BlockEvent{rai::BlockEventType::RESYNC, result,
+                                        nullptr, rai::Account(), false,
+                                        nullptr});
+                    rai::Stats::Add(
+                        rai::ErrorCode::BLOCK_PROCESS_EVENTS_RESYNC,
+                        i->name_);
+                }
+                else
+                {
+                    i->spill_.push_back(slot);
+                    ++i->spilled_;
+                }
+                ++i->next_;
+            }
+        }
+        slot = std::move(event);
+        ++head_;
+    }
+    condition_.notify_all();
+}
+
+void rai::BlockEventBus::Run_(rai::BlockEventConsumer& consumer)
+{
+    std::vector<rai::BlockEvent> batch;
+    batch.reserve(rai::BlockEventBus::MAX_BATCH);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_)
+    {
+        if (consumer.next_ == head_ && consumer.spill_.empty())
+        {
+            condition_.wait(lock);
+            continue;
+        }
+
+        if (head_ - consumer.next_ > ring_.size())
+        {
+            // overwritten while the consumer was busy
+            consumer.skipped_ += head_ - consumer.next_ - ring_.size();
+            rai::Stats::Add(rai::ErrorCode::BLOCK_PROCESS_EVENTS_SKIPPED,
+                            consumer.name_);
+            consumer.next_ = head_ - ring_.size();
+        }
+        uint64_t lag = head_ - consumer.next_ + consumer.spill_.size();
+        if (lag > consumer.max_lag_)
+        {
+            consumer.max_lag_ = lag;
+        }
+
+        while (!consumer.spill_.empty()
+               && batch.size() < rai::BlockEventBus::MAX_BATCH)
+        {
+            batch.push_back(std::move(consumer.spill_.front()));
+            consumer.spill_.pop_front();
+        }
+        while (consumer.next_ != head_
+               && batch.size() < rai::BlockEventBus::MAX_BATCH)
+        {
+            batch.push_back(ring_[consumer.next_ % ring_.size()]);
+            ++consumer.next_;
+        }
+
+        lock.unlock();
+        for (const auto& i : batch)
+        {
+            consumer.handler_(i);
+        }
+        consumer.processed_ += batch.size();
+        batch.clear();
+        lock.lock();
+    }
+}
+
 rai::BlockProcessor::BlockProcessor(rai::Node& node)
-    : node_(node),
+    : events_(rai::BlockEventBus::DEFAULT_CAPACITY,
+              rai::BlockEventBus::DEFAULT_MAX_SPILL),
+      node_(node),
       ledger_(node.ledger_),
       operation_(static_cast<uint64_t>(rai::BlockOperation::DYNAMIC_BEGIN)),
       stopped_(false),
@@ -111,8 +333,7 @@ void rai::BlockProcessor::Add(const std::shared_ptr<rai::Block>& block)
         auto it = blocks_.rbegin();
         rai::BlockProcessResult result{rai::BlockOperation::DROP,
                                        rai::ErrorCode::SUCCESS, 0};
-        block_observer_(result, it->block_);
-        node_.dumpers_.block_.Dump(result, it->block_);
+        events_.Publish(result, it->block_);
         blocks_.erase((++it).base());
     }
 
@@ -214,17 +435,37 @@ void rai::BlockProcessor::Stop()
     {
         thread_.join();
     }
+    events_.Stop();
 }
 
 void rai::BlockProcessor::Status(rai::Ptree& status) const
 {
     status.put("operation_id", std::to_string(operation_));
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status.put("blocks_count", std::to_string(blocks_.size()));
+        status.put("forks_count", std::to_string(blocks_fork_.size()));
+        status.put("forced_count", std::to_string(blocks_forced_.size()));
+    }
 
-    status.put("blocks_count", std::to_string(blocks_.size()));
-    status.put("forks_count", std::to_string(blocks_fork_.size()));
-    status.put("forced_count", std::to_string(blocks_forced_.size()));
+    rai::Ptree events;
+    events.put("head", std::to_string(events_.Head()));
+    rai::Ptree consumers;
+    for (const auto& i : events_.Stats())
+    {
+        rai::Ptree entry;
+        entry.put("name", i.name_);
+        entry.put("lag", std::to_string(i.lag_));
+        entry.put("max_lag", std::to_string(i.max_lag_));
+        entry.put("processed", std::to_string(i.processed_));
+        entry.put("skipped", std::to_string(i.skipped_));
+        entry.put("spilled", std::to_string(i.spilled_));
+        entry.put("spill", std::to_string(i.spill_));
+        consumers.push_back(std::make_pair("", entry));
+    }
+    events.put_child("consumers", consumers);
+    status.put_child("events", events);
 }
 
 uint32_t rai::BlockProcessor::Priority_(
@@ -280,8 +521,7 @@ void rai::BlockProcessor::ProcessBlock_(const std::shared_ptr<rai::Block>& block
             rai::Stats::Add(error_code, "BlockProcessor::ProcessBlock_");
             rai::BlockProcessResult result{rai::BlockOperation::DROP,
                                            error_code, 0};
-            block_observer_(result, block);
-            node_.dumpers_.block_.Dump(result, block);
+            events_.Publish(result, block);
             return;
         }
 
@@ -387,8 +627,7 @@ void rai::BlockProcessor::ProcessBlock_(const std::shared_ptr<rai::Block>& block
     }
 
     rai::BlockProcessResult result{rai::BlockOperation::APPEND, error_code, 0};
-    block_observer_(result, block);
-    node_.dumpers_.block_.Dump(result, block);
+    events_.Publish(result, block);
 }
 
 void rai::BlockProcessor::ProcessBlockFork_(
@@ -516,18 +755,15 @@ void rai::BlockProcessor::ProcessBlockFork_(
         broadcast = true;
     } while(0);
 
-    if (del && fork_observer_)
+    if (del)
     {
-        fork_observer_(false, del_first, del_second);
+        events_.Publish(false, del_first, del_second);
     }
 
     if (broadcast)
     {
         node_.BroadcastFork(first, second);
-        if (fork_observer_)
-        {
-            fork_observer_(true, first, second);
-        }
+        events_.Publish(true, first, second);
     }
 
     if (election)
@@ -630,9 +866,7 @@ void rai::BlockProcessor::ProcessBlockDynamic_(uint64_t operation)
 
         rai::BlockProcessResult result{top.operation_, error_code,
                                        last_confirm_height};
-        block_observer_(result, top.block_);
-        node_.dumpers_.block_.Dump(result, top.block_,
-                                   roots_dynamic_[operation]);
+        events_.Publish(result, top.block_, roots_dynamic_[operation]);
 
         if (error_code == rai::ErrorCode::SUCCESS)
         {
@@ -925,6 +1159,7 @@ rai::ErrorCode rai::BlockProcessor::ProcessBlockDynamicConfirm_(
         }
         case rai::ErrorCode::BLOCK_PROCESS_LEDGER_INCONSISTENT:
         case rai::ErrorCode::BLOCK_PROCESS_LEDGER_ACCOUNT_INFO_PUT:
+        case rai::ErrorCode::BLOCK_PROCESS_LEDGER_CALLBACK_PUT:
         {
             transaction.Abort();
             return error_code;
@@ -2155,6 +2390,10 @@ rai::ErrorCode rai::BlockProcessor::ConfirmBlock_(
             ledger_.AccountInfoPut(transaction, block->Account(), account_info);
         IF_ERROR_RETURN(error,
                         rai::ErrorCode::BLOCK_PROCESS_LEDGER_ACCOUNT_INFO_PUT);
+
+        error = node_.subscriptions_.BlockConfirmOutbox(transaction, *block);
+        IF_ERROR_RETURN(error,
+                        rai::ErrorCode::BLOCK_PROCESS_LEDGER_CALLBACK_PUT);
     }
 
     return rai::ErrorCode::SUCCESS;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <condition_variable>
+#include <deque>
 #include <unordered_set>
 #include <stack>
 #include <thread>
@@ -65,6 +67,105 @@ public:
     uint64_t last_confirm_height_;
 };
 
+enum class BlockEventType
+{
+    PROCESS = 0,
+    FORK    = 1,
+    // a lossless consumer's spill queue overflowed and the events before
+    // this one were dropped, state built from them must be rebuilt
+    RESYNC  = 2,
+};
+
+class BlockEvent
+{
+public:
+    rai::BlockEventType type_;
+    rai::BlockProcessResult result_;
+    std::shared_ptr<rai::Block> block_;
+    // dynamic operation root, for the dumper
+    rai::Account root_;
+    // fork events
+    bool add_;
+    std::shared_ptr<rai::Block> second_;
+};
+
+typedef std::function<void(const rai::BlockEvent&)> BlockEventHandler;
+
+class BlockEventConsumerStat
+{
+public:
+    std::string name_;
+    uint64_t lag_;
+    uint64_t max_lag_;
+    uint64_t processed_;
+    uint64_t skipped_;
+    uint64_t spilled_;
+    uint64_t spill_;
+};
+
+class BlockEventConsumer
+{
+public:
+    BlockEventConsumer(const std::string&, const rai::BlockEventHandler&,
+                       bool);
+
+    std::string name_;
+    rai::BlockEventHandler handler_;
+    bool lossless_;
+    // sequence of the next event to handle, guarded by the bus mutex
+    uint64_t next_;
+    uint64_t max_lag_;
+    // events overwritten in the ring before a lossless consumer handled
+    // them, older than those from next_, guarded by the bus mutex
+    std::deque<rai::BlockEvent> spill_;
+    std::atomic<uint64_t> processed_;
+    std::atomic<uint64_t> skipped_;
+    std::atomic<uint64_t> spilled_;
+    std::thread thread_;
+};
+
+// Ordered, bounded fan-out of block processing results. Publishing only
+// copies the event into a ring and never waits for consumers. Each consumer
+// drains the ring in order on its own thread; one that falls a full ring
+// behind skips the overwritten events instead of holding up the ledger
+// writer, unless it is lossless, then the events are moved to its spill
+// queue first. A spill queue holds at most max_spill events, past that it is
+// dropped and replaced by a RESYNC event.
+class BlockEventBus
+{
+public:
+    BlockEventBus(size_t, size_t);
+    ~BlockEventBus();
+    void Subscribe(const std::string&, const rai::BlockEventHandler&,
+                   bool = false);
+    void Start();
+    void Stop();
+    void Publish(const rai::BlockProcessResult&,
+                 const std::shared_ptr<rai::Block>&,
+                 const rai::Account& = rai::Account());
+    void Publish(bool, const std::shared_ptr<rai::Block>&,
+                 const std::shared_ptr<rai::Block>&);
+    uint64_t Head() const;
+    std::vector<rai::BlockEventConsumerStat> Stats() const;
+
+    static size_t constexpr DEFAULT_CAPACITY = 64 * 1024;
+    static size_t constexpr DEFAULT_MAX_SPILL = 256 * 1024;
+    static size_t constexpr MAX_BATCH = 256;
+
+private:
+    void Publish_(rai::BlockEvent&);
+    void Run_(rai::BlockEventConsumer&);
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::vector<rai::BlockEvent> ring_;
+    size_t max_spill_;
+    uint64_t head_;
+    bool started_;
+    bool stopped_;
+    std::vector<std::unique_ptr<rai::BlockEventConsumer>> consumers_;
+};
+
 class Node;
 class BlockProcessor
 {
@@ -111,12 +212,7 @@ public:
         std::shared_ptr<rai::Block> block_;
     };
 
-    std::function<void(const rai::BlockProcessResult&,
-                       const std::shared_ptr<rai::Block>&)>
-        block_observer_;
-    std::function<void(bool, const std::shared_ptr<rai::Block>&,
-                       const std::shared_ptr<rai::Block>&)>
-        fork_observer_;
+    rai::BlockEventBus events_;
 
 private:
     static uint32_t Priority_(const std::shared_ptr<rai::Block>&);
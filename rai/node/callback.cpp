@@ -0,0 +1,1008 @@
+#include <rai/node/callback.hpp>
+
+#include <rai/common/json.hpp>
+#include <rai/common/stat.hpp>
+
+uint32_t constexpr rai::CallbackConfig::DEFAULT_CONNECTIONS;
+uint32_t constexpr rai::CallbackConfig::DEFAULT_PIPELINE;
+uint32_t constexpr rai::CallbackConfig::DEFAULT_BATCH;
+uint32_t constexpr rai::CallbackConfig::DEFAULT_QUEUE_SIZE;
+uint32_t constexpr rai::CallbackConfig::DEFAULT_RETRIES;
+uint32_t constexpr rai::CallbackConfig::DEFAULT_DNS_TTL;
+uint64_t constexpr rai::CallbackConfig::DEFAULT_OUTBOX_RETAIN;
+std::chrono::seconds constexpr rai::CallbackDispatcher::RECONNECT_DELAY;
+size_t constexpr rai::CallbackOutbox::PRUNE_BATCH;
+
+rai::CallbackConfig::CallbackConfig()
+    : connections_(rai::CallbackConfig::DEFAULT_CONNECTIONS),
+      pipeline_(rai::CallbackConfig::DEFAULT_PIPELINE),
+      batch_(rai::CallbackConfig::DEFAULT_BATCH),
+      queue_size_(rai::CallbackConfig::DEFAULT_QUEUE_SIZE),
+      retries_(rai::CallbackConfig::DEFAULT_RETRIES),
+      dns_ttl_(rai::CallbackConfig::DEFAULT_DNS_TTL),
+      outbox_(false),
+      outbox_retain_(rai::CallbackConfig::DEFAULT_OUTBOX_RETAIN)
+{
+}
+
+rai::ErrorCode rai::CallbackConfig::DeserializeJson(bool& upgraded,
+                                                    rai::Ptree& ptree)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::JSON_CONFIG_CALLBACK;
+    try
+    {
+        connections_ = ptree.get<uint32_t>("connections");
+        pipeline_ = ptree.get<uint32_t>("pipeline");
+        batch_ = ptree.get<uint32_t>("batch");
+        queue_size_ = ptree.get<uint32_t>("queue_size");
+        retries_ = ptree.get<uint32_t>("retries");
+        dns_ttl_ = ptree.get<uint32_t>("dns_ttl");
+
+        auto outbox_o = ptree.get_optional<bool>("outbox");
+        if (outbox_o)
+        {
+            outbox_ = *outbox_o;
+        }
+
+        auto outbox_retain_o = ptree.get_optional<uint64_t>("outbox_retain");
+        if (outbox_retain_o)
+        {
+            outbox_retain_ = *outbox_retain_o;
+        }
+        if (connections_ == 0 || pipeline_ == 0 || batch_ == 0
+            || queue_size_ == 0)
+        {
+            return error_code;
+        }
+    }
+    catch (const std::exception&)
+    {
+        return error_code;
+    }
+    return rai::ErrorCode::SUCCESS;
+}
+
+void rai::CallbackConfig::SerializeJson(rai::Ptree& ptree) const
+{
+    ptree.put("connections", connections_);
+    ptree.put("pipeline", pipeline_);
+    ptree.put("batch", batch_);
+    ptree.put("queue_size", queue_size_);
+    ptree.put("retries", retries_);
+    ptree.put("dns_ttl", dns_ttl_);
+    ptree.put("outbox", outbox_);
+    ptree.put("outbox_retain", outbox_retain_);
+}
+
+rai::CallbackEvent::CallbackEvent(std::string&& body)
+    : body_(std::move(body)), attempts_(0)
+{
+}
+
+rai::CallbackEvent::CallbackEvent(std::string&& body,
+                                  const rai::CallbackDone& done)
+    : body_(std::move(body)), attempts_(0), done_(done)
+{
+}
+
+rai::CallbackConnection::CallbackConnection(
+    const std::shared_ptr<rai::CallbackDispatcher>& dispatcher,
+    boost::asio::io_service& service, boost::asio::ssl::context& ctx,
+    const rai::Url& url)
+    : dispatcher_(dispatcher),
+      strand_(service),
+      url_(url),
+      stream_(service, ctx),
+      connected_(false),
+      writing_(false),
+      reading_(false),
+      failed_(false),
+      in_flight_(0),
+      closed_(false),
+      keep_alive_(false)
+{
+}
+
+void rai::CallbackConnection::Connect(
+    const std::vector<boost::asio::ip::tcp::endpoint>& endpoints)
+{
+    auto connection(shared_from_this());
+    boost::asio::async_connect(
+        stream_.next_layer(), endpoints.begin(), endpoints.end(),
+        strand_.wrap(
+            [connection](const boost::system::error_code& ec,
+                         std::vector<boost::asio::ip::tcp::endpoint>::
+                             const_iterator) { connection->OnConnect_(ec); }));
+}
+
+void rai::CallbackConnection::Enqueue(
+    const std::shared_ptr<rai::CallbackRequest>& request)
+{
+    in_flight_ += 1;
+    auto connection(shared_from_this());
+    strand_.post([connection, request]() {
+        if (connection->closed_)
+        {
+            connection->in_flight_ -= 1;
+            std::vector<std::shared_ptr<rai::CallbackRequest>> requests{
+                request};
+            auto dispatcher(connection->dispatcher_.lock());
+            if (dispatcher)
+            {
+                // never written, not an attempt
+                dispatcher->OnFailure(connection, requests,
+                                      rai::ErrorCode::SUCCESS);
+            }
+            return;
+        }
+        connection->writes_.push_back(request);
+        if (connection->connected_ && !connection->writing_)
+        {
+            connection->Write_();
+        }
+    });
+}
+
+void rai::CallbackConnection::Close()
+{
+    auto connection(shared_from_this());
+    strand_.post([connection]() {
+        connection->closed_ = true;
+        connection->Shutdown_();
+    });
+}
+
+size_t rai::CallbackConnection::InFlight() const
+{
+    return in_flight_;
+}
+
+bool rai::CallbackConnection::Closed() const
+{
+    return closed_;
+}
+
+bool rai::CallbackConnection::KeepAlive() const
+{
+    return keep_alive_;
+}
+
+void rai::CallbackConnection::OnConnect_(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        Fail_(rai::ErrorCode::TCP_CONNECT);
+        return;
+    }
+
+    if (url_.protocol_ == "https")
+    {
+        if (!SSL_set_tlsext_host_name(stream_.native_handle(),
+                                      url_.host_.c_str()))
+        {
+            Fail_(rai::ErrorCode::SET_SSL_SNI);
+            return;
+        }
+        stream_.set_verify_mode(
+            boost::asio::ssl::verify_peer
+            | boost::asio::ssl::verify_fail_if_no_peer_cert);
+        stream_.set_verify_callback(
+            boost::asio::ssl::rfc2818_verification(url_.host_));
+        auto connection(shared_from_this());
+        stream_.async_handshake(
+            boost::asio::ssl::stream_base::client,
+            strand_.wrap([connection](const boost::system::error_code& ec) {
+                if (ec)
+                {
+                    connection->Fail_(rai::ErrorCode::SSL_HANDSHAKE);
+                    return;
+                }
+                connection->connected_ = true;
+                connection->Write_();
+            }));
+        return;
+    }
+
+    connected_ = true;
+    Write_();
+}
+
+void rai::CallbackConnection::Write_()
+{
+    // one request at a time until the server has shown it keeps the
+    // connection open, a pipelined request may be cut off by the close
+    if (closed_ || writes_.empty() || (!keep_alive_ && !reads_.empty()))
+    {
+        writing_ = false;
+        return;
+    }
+
+    writing_ = true;
+    auto connection(shared_from_this());
+    auto handler = strand_.wrap(
+        [connection](const boost::system::error_code& ec, size_t) {
+            connection->OnWrite_(ec);
+        });
+    auto& request = writes_.front()->http_;
+    if (url_.protocol_ == "https")
+    {
+        boost::beast::http::async_write(stream_, request, handler);
+    }
+    else
+    {
+        boost::beast::http::async_write(stream_.next_layer(), request,
+                                        handler);
+    }
+}
+
+void rai::CallbackConnection::OnWrite_(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        Fail_(Stale_(ec) ? rai::ErrorCode::SUCCESS
+                         : rai::ErrorCode::WRITE_STREAM);
+        return;
+    }
+
+    reads_.push_back(writes_.front());
+    writes_.pop_front();
+    if (!reading_)
+    {
+        Read_();
+    }
+    Write_();
+}
+
+void rai::CallbackConnection::Read_()
+{
+    if (closed_ || reads_.empty())
+    {
+        reading_ = false;
+        return;
+    }
+
+    reading_ = true;
+    parser_.emplace();
+    auto connection(shared_from_this());
+    auto handler = strand_.wrap(
+        [connection](const boost::system::error_code& ec, size_t) {
+            connection->OnRead_(ec);
+        });
+    if (url_.protocol_ == "https")
+    {
+        boost::beast::http::async_read(stream_, buffer_, *parser_, handler);
+    }
+    else
+    {
+        boost::beast::http::async_read(stream_.next_layer(), buffer_,
+                                       *parser_, handler);
+    }
+}
+
+void rai::CallbackConnection::OnRead_(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        Fail_(Stale_(ec) && !parser_->got_some() ? rai::ErrorCode::SUCCESS
+                                                 : rai::ErrorCode::STREAM);
+        return;
+    }
+
+    auto& response = parser_->get();
+    bool keep_alive = response.keep_alive();
+    if (keep_alive)
+    {
+        keep_alive_ = true;
+    }
+    else
+    {
+        // before the slot is freed, so the dispatcher doesn't pick it again
+        closed_ = true;
+    }
+
+    auto request = reads_.front();
+    reads_.pop_front();
+    in_flight_ -= 1;
+    auto dispatcher(dispatcher_.lock());
+    if (dispatcher)
+    {
+        dispatcher->OnResponse(shared_from_this(), request, response.result());
+    }
+
+    if (!keep_alive)
+    {
+        // the server closes after this response, hand the rest back
+        Fail_(rai::ErrorCode::SUCCESS);
+        return;
+    }
+
+    if (!writing_)
+    {
+        Write_();
+    }
+    Read_();
+}
+
+void rai::CallbackConnection::Fail_(rai::ErrorCode error_code)
+{
+    if (failed_)
+    {
+        return;
+    }
+    failed_ = true;
+    closed_ = true;
+    Shutdown_();
+
+    std::vector<std::shared_ptr<rai::CallbackRequest>> requests(reads_.begin(),
+                                                                reads_.end());
+    requests.insert(requests.end(), writes_.begin(), writes_.end());
+    reads_.clear();
+    writes_.clear();
+    in_flight_ -= requests.size();
+
+    auto dispatcher(dispatcher_.lock());
+    if (dispatcher)
+    {
+        dispatcher->OnFailure(shared_from_this(), requests, error_code);
+    }
+}
+
+void rai::CallbackConnection::Shutdown_()
+{
+    boost::system::error_code ignore;
+    stream_.next_layer().shutdown(boost::asio::ip::tcp::socket::shutdown_both,
+                                  ignore);
+    stream_.next_layer().close(ignore);
+}
+
+bool rai::CallbackConnection::Stale_(const boost::system::error_code& ec) const
+{
+    // a reused connection the server closed while it was idle
+    if (!keep_alive_)
+    {
+        return false;
+    }
+
+    return ec == boost::beast::http::error::end_of_stream
+           || ec == boost::asio::error::eof
+           || ec == boost::asio::error::connection_reset
+           || ec == boost::asio::error::broken_pipe;
+}
+
+rai::CallbackDispatcher::CallbackDispatcher(boost::asio::io_service& service,
+                                           const rai::Url& url,
+                                           const rai::CallbackConfig& config)
+    : service_(service),
+      url_(url),
+      config_(config),
+      ctx_(boost::asio::ssl::context::tlsv12_client),
+      resolver_(service),
+      stopped_(false),
+      resolving_(false),
+      sent_(0),
+      dropped_(0),
+      retried_(0),
+      failed_(0)
+{
+    if (url_.protocol_ == "https")
+    {
+        try
+        {
+            ctx_.load_verify_file("cacert.pem");
+        }
+        catch (...)
+        {
+            rai::Stats::Add(rai::ErrorCode::LOAD_CERT, "CallbackDispatcher");
+        }
+    }
+}
+
+void rai::CallbackDispatcher::Send(const rai::Ptree& notify)
+{
+    Send(rai::PtreeToJson(notify), nullptr);
+}
+
+void rai::CallbackDispatcher::Send(std::string&& body,
+                                   const rai::CallbackDone& done)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    rai::CallbackEvent event(std::move(body), done);
+    if (stopped_)
+    {
+        Done_(event, false);
+    }
+    else if (queue_.size() >= config_.queue_size_)
+    {
+        dropped_ += 1;
+        rai::Stats::Add(rai::ErrorCode::CALLBACK_QUEUE_FULL);
+        Done_(event, false);
+    }
+    else
+    {
+        queue_.push_back(std::move(event));
+        Pump_();
+    }
+    RunDone_(lock);
+}
+
+void rai::CallbackDispatcher::Retry()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_)
+    {
+        return;
+    }
+    Pump_();
+}
+
+void rai::CallbackDispatcher::Stop()
+{
+    std::vector<std::shared_ptr<rai::CallbackConnection>> connections;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stopped_ = true;
+        for (auto& i : queue_)
+        {
+            Done_(i, false);
+        }
+        queue_.clear();
+        connections.swap(connections_);
+        RunDone_(lock);
+    }
+
+    resolver_.cancel();
+    for (const auto& i : connections)
+    {
+        i->Close();
+    }
+}
+
+rai::CallbackStat rai::CallbackDispatcher::Stat() const
+{
+    rai::CallbackStat result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.queue_ = queue_.size();
+    result.connections_ = connections_.size();
+    result.in_flight_ = 0;
+    for (const auto& i : connections_)
+    {
+        result.in_flight_ += i->InFlight();
+    }
+    result.sent_ = sent_;
+    result.dropped_ = dropped_;
+    result.retried_ = retried_;
+    result.failed_ = failed_;
+    return result;
+}
+
+void rai::CallbackDispatcher::OnResponse(
+    const std::shared_ptr<rai::CallbackConnection>& connection,
+    const std::shared_ptr<rai::CallbackRequest>& request,
+    boost::beast::http::status status)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint32_t code = static_cast<uint32_t>(status);
+    if (code >= 200 && code < 300)
+    {
+        sent_ += request->events_.size();
+        for (auto& i : request->events_)
+        {
+            Done_(i, true);
+        }
+    }
+    else if (code >= 500)
+    {
+        Requeue_(request->events_, true);
+    }
+    else
+    {
+        failed_ += request->events_.size();
+        for (auto& i : request->events_)
+        {
+            Done_(i, false);
+        }
+        rai::Stats::Add(rai::ErrorCode::HTTP_POST,
+                        "CallbackDispatcher::OnResponse: status=", code);
+    }
+
+    if (!stopped_)
+    {
+        Pump_();
+    }
+    RunDone_(lock);
+}
+
+void rai::CallbackDispatcher::OnFailure(
+    const std::shared_ptr<rai::CallbackConnection>& connection,
+    std::vector<std::shared_ptr<rai::CallbackRequest>>& requests,
+    rai::ErrorCode error_code)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool closed = error_code == rai::ErrorCode::SUCCESS;
+    if (!closed)
+    {
+        rai::Stats::Add(error_code, "CallbackDispatcher::OnFailure");
+        if (error_code == rai::ErrorCode::TCP_CONNECT)
+        {
+            // the cached address may be stale
+            resolved_at_ = std::chrono::steady_clock::time_point();
+        }
+        reconnect_at_ = std::chrono::steady_clock::now() + RECONNECT_DELAY;
+    }
+
+    auto it = std::find(connections_.begin(), connections_.end(), connection);
+    if (it != connections_.end())
+    {
+        connections_.erase(it);
+    }
+
+    for (auto i = requests.rbegin(), n = requests.rend(); i != n; ++i)
+    {
+        Requeue_((*i)->events_, !closed);
+    }
+
+    if (!stopped_)
+    {
+        Pump_();
+    }
+    RunDone_(lock);
+}
+
+void rai::CallbackDispatcher::Pump_()
+{
+    if (queue_.empty())
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (endpoints_.empty()
+        || now - resolved_at_ >= std::chrono::seconds(config_.dns_ttl_))
+    {
+        Resolve_();
+        if (endpoints_.empty())
+        {
+            return;
+        }
+    }
+
+    if (connections_.size() < config_.connections_ && now >= reconnect_at_)
+    {
+        auto connection = std::make_shared<rai::CallbackConnection>(
+            shared_from_this(), service_, ctx_, url_);
+        connection->Connect(endpoints_);
+        connections_.push_back(connection);
+    }
+
+    while (!queue_.empty())
+    {
+        std::shared_ptr<rai::CallbackConnection> target;
+        for (const auto& i : connections_)
+        {
+            size_t pipeline = i->KeepAlive() ? config_.pipeline_ : 1;
+            if (i->Closed() || i->InFlight() >= pipeline)
+            {
+                continue;
+            }
+            if (!target || i->InFlight() < target->InFlight())
+            {
+                target = i;
+            }
+        }
+        if (!target)
+        {
+            break;
+        }
+        target->Enqueue(MakeRequest_());
+    }
+}
+
+void rai::CallbackDispatcher::Resolve_()
+{
+    if (resolving_)
+    {
+        return;
+    }
+    resolving_ = true;
+
+    std::weak_ptr<rai::CallbackDispatcher> dispatcher_w(shared_from_this());
+    boost::asio::ip::tcp::resolver::query query(url_.host_,
+                                                std::to_string(url_.port_));
+    resolver_.async_resolve(
+        query, [dispatcher_w](const boost::system::error_code& ec,
+                              boost::asio::ip::tcp::resolver::iterator it) {
+            auto dispatcher(dispatcher_w.lock());
+            if (!dispatcher)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(dispatcher->mutex_);
+            dispatcher->resolving_ = false;
+            if (ec)
+            {
+                rai::Stats::Add(rai::ErrorCode::DNS_RESOLVE,
+                                "CallbackDispatcher::Resolve_");
+                dispatcher->reconnect_at_ = std::chrono::steady_clock::now()
+                                            + RECONNECT_DELAY;
+                return;
+            }
+
+            std::vector<boost::asio::ip::tcp::endpoint> endpoints;
+            for (auto n = boost::asio::ip::tcp::resolver::iterator{}; it != n;
+                 ++it)
+            {
+                endpoints.push_back(it->endpoint());
+            }
+            if (endpoints.empty())
+            {
+                return;
+            }
+            dispatcher->endpoints_.swap(endpoints);
+            dispatcher->resolved_at_ = std::chrono::steady_clock::now();
+            if (!dispatcher->stopped_)
+            {
+                dispatcher->Pump_();
+            }
+        });
+}
+
+void rai::CallbackDispatcher::Requeue_(std::vector<rai::CallbackEvent>& events,
+                                       bool attempt)
+{
+    for (auto i = events.rbegin(), n = events.rend(); i != n; ++i)
+    {
+        if (attempt)
+        {
+            i->attempts_ += 1;
+        }
+        if (stopped_ || i->attempts_ > config_.retries_)
+        {
+            failed_ += 1;
+            Done_(*i, false);
+            continue;
+        }
+        retried_ += 1;
+        queue_.push_front(std::move(*i));
+    }
+}
+
+void rai::CallbackDispatcher::Done_(rai::CallbackEvent& event, bool success)
+{
+    if (event.done_)
+    {
+        dones_.emplace_back(std::move(event.done_), success);
+        event.done_ = nullptr;
+    }
+}
+
+void rai::CallbackDispatcher::RunDone_(std::unique_lock<std::mutex>& lock)
+{
+    if (dones_.empty())
+    {
+        return;
+    }
+
+    std::vector<std::pair<rai::CallbackDone, bool>> dones;
+    dones.swap(dones_);
+    lock.unlock();
+    for (const auto& i : dones)
+    {
+        i.first(i.second);
+    }
+    lock.lock();
+}
+
+std::shared_ptr<rai::CallbackRequest> rai::CallbackDispatcher::MakeRequest_()
+{
+    auto request = std::make_shared<rai::CallbackRequest>();
+    size_t count = std::min<size_t>(config_.batch_, queue_.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+        request->events_.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+    }
+
+    std::string body;
+    if (config_.batch_ > 1)
+    {
+        body += "[";
+        for (size_t i = 0; i < request->events_.size(); ++i)
+        {
+            if (i > 0)
+            {
+                body += ",";
+            }
+            body += request->events_[i].body_;
+        }
+        body += "]";
+    }
+    else
+    {
+        body = request->events_[0].body_;
+    }
+
+    auto& http = request->http_;
+    http.method(boost::beast::http::verb::post);
+    http.target(url_.path_);
+    http.version(11);
+    http.keep_alive(true);
+    http.set(boost::beast::http::field::host, url_.host_);
+    http.set(boost::beast::http::field::content_type, "application/json");
+    http.body() = std::move(body);
+    http.prepare_payload();
+    return request;
+}
+
+rai::CallbackOutbox::CallbackOutbox(
+    boost::asio::io_service& service, rai::Ledger& ledger,
+    const std::shared_ptr<rai::CallbackDispatcher>& dispatcher,
+    const rai::CallbackConfig& config)
+    : service_(service),
+      ledger_(ledger),
+      dispatcher_(dispatcher),
+      config_(config),
+      window_(static_cast<size_t>(config.connections_) * config.pipeline_
+              * config.batch_),
+      notified_(false),
+      generation_(0),
+      next_(1),
+      acked_(0),
+      committed_(0),
+      in_flight_(0)
+{
+}
+
+rai::ErrorCode rai::CallbackOutbox::Init()
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, ledger_, false);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool error = ledger_.CallbackAckedGet(transaction, acked_);
+    if (error)
+    {
+        acked_ = 0;
+    }
+    committed_ = acked_;
+    next_ = acked_ + 1;
+
+    uint64_t first = 0;
+    error = ledger_.CallbackFirst(transaction, first);
+    if (!error && first > next_)
+    {
+        next_ = first;
+        acked_ = first - 1;
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+void rai::CallbackOutbox::Notify()
+{
+    if (notified_.exchange(true))
+    {
+        return;
+    }
+
+    std::weak_ptr<rai::CallbackOutbox> outbox_w(shared_from_this());
+    service_.post([outbox_w]() {
+        auto outbox(outbox_w.lock());
+        if (outbox)
+        {
+            outbox->Pump();
+        }
+    });
+}
+
+void rai::CallbackOutbox::Pump()
+{
+    notified_ = false;
+    Commit_();
+
+    std::vector<std::pair<uint64_t, std::string>> notifies;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (in_flight_ >= window_)
+        {
+            return;
+        }
+
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, ledger_, false);
+        if (error_code != rai::ErrorCode::SUCCESS)
+        {
+            rai::Stats::Add(error_code, "CallbackOutbox::Pump");
+            return;
+        }
+
+        bool error = ledger_.CallbackGet(transaction, next_,
+                                         window_ - in_flight_, notifies);
+        if (error)
+        {
+            rai::Stats::Add(rai::ErrorCode::LEDGER_CALLBACK_GET,
+                            "CallbackOutbox::Pump: sequence=", next_);
+            return;
+        }
+        if (notifies.empty())
+        {
+            return;
+        }
+        next_ = notifies.back().first + 1;
+        in_flight_ += notifies.size();
+        generation = generation_;
+    }
+
+    std::weak_ptr<rai::CallbackOutbox> outbox_w(shared_from_this());
+    for (auto& i : notifies)
+    {
+        uint64_t sequence = i.first;
+        dispatcher_->Send(
+            std::move(i.second),
+            [outbox_w, generation, sequence](bool success) {
+                auto outbox(outbox_w.lock());
+                if (outbox)
+                {
+                    outbox->OnDone_(generation, sequence, success);
+                }
+            });
+    }
+}
+
+rai::ErrorCode rai::CallbackOutbox::Resume(uint64_t& sequence)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    {
+        rai::Transaction transaction(error_code, ledger_, false);
+        IF_NOT_SUCCESS_RETURN(error_code);
+
+        uint64_t first = 0;
+        bool error = ledger_.CallbackFirst(transaction, first);
+        if (!error && sequence < first)
+        {
+            sequence = first;
+        }
+
+        uint64_t next = 0;
+        error = ledger_.CallbackNext(transaction, next);
+        IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_CALLBACK_GET);
+        if (sequence == 0)
+        {
+            sequence = 1;
+        }
+        if (sequence > next)
+        {
+            sequence = next;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_ += 1;
+        in_flight_ = 0;
+        delivered_.clear();
+        next_ = sequence;
+        acked_ = sequence - 1;
+    }
+    Commit_();
+
+    Notify();
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::CallbackOutbox::Stat(rai::CallbackOutboxStat& stat)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, ledger_, false);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    bool error = ledger_.CallbackNext(transaction, stat.next_);
+    IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_CALLBACK_GET);
+    error = ledger_.CallbackFirst(transaction, stat.first_);
+    if (error)
+    {
+        stat.first_ = stat.next_;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stat.sending_ = next_;
+    stat.acked_ = acked_;
+    stat.in_flight_ = in_flight_;
+    return rai::ErrorCode::SUCCESS;
+}
+
+void rai::CallbackOutbox::OnDone_(uint64_t generation, uint64_t sequence,
+                                  bool success)
+{
+    bool pump = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (success && sequence > acked_)
+        {
+            delivered_.insert(sequence);
+            while (!delivered_.empty() && *delivered_.begin() == acked_ + 1)
+            {
+                delivered_.erase(delivered_.begin());
+                acked_ += 1;
+            }
+        }
+
+        if (generation != generation_)
+        {
+            return;
+        }
+        in_flight_ -= 1;
+
+        if (!success)
+        {
+            // resend from the first unacknowledged sequence on the next
+            // ongoing pump, pumping here could spin on a full queue
+            generation_ += 1;
+            in_flight_ = 0;
+            next_ = acked_ + 1;
+            delivered_.clear();
+            return;
+        }
+        pump = in_flight_ <= window_ / 2;
+    }
+
+    if (pump)
+    {
+        Notify();
+    }
+}
+
+void rai::CallbackOutbox::Commit_()
+{
+    // the write transaction runs outside mutex_ so producers never wait on
+    // the LMDB writer lock, commit_mutex_ keeps the stored offset in order
+    std::lock_guard<std::mutex> commit_lock(commit_mutex_);
+    uint64_t acked = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (acked_ == committed_)
+        {
+            return;
+        }
+        acked = acked_;
+    }
+
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, ledger_, true);
+        if (error_code != rai::ErrorCode::SUCCESS)
+        {
+            rai::Stats::Add(error_code, "CallbackOutbox::Commit_");
+            return;
+        }
+
+        bool error = ledger_.CallbackAckedPut(transaction, acked);
+        if (error)
+        {
+            transaction.Abort();
+            rai::Stats::Add(rai::ErrorCode::LEDGER_CALLBACK_PUT,
+                            "CallbackOutbox::Commit_");
+            return;
+        }
+
+        if (acked > config_.outbox_retain_)
+        {
+            size_t pruned = 0;
+            error = ledger_.CallbackPrune(
+                transaction, acked - config_.outbox_retain_ + 1,
+                rai::CallbackOutbox::PRUNE_BATCH, pruned);
+            if (error)
+            {
+                transaction.Abort();
+                rai::Stats::Add(rai::ErrorCode::LEDGER_CALLBACK_DEL,
+                                "CallbackOutbox::Commit_");
+                return;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    committed_ = acked;
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast.hpp>
+
+#include <rai/common/errors.hpp>
+#include <rai/common/util.hpp>
+#include <rai/secure/ledger.hpp>
+
+namespace rai
+{
+class CallbackConfig
+{
+public:
+    CallbackConfig();
+    rai::ErrorCode DeserializeJson(bool&, rai::Ptree&);
+    void SerializeJson(rai::Ptree&) const;
+
+    static uint32_t constexpr DEFAULT_CONNECTIONS = 2;
+    static uint32_t constexpr DEFAULT_PIPELINE    = 4;
+    static uint32_t constexpr DEFAULT_BATCH       = 1;
+    static uint32_t constexpr DEFAULT_QUEUE_SIZE  = 10000;
+    static uint32_t constexpr DEFAULT_RETRIES     = 2;
+    static uint32_t constexpr DEFAULT_DNS_TTL     = 300;
+    static uint64_t constexpr DEFAULT_OUTBOX_RETAIN = 100000;
+
+    // keep-alive connections to the callback server
+    uint32_t connections_;
+    // requests written ahead of their responses on one connection
+    uint32_t pipeline_;
+    // events per POST, more than 1 posts a JSON array
+    uint32_t batch_;
+    uint32_t queue_size_;
+    uint32_t retries_;
+    // seconds a resolved address is reused
+    uint32_t dns_ttl_;
+    // persist block_confirm notifications in the ledger until acknowledged
+    bool outbox_;
+    // acknowledged notifications kept for replay
+    uint64_t outbox_retain_;
+};
+
+typedef std::function<void(bool)> CallbackDone;
+
+class CallbackEvent
+{
+public:
+    CallbackEvent(std::string&&);
+    CallbackEvent(std::string&&, const rai::CallbackDone&);
+
+    std::string body_;
+    uint32_t attempts_;
+    // called once with true on a 2xx response, false when given up
+    rai::CallbackDone done_;
+};
+
+class CallbackRequest
+{
+public:
+    std::vector<rai::CallbackEvent> events_;
+    boost::beast::http::request<boost::beast::http::string_body> http_;
+};
+
+class CallbackStat
+{
+public:
+    size_t queue_;
+    size_t connections_;
+    size_t in_flight_;
+    uint64_t sent_;
+    uint64_t dropped_;
+    uint64_t retried_;
+    uint64_t failed_;
+};
+
+class CallbackDispatcher;
+
+// One keep-alive connection, requests are pipelined once the server has
+// answered with keep-alive and the responses are matched in order. All socket
+// work runs on the connection's strand.
+class CallbackConnection
+    : public std::enable_shared_from_this<rai::CallbackConnection>
+{
+public:
+    CallbackConnection(const std::shared_ptr<rai::CallbackDispatcher>&,
+                       boost::asio::io_service&, boost::asio::ssl::context&,
+                       const rai::Url&);
+    void Connect(const std::vector<boost::asio::ip::tcp::endpoint>&);
+    void Enqueue(const std::shared_ptr<rai::CallbackRequest>&);
+    void Close();
+    size_t InFlight() const;
+    bool Closed() const;
+    bool KeepAlive() const;
+
+private:
+    void OnConnect_(const boost::system::error_code&);
+    void Write_();
+    void OnWrite_(const boost::system::error_code&);
+    void Read_();
+    void OnRead_(const boost::system::error_code&);
+    void Fail_(rai::ErrorCode);
+    void Shutdown_();
+    bool Stale_(const boost::system::error_code&) const;
+
+    std::weak_ptr<rai::CallbackDispatcher> dispatcher_;
+    boost::asio::io_service::strand strand_;
+    rai::Url url_;
+    boost::asio::ssl::stream<boost::asio::ip::tcp::socket> stream_;
+    boost::beast::flat_buffer buffer_;
+    boost::optional<boost::beast::http::response_parser<
+        boost::beast::http::string_body>>
+        parser_;
+    bool connected_;
+    bool writing_;
+    bool reading_;
+    // a write error is followed by the aborted read, report only once
+    bool failed_;
+    std::deque<std::shared_ptr<rai::CallbackRequest>> writes_;
+    std::deque<std::shared_ptr<rai::CallbackRequest>> reads_;
+    std::atomic<size_t> in_flight_;
+    std::atomic<bool> closed_;
+    // a keep-alive response was seen, requests may be pipelined
+    std::atomic<bool> keep_alive_;
+};
+
+// Delivers callback notifications over a pool of persistent connections,
+// with a bounded queue, cached DNS and optional batching
+class CallbackDispatcher
+    : public std::enable_shared_from_this<rai::CallbackDispatcher>
+{
+public:
+    CallbackDispatcher(boost::asio::io_service&, const rai::Url&,
+                       const rai::CallbackConfig&);
+    void Send(const rai::Ptree&);
+    void Send(std::string&&, const rai::CallbackDone&);
+    void Retry();
+    void Stop();
+    rai::CallbackStat Stat() const;
+
+    void OnResponse(const std::shared_ptr<rai::CallbackConnection>&,
+                    const std::shared_ptr<rai::CallbackRequest>&,
+                    boost::beast::http::status);
+    // SUCCESS when the server closed the connection in the normal way, the
+    // unanswered requests are sent again without counting an attempt
+    void OnFailure(const std::shared_ptr<rai::CallbackConnection>&,
+                   std::vector<std::shared_ptr<rai::CallbackRequest>>&,
+                   rai::ErrorCode);
+
+    static std::chrono::seconds constexpr RECONNECT_DELAY =
+        std::chrono::seconds(1);
+
+private:
+    void Pump_();
+    void Resolve_();
+    void Requeue_(std::vector<rai::CallbackEvent>&, bool);
+    void Done_(rai::CallbackEvent&, bool);
+    void RunDone_(std::unique_lock<std::mutex>&);
+    std::shared_ptr<rai::CallbackRequest> MakeRequest_();
+
+    boost::asio::io_service& service_;
+    rai::Url url_;
+    rai::CallbackConfig config_;
+    boost::asio::ssl::context ctx_;
+    boost::asio::ip::tcp::resolver resolver_;
+
+    mutable std::mutex mutex_;
+    bool stopped_;
+    bool resolving_;
+    std::vector<boost::asio::ip::tcp::endpoint> endpoints_;
+    std::chrono::steady_clock::time_point resolved_at_;
+    std::chrono::steady_clock::time_point reconnect_at_;
+    std::deque<rai::CallbackEvent> queue_;
+    std::vector<std::shared_ptr<rai::CallbackConnection>> connections_;
+    std::vector<std::pair<rai::CallbackDone, bool>> dones_;
+
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> retried_;
+    std::atomic<uint64_t> failed_;
+};
+class CallbackOutboxStat
+{
+public:
+    uint64_t first_;
+    uint64_t next_;
+    uint64_t sending_;
+    uint64_t acked_;
+    size_t in_flight_;
+};
+
+// Streams the ledger's callback outbox through the dispatcher in sequence
+// order. The acknowledged offset only moves over a contiguous run of
+// delivered sequences, a failed delivery rewinds the sender to it.
+class CallbackOutbox
+    : public std::enable_shared_from_this<rai::CallbackOutbox>
+{
+public:
+    CallbackOutbox(boost::asio::io_service&, rai::Ledger&,
+                   const std::shared_ptr<rai::CallbackDispatcher>&,
+                   const rai::CallbackConfig&);
+    rai::ErrorCode Init();
+    void Notify();
+    void Pump();
+    rai::ErrorCode Resume(uint64_t&);
+    rai::ErrorCode Stat(rai::CallbackOutboxStat&);
+
+    static size_t constexpr PRUNE_BATCH = 1024;
+
+private:
+    void OnDone_(uint64_t, uint64_t, bool);
+    // must be called without mutex_ held
+    void Commit_();
+
+    boost::asio::io_service& service_;
+    rai::Ledger& ledger_;
+    std::shared_ptr<rai::CallbackDispatcher> dispatcher_;
+    rai::CallbackConfig config_;
+    size_t window_;
+    std::atomic<bool> notified_;
+
+    std::mutex commit_mutex_;
+    std::mutex mutex_;
+    // bumped on rewind, completions of older generations are stale
+    uint64_t generation_;
+    uint64_t next_;
+    uint64_t acked_;
+    uint64_t committed_;
+    size_t in_flight_;
+    std::set<uint64_t> delivered_;
+};
+}  // namespace rai
@@ -159,6 +159,10 @@ std::string rai::MessageDumper::ToString(rai::MessageType type)
         {
             return "bootstrap";
         }
+        case rai::MessageType::CONFIRM_BATCH:
+        {
+            return "confirm_batch";
+        }
         default:
         {
             return "unknown(" + std::to_string(static_cast<uint32_t>(type))
@@ -3,18 +3,31 @@
 #include <rai/node/node.hpp>
 
 
+size_t constexpr rai::Elections::MAX_ACTIVE_ELECTIONS;
+size_t constexpr rai::Elections::MAX_QUEUED_ELECTIONS;
+size_t constexpr rai::Elections::MAX_RETRY_BATCH;
+uint64_t constexpr rai::Elections::CONFIRMATION_RATE_WINDOW;
 std::chrono::seconds constexpr rai::Elections::FORK_ELECTION_DELAY;
 std::chrono::seconds constexpr rai::Elections::FORK_ELECTION_INTERVAL;
 std::chrono::seconds constexpr rai::Elections::NON_FORK_ELECTION_DELAY;
 std::chrono::seconds constexpr rai::Elections::NON_FORK_ELECTION_INTERVAL;
 
-rai::Vote::Vote() : timestamp_(0), signature_(0), hash_(0)
+rai::Vote::Vote() : timestamp_(0), signature_(0), hash_(0), batch_(nullptr)
 {
 }
 
 rai::Vote::Vote(uint64_t timestamp, const rai::Signature& signature,
                 const rai::BlockHash& hash)
-    : timestamp_(timestamp), signature_(signature), hash_(hash)
+    : timestamp_(timestamp), signature_(signature), hash_(hash), batch_(nullptr)
+{
+}
+
+rai::Vote::Vote(const rai::ConfirmEntry& entry,
+                const std::shared_ptr<rai::ConfirmBatchMessage>& batch)
+    : timestamp_(entry.timestamp_),
+      signature_(batch->signature_),
+      hash_(entry.hash_),
+      batch_(batch)
 {
 }
 
@@ -31,32 +44,36 @@ rai::RepVoteInfo::RepVoteInfo(bool conflict_found, const rai::Amount& weight,
 
 uint64_t rai::RepVoteInfo::WeightFactor(uint64_t allow) const
 {
-    uint64_t now = rai::CurrentTimestamp();
+    return rai::RepVoteInfo::WeightFactor(last_vote_.timestamp_,
+                                          rai::CurrentTimestamp(), allow);
+}
+
+uint64_t rai::RepVoteInfo::WeightFactor(uint64_t timestamp, uint64_t now,
+                                        uint64_t allow)
+{
     uint64_t result = 0;
     if (allow == 0 || allow > rai::MAX_TIMESTAMP_DIFF)
     {
         return 0;
     }
 
-    if (last_vote_.timestamp_ <= now - allow * 2)
+    if (timestamp <= now - allow * 2)
     {
         result = 0;
     }
-    else if (last_vote_.timestamp_ <= now - allow)
+    else if (timestamp <= now - allow)
     {
-        uint64_t diff =
-            last_vote_.timestamp_ + allow * 2 - now;
+        uint64_t diff = timestamp + allow * 2 - now;
         result = diff * 100 / allow;
     }
-    else if (last_vote_.timestamp_ <= now + allow)
+    else if (timestamp <= now + allow)
     {
-        result =  100;
+        result = 100;
     }
-    else if (last_vote_.timestamp_ <= now + allow * 2)
+    else if (timestamp <= now + allow * 2)
     {
-        uint64_t diff =
-            now + allow * 2 - last_vote_.timestamp_;
-        result =  diff * 100 / allow;
+        uint64_t diff = now + allow * 2 - timestamp;
+        result = diff * 100 / allow;
     }
     else
     {
@@ -71,6 +88,86 @@ uint64_t rai::RepVoteInfo::WeightFactor(uint64_t allow) const
     return result;
 }
 
+rai::CandidateTally::CandidateTally() : total_(0)
+{
+}
+
+void rai::CandidateTally::Add(uint64_t timestamp, const rai::Amount& weight)
+{
+    if (weight.IsZero())
+    {
+        return;
+    }
+    total_ += weight;
+    timestamps_[timestamp] += weight;
+}
+
+void rai::CandidateTally::Del(uint64_t timestamp, const rai::Amount& weight)
+{
+    if (weight.IsZero())
+    {
+        return;
+    }
+
+    auto it = timestamps_.find(timestamp);
+    if (it == timestamps_.end() || it->second < weight || total_ < weight)
+    {
+        assert(0);
+        return;
+    }
+    total_ -= weight;
+    it->second -= weight;
+    if (it->second.IsZero())
+    {
+        timestamps_.erase(it);
+    }
+}
+
+bool rai::CandidateTally::Empty() const
+{
+    return timestamps_.empty();
+}
+
+rai::Amount rai::CandidateTally::Weight(uint64_t now, uint64_t allow) const
+{
+    if (allow == 0 || allow > rai::MAX_TIMESTAMP_DIFF)
+    {
+        return rai::Amount(0);
+    }
+
+    // Votes inside (now - allow, now + allow] count in full, only the buckets
+    // at both ends of the timestamp map need to be decayed
+    rai::Amount result(total_);
+    for (auto it = timestamps_.begin();
+         it != timestamps_.end() && it->first <= now - allow; ++it)
+    {
+        result -= rai::CandidateTally::Loss_(it->first, now, allow, it->second);
+    }
+
+    for (auto it = timestamps_.rbegin();
+         it != timestamps_.rend() && it->first > now + allow; ++it)
+    {
+        result -= rai::CandidateTally::Loss_(it->first, now, allow, it->second);
+    }
+
+    return result;
+}
+
+rai::Amount rai::CandidateTally::Loss_(uint64_t timestamp, uint64_t now,
+                                       uint64_t allow,
+                                       const rai::Amount& weight)
+{
+    uint64_t factor = rai::RepVoteInfo::WeightFactor(timestamp, now, allow);
+    rai::Amount adjust;
+    bool error = weight.MulDiv(factor, 100, adjust);
+    if (error)
+    {
+        assert(0);
+        return weight;
+    }
+    return weight - adjust;
+}
+
 rai::Election::Election()
     : account_(0),
       height_(rai::Block::INVALID_HEIGHT),
@@ -83,7 +180,9 @@ rai::Election::Election()
       winner_(0),
       fork_broadcast_delay_(0),
       wakeup_(std::chrono::steady_clock::now()
-              + rai::Elections::NON_FORK_ELECTION_DELAY)
+              + rai::Elections::NON_FORK_ELECTION_DELAY),
+      tally_conflict_(0),
+      tally_online_(0)
 {
     fork_broadcast_delay_ = rai::random_pool.GenerateWord32(
         1, rai::Elections::FORK_ELECTION_DELAY.count() - 8);
@@ -131,6 +230,269 @@ bool rai::Election::ForkFound() const
     return fork_found_;
 }
 
+void rai::Election::TallyAdd(const rai::RepVoteInfo& info,
+                             const rai::Amount& weight, bool online)
+{
+    if (weight.IsZero())
+    {
+        return;
+    }
+
+    if (online)
+    {
+        tally_online_ += weight;
+    }
+
+    if (info.conflict_found_)
+    {
+        tally_conflict_ += weight;
+        return;
+    }
+
+    candidates_[info.last_vote_.hash_].Add(info.last_vote_.timestamp_, weight);
+}
+
+void rai::Election::TallyDel(const rai::RepVoteInfo& info,
+                             const rai::Amount& weight, bool online)
+{
+    if (weight.IsZero())
+    {
+        return;
+    }
+
+    if (online)
+    {
+        assert(tally_online_ >= weight);
+        tally_online_ -= weight;
+    }
+
+    if (info.conflict_found_)
+    {
+        assert(tally_conflict_ >= weight);
+        tally_conflict_ -= weight;
+        return;
+    }
+
+    auto it = candidates_.find(info.last_vote_.hash_);
+    if (it == candidates_.end())
+    {
+        assert(0);
+        return;
+    }
+    it->second.Del(info.last_vote_.timestamp_, weight);
+    if (it->second.Empty())
+    {
+        candidates_.erase(it);
+    }
+}
+
+void rai::Election::SetVote(const rai::Account& representative,
+                            const rai::RepVoteInfo& info,
+                            const rai::Amount& weight, bool online)
+{
+    auto it = votes_.find(representative);
+    if (it != votes_.end())
+    {
+        TallyDel(it->second, weight, online);
+        it->second = info;
+    }
+    else
+    {
+        votes_[representative] = info;
+    }
+    TallyAdd(info, weight, online);
+}
+
+void rai::Election::TallyUpdate(const std::vector<rai::RepTallyChange>& changes)
+{
+    for (const auto& change : changes)
+    {
+        auto it = votes_.find(change.representative_);
+        if (it == votes_.end())
+        {
+            continue;
+        }
+        TallyDel(it->second, change.weight_old_, change.online_old_);
+        TallyAdd(it->second, change.weight_new_, change.online_new_);
+    }
+}
+
+rai::ElectionPriority::ElectionPriority()
+    : fork_(false), credit_(0), balance_(0), sequence_(0)
+{
+}
+
+rai::ElectionPriority::ElectionPriority(
+    const std::vector<std::shared_ptr<rai::Block>>& blocks, uint64_t sequence)
+    : fork_(blocks.size() > 1), credit_(0), balance_(0), sequence_(sequence)
+{
+    for (const auto& i : blocks)
+    {
+        if (i->Credit() > credit_)
+        {
+            credit_ = i->Credit();
+        }
+        if (i->Balance() > balance_)
+        {
+            balance_ = i->Balance();
+        }
+    }
+}
+
+bool rai::ElectionPriority::operator>(const rai::ElectionPriority& other) const
+{
+    if (fork_ != other.fork_)
+    {
+        return fork_;
+    }
+    if (credit_ != other.credit_)
+    {
+        return credit_ > other.credit_;
+    }
+    if (balance_ != other.balance_)
+    {
+        return balance_ > other.balance_;
+    }
+    return sequence_ < other.sequence_;
+}
+
+rai::ElectionBacklog::ElectionBacklog(size_t max)
+    : max_(max), sequence_(0), dropped_(0)
+{
+}
+
+void rai::ElectionBacklog::Push(
+    const rai::Account& account, uint64_t height,
+    const std::vector<std::shared_ptr<rai::Block>>& blocks)
+{
+    auto it = queue_.find(account);
+    if (it != queue_.end())
+    {
+        if (it->height_ < height)
+        {
+            return;
+        }
+
+        std::vector<std::shared_ptr<rai::Block>> merged;
+        if (it->height_ == height)
+        {
+            merged = it->blocks_;
+        }
+        for (const auto& i : blocks)
+        {
+            auto it_block = std::find_if(
+                merged.begin(), merged.end(),
+                [&i](const std::shared_ptr<rai::Block>& block) {
+                    return block->Hash() == i->Hash();
+                });
+            if (it_block == merged.end())
+            {
+                merged.push_back(i);
+            }
+        }
+        rai::ElectionPriority priority(merged, it->priority_.sequence_);
+        queue_.modify(it, [&](rai::QueuedElection& data) {
+            data.height_ = height;
+            data.priority_ = priority;
+            data.blocks_ = std::move(merged);
+        });
+        return;
+    }
+
+    rai::QueuedElection queued{account, height,
+                               rai::ElectionPriority(blocks, sequence_++),
+                               blocks};
+    if (queue_.size() >= max_)
+    {
+        auto it_lowest = std::prev(queue_.get<1>().end());
+        if (!(queued.priority_ > it_lowest->priority_))
+        {
+            Evict_(account, height);
+            return;
+        }
+        Evict_(it_lowest->account_, it_lowest->height_);
+        queue_.get<1>().erase(it_lowest);
+    }
+    evicted_.erase(account);
+    queue_.insert(std::move(queued));
+}
+
+bool rai::ElectionBacklog::Pop(
+    const std::function<bool(const rai::Account&)>& skip,
+    rai::QueuedElection& queued)
+{
+    // skipped entries stay queued for a later call
+    for (auto i = queue_.get<1>().begin(), n = queue_.get<1>().end(); i != n;
+         ++i)
+    {
+        if (skip(i->account_))
+        {
+            continue;
+        }
+        queued = *i;
+        queue_.get<1>().erase(i);
+        return false;
+    }
+    return true;
+}
+
+void rai::ElectionBacklog::Erase(const rai::Account& account)
+{
+    queue_.erase(account);
+}
+
+std::vector<std::pair<rai::Account, uint64_t>> rai::ElectionBacklog::Evicted(
+    size_t max)
+{
+    std::vector<std::pair<rai::Account, uint64_t>> result;
+    while (!evicted_.empty() && result.size() < max)
+    {
+        auto it = evicted_.begin();
+        result.push_back(*it);
+        evicted_.erase(it);
+    }
+    return result;
+}
+
+bool rai::ElectionBacklog::Empty() const
+{
+    return queue_.empty();
+}
+
+size_t rai::ElectionBacklog::Size() const
+{
+    return queue_.size();
+}
+
+size_t rai::ElectionBacklog::EvictedSize() const
+{
+    return evicted_.size();
+}
+
+uint64_t rai::ElectionBacklog::Dropped() const
+{
+    return dropped_;
+}
+
+void rai::ElectionBacklog::Evict_(const rai::Account& account, uint64_t height)
+{
+    ++dropped_;
+    auto it = evicted_.find(account);
+    if (it != evicted_.end())
+    {
+        if (height < it->second)
+        {
+            it->second = height;
+        }
+        return;
+    }
+
+    if (evicted_.size() < max_)
+    {
+        evicted_.emplace(account, height);
+    }
+}
+
 rai::ElectionStatus::ElectionStatus()
     : error_(false),
       win_(false),
@@ -146,6 +508,10 @@ rai::ElectionStatus::ElectionStatus()
 rai::Elections::Elections(rai::Node& node)
     : node_(node),
       last_update_(0),
+      weights_(std::make_shared<rai::RepWeightsSnapshot>()),
+      queue_(rai::Elections::MAX_QUEUED_ELECTIONS),
+      admitted_(0),
+      confirmed_(0),
       stopped_(false),
       thread_([this]() { this->Run(); })
 
@@ -189,11 +555,7 @@ void rai::Elections::Add(const std::vector<std::shared_ptr<rai::Block>>& blocks)
             {
                 return;
             }
-            else if (it->height_ > height)
-            {
-                elections_.erase(it);
-            }
-            else
+            else if (it->height_ == height)
             {
                 for (const auto& i : blocks)
                 {
@@ -201,20 +563,22 @@ void rai::Elections::Add(const std::vector<std::shared_ptr<rai::Block>>& blocks)
                 }
                 return;
             }
-        }
 
-        rai::Election election;
-        election.account_ = account;
-        election.height_  = height;
-        for (const auto& i : blocks)
+            // the replacement takes over the slot, admitting from the
+            // backlog first would leave it queued or dropped
+            elections_.erase(it);
+            queue_.Erase(account);
+            Start_(account, height, blocks);
+        }
+        else if (elections_.size() < rai::Elections::MAX_ACTIVE_ELECTIONS
+                 && queue_.Empty())
         {
-            election.AddBlock(i);
+            Start_(account, height, blocks);
         }
-        elections_.insert(election);
-        if (!election.ForkFound())
+        else
         {
-            node_.RequestConfirms(blocks[0],
-                                  std::unordered_set<rai::Account>());
+            queue_.Push(account, height, blocks);
+            Admit_();
         }
     }
 
@@ -329,6 +693,8 @@ bool rai::Elections::Get(const rai::Account& account, rai::Ptree& ptree) const
         last_vote.put("block", vote.second.last_vote_.hash_.StringHex());
         last_vote.put("signature",
                       vote.second.last_vote_.signature_.StringHex());
+        last_vote.put("batch",
+                      vote.second.last_vote_.batch_ ? "true" : "false");
         entry.put_child("last_vote", last_vote);
 
         if (vote.second.conflict_found_)
@@ -375,6 +741,15 @@ void rai::Elections::Run()
             continue;
         }
 
+        if (queue_.Empty() && queue_.EvictedSize() > 0)
+        {
+            auto evicted = queue_.Evicted(rai::Elections::MAX_RETRY_BATCH);
+            lock.unlock();
+            Retry_(evicted);
+            lock.lock();
+            continue;
+        }
+
         if (elections_.empty())
         {
             condition_.wait(lock);
@@ -424,7 +799,7 @@ void rai::Elections::ProcessElection(const rai::Election& election,
         rai::Stats::Add(rai::ErrorCode::ELECTION_TALLY,
                         "account=", election.account_.StringAccount(),
                         ", height=", election.height_);
-        elections_.erase(election.account_);
+        Erase_(election.account_, false);
         return;
     }
 
@@ -433,7 +808,7 @@ void rai::Elections::ProcessElection(const rai::Election& election,
         if (status.confirm_)
         {
             node_.ForceConfirmBlock(status.block_);
-            elections_.erase(election.account_);
+            Erase_(election.account_, true);
             return;
         }
 
@@ -496,7 +871,7 @@ void rai::Elections::ProcessElection(const rai::Election& election,
     if (election.confirms_ >= rai::FORK_ELECTION_ROUNDS_THRESHOLD)
     {
         node_.ForceConfirmBlock(status.block_);
-        elections_.erase(election.account_);
+        Erase_(election.account_, true);
         return;
     }
     else if (election.wins_ == rai::FORK_ELECTION_ROUNDS_THRESHOLD)
@@ -524,8 +899,59 @@ void rai::Elections::ProcessConfirm(const rai::Account& representative,
     {
         return;
     }
-    const rai::Election& election = *it;
+
     rai::Vote vote(timestamp, signature, block->Hash());
+    ProcessConfirm_(*it, representative, vote, block, weight);
+}
+
+bool rai::Elections::ProcessConfirmBatch(
+    const std::shared_ptr<rai::ConfirmBatchMessage>& message,
+    const rai::Amount& weight)
+{
+    auto votes = rai::Elections::BatchVotes(message, rai::CurrentTimestamp());
+
+    bool relay = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& i : votes)
+    {
+        const rai::ConfirmEntry& entry = i.first;
+        auto it = elections_.find(entry.account_);
+        if (it == elections_.end() || it->height_ != entry.height_)
+        {
+            continue;
+        }
+        const rai::Election& election = *it;
+
+        // The batch only carries block hashes, votes for blocks this node
+        // hasn't seen yet are dropped
+        auto it_block = election.blocks_.find(entry.hash_);
+        if (it_block == election.blocks_.end())
+        {
+            rai::Stats::Add(rai::ErrorCode::ELECTION_CONFIRM_BATCH_MISS);
+            continue;
+        }
+        std::shared_ptr<rai::Block> block(it_block->second.block_);
+
+        bool accepted = ProcessConfirm_(election, message->representative_,
+                                        i.second, block, weight);
+        if (accepted && election.ForkFound())
+        {
+            relay = true;
+        }
+    }
+
+    return relay && weight >= rai::QUALIFIED_REP_WEIGHT;
+}
+
+bool rai::Elections::ProcessConfirm_(const rai::Election& election,
+                                     const rai::Account& representative,
+                                     const rai::Vote& vote,
+                                     const std::shared_ptr<rai::Block>& block,
+                                     const rai::Amount& weight)
+{
+    // A vote received in a batch is relayed with its batch by the caller
+    bool broadcast =
+        election.ForkFound() && weight >= rai::QUALIFIED_REP_WEIGHT;
 
     auto it_info = election.votes_.find(representative);
     if (it_info == election.votes_.end())
@@ -534,18 +960,18 @@ void rai::Elections::ProcessConfirm(const rai::Account& representative,
         AddRepVoteInfo_(election, representative, info);
         AddBlock_(election, block);
 
-        if (election.ForkFound() && weight >= rai::QUALIFIED_REP_WEIGHT)
+        if (broadcast && !vote.batch_)
         {
-            node_.BroadcastConfirm(representative, timestamp, signature, block);
+            BroadcastVote_(representative, vote, block);
         }
-        return;
+        return true;
     }
 
     if (it_info->second.conflict_found_)
     {
-        return;
+        return false;
     }
-    const rai::Vote& last_vote = it_info->second.last_vote_;
+    const rai::Vote last_vote = it_info->second.last_vote_;
 
     if (CheckConflict_(last_vote, vote))
     {
@@ -553,25 +979,31 @@ void rai::Elections::ProcessConfirm(const rai::Account& representative,
         AddRepVoteInfo_(election, representative, info);
         AddConflict_(election, representative, vote);
         AddBlock_(election, block);
-        if (election.ForkFound() && weight >= rai::QUALIFIED_REP_WEIGHT)
+        if (broadcast)
         {
             std::shared_ptr<rai::Block> last_block(nullptr);
             bool error = GetBlock_(election, last_vote.hash_, last_block);
             if (error)
             {
                 assert(0);
-                return;
+                return true;
+            }
+            if (!vote.batch_)
+            {
+                BroadcastConflict_(representative, last_vote, vote,
+                                   last_block, block);
+            }
+            else if (last_vote.batch_ != vote.batch_)
+            {
+                BroadcastVote_(representative, last_vote, last_block);
             }
-            node_.BroadcastConflict(representative, last_vote.timestamp_,
-                                    timestamp, last_vote.signature_, signature,
-                                    last_block, block);
         }
-        return;
+        return true;
     }
 
-    if (last_vote.timestamp_ >= timestamp)
+    if (last_vote.timestamp_ >= vote.timestamp_)
     {
-        return;
+        return false;
     }
 
     DelBlock_(election, last_vote.hash_);
@@ -579,10 +1011,11 @@ void rai::Elections::ProcessConfirm(const rai::Account& representative,
     AddRepVoteInfo_(election, representative, info);
     AddBlock_(election, block);
 
-    if (election.ForkFound() && weight >= rai::QUALIFIED_REP_WEIGHT)
+    if (broadcast && !vote.batch_)
     {
-        node_.BroadcastConfirm(representative, timestamp, signature, block);
+        BroadcastVote_(representative, vote, block);
     }
+    return true;
 }
 
 void rai::Elections::ProcessConflict(
@@ -647,6 +1080,158 @@ size_t rai::Elections::Size() const
     return elections_.size();
 }
 
+rai::Ptree rai::Elections::Status() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t now = rai::CurrentTimestamp();
+    size_t recent = 0;
+    for (auto i = confirmations_.rbegin(), n = confirmations_.rend(); i != n;
+         ++i)
+    {
+        if (*i + rai::Elections::CONFIRMATION_RATE_WINDOW <= now)
+        {
+            break;
+        }
+        ++recent;
+    }
+
+    rai::Ptree ptree;
+    ptree.put("active", std::to_string(elections_.size()));
+    ptree.put("queued", std::to_string(queue_.Size()));
+    ptree.put("evicted", std::to_string(queue_.EvictedSize()));
+    ptree.put("max_active",
+              std::to_string(rai::Elections::MAX_ACTIVE_ELECTIONS));
+    ptree.put("max_queued",
+              std::to_string(rai::Elections::MAX_QUEUED_ELECTIONS));
+    ptree.put("admitted", std::to_string(admitted_));
+    ptree.put("dropped", std::to_string(queue_.Dropped()));
+    ptree.put("confirmed", std::to_string(confirmed_));
+    ptree.put("confirmations_per_second",
+              std::to_string(static_cast<double>(recent)
+                             / rai::Elections::CONFIRMATION_RATE_WINDOW));
+    return ptree;
+}
+
+std::vector<std::pair<rai::ConfirmEntry, rai::Vote>> rai::Elections::BatchVotes(
+    const std::shared_ptr<rai::ConfirmBatchMessage>& message, uint64_t now)
+{
+    std::vector<std::pair<rai::ConfirmEntry, rai::Vote>> result;
+    for (const auto& i : message->entries_)
+    {
+        if (i.timestamp_ > now + rai::MAX_TIMESTAMP_DIFF * 2
+            || i.timestamp_ < now - rai::MAX_TIMESTAMP_DIFF * 2)
+        {
+            rai::Stats::Add(rai::ErrorCode::MESSAGE_CONFIRM_TIMESTAMP);
+            continue;
+        }
+        result.emplace_back(i, rai::Vote(i, message));
+    }
+    return result;
+}
+
+void rai::Elections::Start_(
+    const rai::Account& account, uint64_t height,
+    const std::vector<std::shared_ptr<rai::Block>>& blocks)
+{
+    rai::Election election;
+    election.account_ = account;
+    election.height_  = height;
+    for (const auto& i : blocks)
+    {
+        election.AddBlock(i);
+    }
+    elections_.insert(election);
+    ++admitted_;
+    if (!election.ForkFound())
+    {
+        node_.RequestConfirms(blocks[0], std::unordered_set<rai::Account>());
+    }
+}
+
+void rai::Elections::Erase_(const rai::Account& account, bool confirmed)
+{
+    elections_.erase(account);
+    if (confirmed)
+    {
+        ++confirmed_;
+        uint64_t now = rai::CurrentTimestamp();
+        confirmations_.push_back(now);
+        while (!confirmations_.empty()
+               && confirmations_.front()
+                          + rai::Elections::CONFIRMATION_RATE_WINDOW
+                      <= now)
+        {
+            confirmations_.pop_front();
+        }
+    }
+    Admit_();
+}
+
+void rai::Elections::Admit_()
+{
+    // an account already active is admitted after its election ends
+    auto active = [this](const rai::Account& account) {
+        return elections_.find(account) != elections_.end();
+    };
+    rai::QueuedElection queued;
+    while (elections_.size() < rai::Elections::MAX_ACTIVE_ELECTIONS
+           && !queue_.Pop(active, queued))
+    {
+        Start_(queued.account_, queued.height_, queued.blocks_);
+    }
+}
+
+void rai::Elections::Retry_(
+    const std::vector<std::pair<rai::Account, uint64_t>>& evicted)
+{
+    std::vector<std::shared_ptr<rai::Block>> blocks;
+    {
+        rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+        rai::Transaction transaction(error_code, node_.ledger_, false);
+        if (error_code != rai::ErrorCode::SUCCESS)
+        {
+            rai::Stats::Add(error_code, "Elections::Retry_");
+            return;
+        }
+
+        for (const auto& i : evicted)
+        {
+            rai::AccountInfo info;
+            bool error =
+                node_.ledger_.AccountInfoGet(transaction, i.first, info);
+            if (error || !info.Valid())
+            {
+                continue;
+            }
+
+            // the evicted block may have been confirmed or rolled back since,
+            // elect the lowest unconfirmed one
+            uint64_t height = info.tail_height_;
+            if (info.confirmed_height_ != rai::Block::INVALID_HEIGHT)
+            {
+                height = info.confirmed_height_ + 1;
+            }
+            if (height > info.head_height_)
+            {
+                continue;
+            }
+
+            std::shared_ptr<rai::Block> block(nullptr);
+            error = node_.ledger_.BlockGet(transaction, i.first, height, block);
+            if (error)
+            {
+                continue;
+            }
+            blocks.push_back(block);
+        }
+    }
+
+    for (const auto& i : blocks)
+    {
+        Add(i);
+    }
+}
+
 void rai::Elections::AddBlock_(const rai::Election& election,
                                const std::shared_ptr<rai::Block>& block)
 {
@@ -729,8 +1314,10 @@ void rai::Elections::AddRepVoteInfo_(const rai::Election& election,
     auto it = elections_.find(election.account_);
     if (it != elections_.end())
     {
+        rai::Amount weight = RepWeight_(representative);
+        bool online = online_reps_.find(representative) != online_reps_.end();
         elections_.modify(it, [&](rai::Election& data) {
-            data.votes_[representative] = rep_vote_info;
+            data.SetVote(representative, rep_vote_info, weight, online);
         });
     }
 }
@@ -850,77 +1437,52 @@ rai::ElectionStatus rai::Elections::Tally_(const rai::Election& election,
                                            uint64_t time_diff) const
 {
     rai::ElectionStatus result;
-    std::unordered_set<rai::Account> reps_not_voting(online_reps_);
-    std::unordered_map<rai::BlockHash, rai::Amount> candidates;
-
-    for (const auto& vote : election.votes_)
+    result.conflict_ = election.tally_conflict_;
+    result.invalid_ = election.tally_conflict_;
+    if (weight_online_ > election.tally_online_)
     {
-        reps_not_voting.erase(vote.first);
+        result.not_voting_ = weight_online_ - election.tally_online_;
+    }
 
-        auto it = weights_.find(vote.first);
-        if (it == weights_.end())
+    uint64_t now = rai::CurrentTimestamp();
+    const rai::BlockHash* first = nullptr;
+    rai::Amount first_weight(0);
+    rai::Amount second_weight(0);
+    for (const auto& i : election.candidates_)
+    {
+        rai::Amount adjust = i.second.Weight(now, time_diff);
+        rai::Amount loss(i.second.total_ - adjust);
+        if (!loss.IsZero())
         {
-            continue;
+            result.invalid_ += loss;
         }
 
-        if (vote.second.conflict_found_)
+        if (adjust.IsZero())
         {
-            result.conflict_ += it->second;
-            result.invalid_ += it->second;
             continue;
         }
+        result.valid_ += adjust;
 
-        uint64_t factor = vote.second.WeightFactor(time_diff);
-        rai::uint256_t weight(it->second.Number());
-        weight = weight * factor / 100;
-        rai::Amount adjust(static_cast<rai::uint128_t>(weight));
-        rai::Amount loss(it->second - adjust);
-
-        if (!adjust.IsZero())
+        if (first == nullptr || adjust > first_weight
+            || (adjust == first_weight && i.first > *first))
         {
-            candidates[vote.second.last_vote_.hash_] += adjust;
-            result.valid_ += adjust;
+            second_weight = first_weight;
+            first_weight = adjust;
+            first = &i.first;
         }
-
-        if (!loss.IsZero())
+        else if (adjust > second_weight)
         {
-            result.invalid_ += loss;
+            second_weight = adjust;
         }
     }
 
-    for (const auto& i : reps_not_voting)
-    {
-        auto it = weights_.find(i);
-        if (it == weights_.end())
-        {
-            continue;
-        }
-        result.not_voting_ += it->second;
-    }
-
-    if (candidates.empty())
+    if (first == nullptr)
     {
         return result;
     }
 
-    std::vector<std::pair<rai::BlockHash, rai::Amount>> vec(candidates.begin(),
-                                                            candidates.end());
-    std::sort(vec.begin(), vec.end(),
-              [](const std::pair<rai::BlockHash, rai::Amount>& lhs,
-                 const std::pair<rai::BlockHash, rai::Amount>& rhs) {
-                  if (lhs.second != rhs.second)
-                  {
-                      return lhs.second > rhs.second;
-                  }
-                  return lhs.first > rhs.first;
-              });
-
-    rai::uint256_t first_s(vec[0].second.Number());
-    rai::uint256_t second_s(0);
-    if (vec.size() > 1)
-    {
-        second_s = vec[1].second.Number();
-    }
+    rai::uint256_t first_s(first_weight.Number());
+    rai::uint256_t second_s(second_weight.Number());
     rai::uint256_t total_s(weight_total_.Number());
     result.confirm_ = first_s * 100 > total_s * rai::CONFIRM_WEIGHT_PERCENTAGE;
     result.win_ =
@@ -931,7 +1493,7 @@ rai::ElectionStatus rai::Elections::Tally_(const rai::Election& election,
             && election.rounds_fork_ > rai::FORK_ELECTION_ROUNDS_THRESHOLD * 2
             && first_s > second_s);
 
-    auto it = election.blocks_.find(vec[0].first);
+    auto it = election.blocks_.find(*first);
     if (it == election.blocks_.end())
     {
         assert(0);
@@ -988,8 +1550,7 @@ void rai::Elections::BroadcastConfirms_(const rai::Election& election)
 
         if (!info.conflict_found_)
         {
-            node_.BroadcastConfirm(rep, vote.timestamp_, vote.signature_,
-                                   block);
+            BroadcastVote_(rep, vote, block);
             continue;
         }
 
@@ -1011,9 +1572,42 @@ void rai::Elections::BroadcastConfirms_(const rai::Election& election)
             continue;
         }
 
-        node_.BroadcastConflict(rep, vote.timestamp_, conflict.timestamp_,
-                                vote.signature_, conflict.signature_, block,
-                                block_conflict);
+        BroadcastConflict_(rep, vote, conflict, block, block_conflict);
+    }
+}
+
+void rai::Elections::BroadcastVote_(const rai::Account& representative,
+                                    const rai::Vote& vote,
+                                    const std::shared_ptr<rai::Block>& block)
+{
+    if (vote.batch_)
+    {
+        node_.BroadcastConfirmBatch(vote.batch_);
+        return;
+    }
+    node_.BroadcastConfirm(representative, vote.timestamp_, vote.signature_,
+                           block);
+}
+
+// A conflict message can only carry two single votes, a batched vote is
+// proven by relaying its batch next to the other vote so that peers detect
+// the conflict themselves
+void rai::Elections::BroadcastConflict_(
+    const rai::Account& representative, const rai::Vote& first,
+    const rai::Vote& second, const std::shared_ptr<rai::Block>& block_first,
+    const std::shared_ptr<rai::Block>& block_second)
+{
+    if (!first.batch_ && !second.batch_)
+    {
+        node_.BroadcastConflict(representative, first.timestamp_,
+                                second.timestamp_, first.signature_,
+                                second.signature_, block_first, block_second);
+        return;
+    }
+    BroadcastVote_(representative, first, block_first);
+    if (second.batch_ != first.batch_)
+    {
+        BroadcastVote_(representative, second, block_second);
     }
 }
 
@@ -1059,24 +1653,98 @@ void rai::Elections::UpdateWeightInfo_(std::unique_lock<std::mutex>& lock)
     lock.unlock();
 
     auto online_reps = node_.peers_.Accounts(false);
-    rai::RepWeights rep_weights;
-    node_.RepWeights(rep_weights);
-    rai::Amount weight_total = rep_weights.total_;
+    auto rep_weights = node_.RepWeights();
     rai::Amount weight_online(0);
     for (const auto& i : online_reps)
     {
-        auto it = rep_weights.weights_.find(i);
-        if (it != rep_weights.weights_.end())
+        rai::Amount weight(0);
+        if (!rep_weights->Get(i, weight))
         {
-            weight_online += it->second;
+            weight_online += weight;
+        }
+    }
+
+    // weights_ and online_reps_ are only written by this thread, so the diff
+    // against the new snapshot can be computed without holding the lock
+    std::vector<rai::RepTallyChange> changes;
+    auto add_change = [&](const rai::Account& rep) {
+        rai::RepTallyChange change;
+        change.representative_ = rep;
+        change.weight_old_ = RepWeight_(rep);
+        change.weight_new_ = 0;
+        rep_weights->Get(rep, change.weight_new_);
+        change.online_old_ = online_reps_.find(rep) != online_reps_.end();
+        change.online_new_ = online_reps.find(rep) != online_reps.end();
+        if (change.weight_old_ != change.weight_new_
+            || (change.online_old_ != change.online_new_
+                && !change.weight_new_.IsZero()))
+        {
+            changes.push_back(change);
+        }
+    };
+    if (rep_weights->version_ != weights_->version_)
+    {
+        for (const auto& i : rep_weights->weights_)
+        {
+            add_change(i.first);
+        }
+        for (const auto& i : weights_->weights_)
+        {
+            if (rep_weights->weights_.find(i.first)
+                == rep_weights->weights_.end())
+            {
+                add_change(i.first);
+            }
+        }
+    }
+    else
+    {
+        // Same weights, only the reps going online/offline matter
+        for (const auto& i : online_reps)
+        {
+            if (online_reps_.find(i) == online_reps_.end())
+            {
+                add_change(i);
+            }
+        }
+        for (const auto& i : online_reps_)
+        {
+            if (online_reps.find(i) == online_reps.end())
+            {
+                add_change(i);
+            }
         }
     }
 
     lock.lock();
     online_reps_ = std::move(online_reps);
-    weight_total_ = rep_weights.total_;
+    weight_total_ = rep_weights->total_;
     weight_online_ = weight_online;
-    weights_ = std::move(rep_weights.weights_);
+    weights_ = std::move(rep_weights);
+    UpdateTallies_(changes);
+}
+
+void rai::Elections::UpdateTallies_(
+    const std::vector<rai::RepTallyChange>& changes)
+{
+    if (changes.empty())
+    {
+        return;
+    }
+
+    for (auto it = elections_.begin(); it != elections_.end(); ++it)
+    {
+        elections_.modify(it, [&changes](rai::Election& data) {
+            data.TallyUpdate(changes);
+        });
+    }
+}
+
+rai::Amount rai::Elections::RepWeight_(const rai::Account& representative) const
+{
+    rai::Amount weight(0);
+    weights_->Get(representative, weight);
+    return weight;
 }
 
 bool rai::Elections::EnoughOnlineWeight_() const
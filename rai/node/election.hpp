@@ -4,9 +4,14 @@
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index_container.hpp>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
 #include <rai/common/blocks.hpp>
 #include <rai/common/numbers.hpp>
 #include <rai/common/util.hpp>
+#include <rai/node/message.hpp>
+#include <rai/secure/ledger.hpp>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -19,10 +24,15 @@ class Vote
 public:
     Vote();
     Vote(uint64_t, const rai::Signature&, const rai::BlockHash&);
+    Vote(const rai::ConfirmEntry&,
+         const std::shared_ptr<rai::ConfirmBatchMessage>&);
 
     uint64_t timestamp_;
     rai::Signature signature_;
     rai::BlockHash hash_;
+    // The batch the vote came in, signature_ covers the whole batch so the
+    // vote can only be proven by relaying it
+    std::shared_ptr<rai::ConfirmBatchMessage> batch_;
 };
 
 class RepVoteInfo
@@ -31,6 +41,7 @@ public:
     RepVoteInfo();
     RepVoteInfo(bool, const rai::Amount&, const rai::Vote&);
     uint64_t WeightFactor(uint64_t) const;
+    static uint64_t WeightFactor(uint64_t, uint64_t, uint64_t);
 
     bool conflict_found_;
     rai::Amount weight_;
@@ -44,6 +55,34 @@ public:
     std::shared_ptr<rai::Block> block_;
 };
 
+// Running weight of the votes for one candidate block, bucketed by vote
+// timestamp so that the time decay only touches the stale buckets
+class CandidateTally
+{
+public:
+    CandidateTally();
+    void Add(uint64_t, const rai::Amount&);
+    void Del(uint64_t, const rai::Amount&);
+    bool Empty() const;
+    rai::Amount Weight(uint64_t, uint64_t) const;
+
+    rai::Amount total_;
+    std::map<uint64_t, rai::Amount> timestamps_;
+
+private:
+    static rai::Amount Loss_(uint64_t, uint64_t, uint64_t, const rai::Amount&);
+};
+
+class RepTallyChange
+{
+public:
+    rai::Account representative_;
+    rai::Amount weight_old_;
+    rai::Amount weight_new_;
+    bool online_old_;
+    bool online_new_;
+};
+
 class Election
 {
 public:
@@ -52,6 +91,11 @@ public:
     void AddBlock(const std::shared_ptr<rai::Block>&);
     void DelBlock(const rai::BlockHash&);
     bool ForkFound() const;
+    void TallyAdd(const rai::RepVoteInfo&, const rai::Amount&, bool);
+    void TallyDel(const rai::RepVoteInfo&, const rai::Amount&, bool);
+    void SetVote(const rai::Account&, const rai::RepVoteInfo&,
+                 const rai::Amount&, bool);
+    void TallyUpdate(const std::vector<rai::RepTallyChange>&);
 
     rai::Account account_;
     uint64_t height_;
@@ -67,6 +111,74 @@ public:
     std::unordered_map<rai::BlockHash, rai::BlockReference> blocks_;
     std::unordered_map<rai::Account, rai::RepVoteInfo> votes_;
     std::unordered_map<rai::Account, rai::Vote> conflicts_;
+
+    // Incremental tally, kept in sync with votes_ and Elections::weights_
+    rai::Amount tally_conflict_;
+    rai::Amount tally_online_;
+    std::unordered_map<rai::BlockHash, rai::CandidateTally> candidates_;
+};
+
+// Higher priority elections are admitted first when the active set is full:
+// forks, then higher credit, then higher balance, then older
+class ElectionPriority
+{
+public:
+    ElectionPriority();
+    ElectionPriority(const std::vector<std::shared_ptr<rai::Block>>&, uint64_t);
+    bool operator>(const rai::ElectionPriority&) const;
+
+    bool fork_;
+    uint16_t credit_;
+    rai::Amount balance_;
+    uint64_t sequence_;
+};
+
+class QueuedElection
+{
+public:
+    rai::Account account_;
+    uint64_t height_;
+    rai::ElectionPriority priority_;
+    std::vector<std::shared_ptr<rai::Block>> blocks_;
+};
+
+// Elections waiting for a free slot, one per account. When full the lowest
+// priority entry is dropped and its account remembered as evicted, to be
+// started again from the ledger once the backlog has drained.
+class ElectionBacklog
+{
+public:
+    ElectionBacklog(size_t);
+    void Push(const rai::Account&, uint64_t,
+              const std::vector<std::shared_ptr<rai::Block>>&);
+    // highest priority entry whose account isn't skipped, true if none
+    bool Pop(const std::function<bool(const rai::Account&)>&,
+             rai::QueuedElection&);
+    void Erase(const rai::Account&);
+    std::vector<std::pair<rai::Account, uint64_t>> Evicted(size_t);
+    bool Empty() const;
+    size_t Size() const;
+    size_t EvictedSize() const;
+    uint64_t Dropped() const;
+
+private:
+    void Evict_(const rai::Account&, uint64_t);
+
+    size_t max_;
+    uint64_t sequence_;
+    uint64_t dropped_;
+    boost::multi_index_container<
+        QueuedElection,
+        boost::multi_index::indexed_by<
+            boost::multi_index::hashed_unique<boost::multi_index::member<
+                QueuedElection, rai::Account, &QueuedElection::account_>>,
+            boost::multi_index::ordered_non_unique<
+                boost::multi_index::member<QueuedElection,
+                                           rai::ElectionPriority,
+                                           &QueuedElection::priority_>,
+                std::greater<rai::ElectionPriority>>>>
+        queue_;
+    std::unordered_map<rai::Account, uint64_t> evicted_;
 };
 
 class ElectionStatus
@@ -104,8 +216,18 @@ public:
                          const std::shared_ptr<rai::Block>&,
                          const std::shared_ptr<rai::Block>&,
                          const rai::Amount&);
+    bool ProcessConfirmBatch(const std::shared_ptr<rai::ConfirmBatchMessage>&,
+                             const rai::Amount&);
     size_t Size() const;
+    rai::Ptree Status() const;
+
+    static std::vector<std::pair<rai::ConfirmEntry, rai::Vote>> BatchVotes(
+        const std::shared_ptr<rai::ConfirmBatchMessage>&, uint64_t);
 
+    static size_t constexpr MAX_ACTIVE_ELECTIONS = 5000;
+    static size_t constexpr MAX_QUEUED_ELECTIONS = 100000;
+    static size_t constexpr MAX_RETRY_BATCH = 1024;
+    static uint64_t constexpr CONFIRMATION_RATE_WINDOW = 60;
     static std::chrono::seconds constexpr FORK_ELECTION_DELAY =
         std::chrono::seconds(32);
     static std::chrono::seconds constexpr FORK_ELECTION_INTERVAL =
@@ -116,6 +238,14 @@ public:
         std::chrono::seconds(1);
 
 private:
+    void Start_(const rai::Account&, uint64_t,
+                const std::vector<std::shared_ptr<rai::Block>>&);
+    void Erase_(const rai::Account&, bool);
+    void Admit_();
+    void Retry_(const std::vector<std::pair<rai::Account, uint64_t>>&);
+    bool ProcessConfirm_(const rai::Election&, const rai::Account&,
+                         const rai::Vote&, const std::shared_ptr<rai::Block>&,
+                         const rai::Amount&);
     void AddBlock_(const rai::Election&, const std::shared_ptr<rai::Block>&);
     void DelBlock_(const rai::Election&, const rai::BlockHash&);
     bool GetBlock_(const rai::Election&, const rai::BlockHash&,
@@ -139,9 +269,17 @@ private:
     rai::ElectionStatus Tally_(const rai::Election&, uint64_t) const;
     void RequestConfirms_(const rai::Election&);
     void BroadcastConfirms_(const rai::Election&);
+    void BroadcastVote_(const rai::Account&, const rai::Vote&,
+                        const std::shared_ptr<rai::Block>&);
+    void BroadcastConflict_(const rai::Account&, const rai::Vote&,
+                            const rai::Vote&,
+                            const std::shared_ptr<rai::Block>&,
+                            const std::shared_ptr<rai::Block>&);
     std::chrono::steady_clock::time_point NextWakeup_(
         const rai::Election&) const;
     void UpdateWeightInfo_(std::unique_lock<std::mutex>&);
+    void UpdateTallies_(const std::vector<rai::RepTallyChange>&);
+    rai::Amount RepWeight_(const rai::Account&) const;
     bool EnoughOnlineWeight_() const;
     bool EnoughVotingWeight_(const rai::Amount&) const;
 
@@ -151,7 +289,7 @@ private:
     std::unordered_set<rai::Account> online_reps_;
     rai::Amount weight_total_;
     rai::Amount weight_online_;
-    std::unordered_map<rai::Account, rai::Amount> weights_;
+    std::shared_ptr<const rai::RepWeightsSnapshot> weights_;
 
     boost::multi_index_container<
         Election,
@@ -162,6 +300,11 @@ private:
                 Election, std::chrono::steady_clock::time_point,
                 &Election::wakeup_>>>>
         elections_;
+
+    rai::ElectionBacklog queue_;
+    uint64_t admitted_;
+    uint64_t confirmed_;
+    std::deque<uint64_t> confirmations_;
     bool stopped_;
 
     std::condition_variable condition_;
@@ -574,7 +574,8 @@ rai::ConfirmMessage::ConfirmMessage(rai::ErrorCode& error_code,
         return;
     }
 
-    bool error = rai::ValidateMessage(representative_, Hash(), signature_);
+    bool error =
+        rai::ValidateMessageCached(representative_, Hash(), signature_);
     if (error)
     {
         error_code = rai::ErrorCode::MESSAGE_CONFIRM_SIGNATURE;
@@ -665,6 +666,144 @@ void rai::ConfirmMessage::SetSignature(const rai::Signature& signature)
     signature_ = signature;
 }
 
+rai::ConfirmEntry::ConfirmEntry()
+    : account_(0), height_(0), timestamp_(0), hash_(0)
+{
+}
+
+rai::ConfirmEntry::ConfirmEntry(const rai::Account& account, uint64_t height,
+                                uint64_t timestamp, const rai::BlockHash& hash)
+    : account_(account), height_(height), timestamp_(timestamp), hash_(hash)
+{
+}
+
+void rai::ConfirmEntry::Serialize(rai::Stream& stream) const
+{
+    rai::Write(stream, account_.bytes);
+    rai::Write(stream, height_);
+    rai::Write(stream, timestamp_);
+    rai::Write(stream, hash_.bytes);
+}
+
+bool rai::ConfirmEntry::Deserialize(rai::Stream& stream)
+{
+    bool error = rai::Read(stream, account_.bytes);
+    IF_ERROR_RETURN(error, true);
+    error = rai::Read(stream, height_);
+    IF_ERROR_RETURN(error, true);
+    error = rai::Read(stream, timestamp_);
+    IF_ERROR_RETURN(error, true);
+    error = rai::Read(stream, hash_.bytes);
+    IF_ERROR_RETURN(error, true);
+    return false;
+}
+
+rai::ConfirmBatchMessage::ConfirmBatchMessage(rai::ErrorCode& error_code,
+                                              rai::Stream& stream,
+                                              const rai::MessageHeader& header)
+    : Message(header)
+{
+    error_code = Deserialize(stream);
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        return;
+    }
+
+    bool error =
+        rai::ValidateMessageCached(representative_, Hash(), signature_);
+    if (error)
+    {
+        error_code = rai::ErrorCode::MESSAGE_CONFIRM_BATCH_SIGNATURE;
+    }
+}
+
+rai::ConfirmBatchMessage::ConfirmBatchMessage(
+    const rai::Account& representative,
+    const std::vector<rai::ConfirmEntry>& entries)
+    : Message(rai::MessageType::CONFIRM_BATCH,
+              static_cast<uint16_t>(entries.size())),
+      representative_(representative),
+      entries_(entries)
+{
+    assert(!entries.empty() && entries.size() <= MAX_ENTRIES);
+}
+
+void rai::ConfirmBatchMessage::Serialize(rai::Stream& stream) const
+{
+    header_.Serialize(stream);
+    rai::Write(stream, representative_.bytes);
+    rai::Write(stream, signature_.bytes);
+    for (const auto& i : entries_)
+    {
+        i.Serialize(stream);
+    }
+}
+
+rai::ErrorCode rai::ConfirmBatchMessage::Deserialize(rai::Stream& stream)
+{
+    bool error = false;
+    size_t count = header_.extension_;
+    if (count == 0 || count > rai::ConfirmBatchMessage::MAX_ENTRIES)
+    {
+        return rai::ErrorCode::MESSAGE_CONFIRM_BATCH_SIZE;
+    }
+
+    error = rai::Read(stream, representative_.bytes);
+    IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+
+    error = rai::Read(stream, signature_.bytes);
+    IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+
+    entries_.clear();
+    entries_.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        rai::ConfirmEntry entry;
+        error = entry.Deserialize(stream);
+        IF_ERROR_RETURN(error, rai::ErrorCode::STREAM);
+        entries_.push_back(entry);
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+void rai::ConfirmBatchMessage::Visit(rai::MessageVisitor& visitor)
+{
+    visitor.ConfirmBatch(*this);
+}
+
+rai::BlockHash rai::ConfirmBatchMessage::Hash() const
+{
+    rai::BlockHash result;
+    blake2b_state state;
+
+    auto ret = blake2b_init(&state, sizeof(result.bytes));
+    assert(0 == ret);
+
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        rai::Write(stream, header_.type_);
+        rai::Write(stream, representative_.bytes);
+        rai::Write(stream, static_cast<uint16_t>(entries_.size()));
+        for (const auto& i : entries_)
+        {
+            i.Serialize(stream);
+        }
+    }
+    ret = blake2b_update(&state, bytes.data(), bytes.size());
+    assert(0 == ret);
+
+    ret = blake2b_final(&state, result.bytes.data(), result.bytes.size());
+    assert(0 == ret);
+    return result;
+}
+
+void rai::ConfirmBatchMessage::SetSignature(const rai::Signature& signature)
+{
+    signature_ = signature;
+}
+
 rai::QueryMessage::QueryMessage(rai::ErrorCode& error_code, rai::Stream& stream,
                                 const rai::MessageHeader& header)
     : Message(header)
@@ -1047,14 +1186,14 @@ rai::ErrorCode rai::ConflictMessage::Check_() const
 
     rai::BlockHash hash_first =
         Hash_(timestamp_first_, representative_, *block_first_);
-    bool error =
-        rai::ValidateMessage(representative_, hash_first, signature_first_);
+    bool error = rai::ValidateMessageCached(representative_, hash_first,
+                                            signature_first_);
     IF_ERROR_RETURN(error, rai::ErrorCode::MESSAGE_CONFLICT_SIGNATURE);
 
     rai::BlockHash hash_second =
         Hash_(timestamp_second_, representative_, *block_second_);
-    error =
-        rai::ValidateMessage(representative_, hash_second, signature_second_);
+    error = rai::ValidateMessageCached(representative_, hash_second,
+                                       signature_second_);
     IF_ERROR_RETURN(error, rai::ErrorCode::MESSAGE_CONFLICT_SIGNATURE);
 
     return rai::ErrorCode::SUCCESS;
@@ -1192,6 +1331,10 @@ rai::ErrorCode rai::MessageParser::Parse(rai::Stream& stream)
         {
             return Parse<rai::ConflictMessage>(stream, header);
         }
+        case rai::MessageType::CONFIRM_BATCH:
+        {
+            return Parse<rai::ConfirmBatchMessage>(stream, header);
+        }
         default:
         {
             return rai::ErrorCode::UNKNOWN_MESSAGE;
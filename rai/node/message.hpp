@@ -12,7 +12,9 @@
 namespace rai
 {
 uint8_t constexpr PROTOCOL_VERSION_MIN   = 1;
-uint8_t constexpr PROTOCOL_VERSION_USING = 1;
+uint8_t constexpr PROTOCOL_VERSION_USING = 2;
+// Minimum peer version that understands CONFIRM_BATCH
+uint8_t constexpr PROTOCOL_VERSION_CONFIRM_BATCH = 2;
 
 // version 1
 enum class MessageType : uint8_t
@@ -27,6 +29,9 @@ enum class MessageType : uint8_t
     CONFLICT  = 7,
     BOOTSTRAP = 8,
 
+    // version 2
+    CONFIRM_BATCH = 9,
+
     MAX
 };
 
@@ -192,6 +197,45 @@ public:
     std::shared_ptr<rai::Block> block_;
 };
 
+class ConfirmEntry
+{
+public:
+    ConfirmEntry();
+    ConfirmEntry(const rai::Account&, uint64_t, uint64_t,
+                 const rai::BlockHash&);
+    void Serialize(rai::Stream&) const;
+    bool Deserialize(rai::Stream&);
+
+    rai::Account account_;
+    uint64_t height_;
+    uint64_t timestamp_;
+    rai::BlockHash hash_;
+};
+
+// Votes of one representative for several blocks under a single signature,
+// the entry count is carried in the header extension
+class ConfirmBatchMessage : public Message
+{
+public:
+    ConfirmBatchMessage(rai::ErrorCode&, rai::Stream&,
+                        const rai::MessageHeader&);
+    ConfirmBatchMessage(const rai::Account&,
+                        const std::vector<rai::ConfirmEntry>&);
+    virtual ~ConfirmBatchMessage() = default;
+    void Serialize(rai::Stream&) const override;
+    rai::ErrorCode Deserialize(rai::Stream&) override;
+    void Visit(rai::MessageVisitor&) override;
+    rai::BlockHash Hash() const;
+    void SetSignature(const rai::Signature&);
+
+    // Keeps the message within the 1024 bytes UDP buffer
+    static size_t constexpr MAX_ENTRIES = 10;
+
+    rai::Account representative_;
+    rai::Signature signature_;
+    std::vector<rai::ConfirmEntry> entries_;
+};
+
 enum class QueryBy : uint8_t
 {
     INVALID  = 0,
@@ -326,6 +370,7 @@ public:
     virtual void Query(const rai::QueryMessage&)         = 0;
     virtual void Fork(const rai::ForkMessage&)           = 0;
     virtual void Conflict(const rai::ConflictMessage&)   = 0;
+    virtual void ConfirmBatch(const rai::ConfirmBatchMessage&) = 0;
 };
 
 class MessageParser
@@ -11,13 +11,19 @@
 
 std::chrono::seconds constexpr rai::RecentBlocks::AGE_TIME;
 std::chrono::seconds constexpr rai::ActiveAccounts::AGE_TIME;
+uint64_t constexpr rai::NodeConfig::DEFAULT_PRUNING_DEPTH;
+uint64_t constexpr rai::NodeConfig::DEFAULT_SIGNING_KEY_CACHE;
+size_t constexpr rai::Node::PRUNE_BLOCKS_PER_TRANSACTION;
 
 rai::NodeConfig::NodeConfig()
     : port_(rai::Network::DEFAULT_PORT),
       io_threads_(std::max<uint32_t>(4, std::thread::hardware_concurrency())),
       daily_forward_times_(rai::NodeConfig::DEFAULT_DAILY_FORWARD_TIMES),
       enable_rich_list_(false),
-      enable_delegator_list_(false)
+      enable_delegator_list_(false),
+      enable_pruning_(false),
+      pruning_depth_(rai::NodeConfig::DEFAULT_PRUNING_DEPTH),
+      signing_key_cache_(rai::NodeConfig::DEFAULT_SIGNING_KEY_CACHE)
 {
     switch (rai::RAI_NETWORK)
     {
@@ -115,6 +121,43 @@ rai::ErrorCode rai::NodeConfig::DeserializeJson(bool& upgraded,
         {
             enable_delegator_list_ = *enable_delegator_list_o;
         }
+
+        error_code = rai::ErrorCode::JSON_CONFIG_ENABLE_PRUNING;
+        auto enable_pruning_o = ptree.get_optional<bool>("enable_pruning");
+        if (enable_pruning_o)
+        {
+            enable_pruning_ = *enable_pruning_o;
+        }
+
+        error_code = rai::ErrorCode::JSON_CONFIG_PRUNING_DEPTH;
+        auto pruning_depth_o = ptree.get_optional<uint64_t>("pruning_depth");
+        if (pruning_depth_o)
+        {
+            pruning_depth_ = *pruning_depth_o;
+        }
+
+        error_code = rai::ErrorCode::JSON_CONFIG_STORAGE;
+        rai::Ptree& storage_ptree = ptree.get_child("storage");
+        error_code = storage_.DeserializeJson(upgraded, storage_ptree);
+        IF_NOT_SUCCESS_RETURN(error_code);
+
+        error_code = rai::ErrorCode::JSON_CONFIG_SIGNING_KEY_CACHE;
+        auto signing_key_cache_o =
+            ptree.get_optional<uint64_t>("signing_key_cache");
+        if (signing_key_cache_o)
+        {
+            signing_key_cache_ = *signing_key_cache_o;
+        }
+
+        error_code = rai::ErrorCode::JSON_CONFIG_CALLBACK;
+        rai::Ptree& callback_ptree = ptree.get_child("callback");
+        error_code = callback_.DeserializeJson(upgraded, callback_ptree);
+        IF_NOT_SUCCESS_RETURN(error_code);
+
+        error_code = rai::ErrorCode::JSON_CONFIG_WEBSOCKET;
+        rai::Ptree& websocket_ptree = ptree.get_child("websocket");
+        error_code = websocket_.DeserializeJson(upgraded, websocket_ptree);
+        IF_NOT_SUCCESS_RETURN(error_code);
     }
     catch (const std::exception&)
     {
@@ -125,7 +168,7 @@ rai::ErrorCode rai::NodeConfig::DeserializeJson(bool& upgraded,
 
 void rai::NodeConfig::SerializeJson(rai::Ptree& ptree) const
 {
-    ptree.put("version", "3");
+    ptree.put("version", "8");
     ptree.put("port", port_);
     ptree.put("io_threads", io_threads_);
     rai::Ptree log_ptree;
@@ -144,6 +187,18 @@ void rai::NodeConfig::SerializeJson(rai::Ptree& ptree) const
     ptree.put("daily_forward_times", std::to_string(daily_forward_times_));
     ptree.put("enable_rich_list", enable_rich_list_);
     ptree.put("enable_delegator_list", enable_delegator_list_);
+    ptree.put("enable_pruning", enable_pruning_);
+    ptree.put("pruning_depth", pruning_depth_);
+    rai::Ptree storage_ptree;
+    storage_.SerializeJson(storage_ptree);
+    ptree.add_child("storage", storage_ptree);
+    ptree.put("signing_key_cache", signing_key_cache_);
+    rai::Ptree callback_ptree;
+    callback_.SerializeJson(callback_ptree);
+    ptree.add_child("callback", callback_ptree);
+    rai::Ptree websocket_ptree;
+    websocket_.SerializeJson(websocket_ptree);
+    ptree.add_child("websocket", websocket_ptree);
 }
 
 rai::ErrorCode rai::NodeConfig::UpgradeJson(bool& upgraded, uint32_t version,
@@ -165,6 +220,36 @@ rai::ErrorCode rai::NodeConfig::UpgradeJson(bool& upgraded, uint32_t version,
             IF_NOT_SUCCESS_RETURN(error_code);
         }
         case 3:
+        {
+            upgraded = true;
+            error_code = UpgradeV3V4(ptree);
+            IF_NOT_SUCCESS_RETURN(error_code);
+        }
+        case 4:
+        {
+            upgraded = true;
+            error_code = UpgradeV4V5(ptree);
+            IF_NOT_SUCCESS_RETURN(error_code);
+        }
+        case 5:
+        {
+            upgraded = true;
+            error_code = UpgradeV5V6(ptree);
+            IF_NOT_SUCCESS_RETURN(error_code);
+        }
+        case 6:
+        {
+            upgraded = true;
+            error_code = UpgradeV6V7(ptree);
+            IF_NOT_SUCCESS_RETURN(error_code);
+        }
+        case 7:
+        {
+            upgraded = true;
+            error_code = UpgradeV7V8(ptree);
+            IF_NOT_SUCCESS_RETURN(error_code);
+        }
+        case 8:
         {
             break;
         }
@@ -209,6 +294,61 @@ rai::ErrorCode rai::NodeConfig::UpgradeV2V3(rai::Ptree& ptree) const
     return rai::ErrorCode::SUCCESS;
 }
 
+rai::ErrorCode rai::NodeConfig::UpgradeV3V4(rai::Ptree& ptree) const
+{
+    ptree.put("version", 4);
+
+    ptree.put("enable_pruning", enable_pruning_);
+    ptree.put("pruning_depth", pruning_depth_);
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::NodeConfig::UpgradeV4V5(rai::Ptree& ptree) const
+{
+    ptree.put("version", 5);
+
+    rai::Ptree storage_ptree;
+    storage_.SerializeJson(storage_ptree);
+    // upgraded nodes keep their durable storage through bootstrap, only fresh
+    // configs opt in
+    storage_ptree.put("bootstrap_on_sync", false);
+    ptree.add_child("storage", storage_ptree);
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::NodeConfig::UpgradeV5V6(rai::Ptree& ptree) const
+{
+    ptree.put("version", 6);
+
+    ptree.put("signing_key_cache", signing_key_cache_);
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::NodeConfig::UpgradeV6V7(rai::Ptree& ptree) const
+{
+    ptree.put("version", 7);
+
+    rai::Ptree callback_ptree;
+    callback_.SerializeJson(callback_ptree);
+    ptree.add_child("callback", callback_ptree);
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::NodeConfig::UpgradeV7V8(rai::Ptree& ptree) const
+{
+    ptree.put("version", 8);
+
+    rai::Ptree websocket_ptree;
+    websocket_.SerializeJson(websocket_ptree);
+    ptree.add_child("websocket", websocket_ptree);
+
+    return rai::ErrorCode::SUCCESS;
+}
+
 bool rai::RecentBlocks::Insert(const rai::BlockHash& hash)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -501,11 +641,13 @@ rai::Node::Node(rai::ErrorCode& error_code, boost::asio::io_service& service,
                 const boost::filesystem::path& data_path, rai::Alarm& alarm,
                 const rai::NodeConfig& config, rai::Fan& key)
     : status_(rai::NodeStatus::OFFLINE),
+      prune_next_(0),
       config_(config),
       service_(service),
       alarm_(alarm),
       key_(key),
-      store_(error_code, data_path / "data.ldb"),
+      signer_(key, config.signing_key_cache_),
+      store_(error_code, data_path / "data.ldb", config.storage_),
       ledger_(error_code, store_, true, config.enable_rich_list_,
               config.enable_delegator_list_),
       network_(*this, config.port_),
@@ -542,6 +684,18 @@ rai::Node::Node(rai::ErrorCode& error_code, boost::asio::io_service& service,
                 config_.callback_url_.port_, config_.callback_url_.path_,
                 config_.callback_url_.protocol_ == "wss");
         }
+        else if (config_.callback_url_.protocol_ == "http"
+                 || config_.callback_url_.protocol_ == "https")
+        {
+            callback_dispatcher_ = std::make_shared<rai::CallbackDispatcher>(
+                service_, config_.callback_url_, config_.callback_);
+        }
+    }
+
+    if (config_.websocket_.enable_)
+    {
+        websocket_server_ = std::unique_ptr<rai::WebsocketServer>(
+            new rai::WebsocketServer(*this, service_, config_.websocket_));
     }
 
     InitLedger(error_code);
@@ -550,21 +704,53 @@ rai::Node::Node(rai::ErrorCode& error_code, boost::asio::io_service& service,
         return;
     }
 
-    block_processor_.block_observer_ = [this](
-                                     const rai::BlockProcessResult& result,
-                                     const std::shared_ptr<rai::Block>& block) {
-        Background([this, result, block]() {
-            observers_.block_.Notify(result, block);
+    if (callback_dispatcher_ && config_.callback_.outbox_)
+    {
+        callback_outbox_ = std::make_shared<rai::CallbackOutbox>(
+            service_, ledger_, callback_dispatcher_, config_.callback_);
+        error_code = callback_outbox_->Init();
+        if (error_code != rai::ErrorCode::SUCCESS)
+        {
+            return;
+        }
+    }
+
+    block_processor_.events_.Subscribe(
+        "observers",
+        [this](const rai::BlockEvent& event) {
+            if (event.type_ == rai::BlockEventType::PROCESS)
+            {
+                observers_.block_.Notify(event.result_, event.block_);
+            }
+            else if (event.type_ == rai::BlockEventType::RESYNC)
+            {
+                syncer_.Resync();
+                rewarder_.Sync();
+            }
+        },
+        true);
+
+    block_processor_.events_.Subscribe(
+        "notifications", [this](const rai::BlockEvent& event) {
+            if (event.type_ == rai::BlockEventType::FORK)
+            {
+                observers_.fork_.Notify(event.add_, event.block_,
+                                        event.second_);
+            }
+            else
+            {
+                observers_.notify_block_.Notify(event.result_, event.block_);
+            }
         });
-    };
 
-    block_processor_.fork_observer_ =
-        [this](bool add, const std::shared_ptr<rai::Block>& first,
-               const std::shared_ptr<rai::Block>& second) {
-            Background([this, add, first, second]() {
-                observers_.fork_.Notify(add, first, second);
-            });
-        };
+    block_processor_.events_.Subscribe(
+        "dumper", [this](const rai::BlockEvent& event) {
+            if (event.type_ == rai::BlockEventType::PROCESS)
+            {
+                dumpers_.block_.Dump(event.result_, event.block_,
+                                     event.root_);
+            }
+        });
 
     observers_.block_.Add([this](const rai::BlockProcessResult& result,
                                  const std::shared_ptr<rai::Block>& block) {
@@ -606,8 +792,13 @@ void rai::Node::RegisterNetworkHandler()
 void rai::Node::Start()
 {
     RegisterNetworkHandler();
+    block_processor_.events_.Start();
     network_.Start();
     bootstrap_listener_.Start();
+    if (websocket_server_)
+    {
+        websocket_server_->Start();
+    }
     rewarder_.Start();
     Ongoing(std::bind(&rai::Node::ResolvePreconfiguredPeers, this),
             std::chrono::seconds(300));
@@ -624,7 +815,25 @@ void rai::Node::Start()
             std::chrono::seconds(5));
     Ongoing(std::bind(&rai::ConfirmManager::Age, &confirm_manager_),
             std::chrono::seconds(1));
+    Ongoing(std::bind(&rai::Signer::Age, &signer_), std::chrono::seconds(1));
     Ongoing(std::bind(&rai::Node::AgeGapCaches, this), std::chrono::seconds(1));
+    if (callback_dispatcher_)
+    {
+        Ongoing(std::bind(&rai::CallbackDispatcher::Retry,
+                          callback_dispatcher_),
+                std::chrono::seconds(1));
+    }
+    if (callback_outbox_)
+    {
+        Ongoing(std::bind(&rai::CallbackOutbox::Pump, callback_outbox_),
+                std::chrono::seconds(1));
+    }
+    if (websocket_server_)
+    {
+        Ongoing(std::bind(&rai::WebsocketServer::Refresh,
+                          websocket_server_.get()),
+                std::chrono::seconds(60));
+    }
     Ongoing(std::bind(&rai::Subscriptions::Cutoff, &subscriptions_),
             std::chrono::seconds(60));
     if (rewarder_.SendInterval() > 0)
@@ -636,6 +845,16 @@ void rai::Node::Start()
             std::chrono::seconds(600));
     Ongoing(std::bind(&rai::ActiveAccounts::Age, &active_accounts_),
             std::chrono::seconds(10));
+    if (config_.enable_pruning_)
+    {
+        Ongoing(std::bind(&rai::Node::Prune, this), std::chrono::seconds(60));
+    }
+    if (config_.storage_.profile_ != rai::StorageProfile::DURABLE
+        || config_.storage_.bootstrap_on_sync_)
+    {
+        Ongoing(std::bind(&rai::Node::SyncStorage, this),
+                std::chrono::seconds(config_.storage_.sync_interval_));
+    }
     if (websocket_)
     {
         websocket_->message_processor_ =
@@ -685,6 +904,14 @@ void rai::Node::Stop()
     {
         websocket_->Close();
     }
+    if (callback_dispatcher_)
+    {
+        callback_dispatcher_->Stop();
+    }
+    if (websocket_server_)
+    {
+        websocket_server_->Stop();
+    }
     bootstrap_.Stop();
     bootstrap_listener_.Stop();
     alarm_.Stop();
@@ -693,6 +920,8 @@ void rai::Node::Stop()
     block_processor_.Stop();
     block_queries_.Stop();
     elections_.Stop();
+    signer_.Wipe();
+    SyncStorage();
 }
 
 namespace
@@ -985,6 +1214,23 @@ public:
                                         message.block_, weight);
     }
 
+    void ConfirmBatch(const rai::ConfirmBatchMessage& message) override
+    {
+        rai::Amount weight = node_.RepWeight(message.representative_);
+        if (weight < rai::QUALIFIED_REP_WEIGHT)
+        {
+            return;
+        }
+
+        // Kept by the votes of the batch as proof of their signature
+        auto copy = std::make_shared<rai::ConfirmBatchMessage>(message);
+        bool relay = node_.elections_.ProcessConfirmBatch(copy, weight);
+        if (relay)
+        {
+            node_.BroadcastConfirmBatch(copy);
+        }
+    }
+
     void Query(const rai::QueryMessage& message) override
     {
         if (message.GetFlag(rai::MessageFlags::ACK))
@@ -1256,23 +1502,22 @@ void rai::Node::SendByRoute(const rai::Route& route, rai::Message& message)
 }
 
 void rai::Node::SendCallback(const rai::Ptree& notify)
+{
+    if (!config_.callback_url_) return;
+    SendCallback(rai::PtreeToJson(notify));
+}
+
+void rai::Node::SendCallback(std::string&& notify)
 {
     if (!config_.callback_url_) return;
     if (config_.callback_url_.protocol_ == "http"
         || config_.callback_url_.protocol_ == "https")
     {
-        rai::HttpCallback handler = [](rai::ErrorCode error_code,
-                                           const std::string&) {
-            if (error_code != rai::ErrorCode::SUCCESS)
-            {
-                rai::Stats::Add(error_code, "Node::SendCallback");
-            }
-        };
-
-        auto http = std::make_shared<rai::HttpClient>(service_);
-        rai::ErrorCode error_code =
-            http->Post(config_.callback_url_, notify, handler);
-        handler(error_code, "");
+        if (!callback_dispatcher_)
+        {
+            return;
+        }
+        callback_dispatcher_->Send(std::move(notify), nullptr);
     }
     else if (config_.callback_url_.protocol_ == "ws"
              || config_.callback_url_.protocol_ == "wss")
@@ -1285,6 +1530,23 @@ void rai::Node::SendCallback(const rai::Ptree& notify)
     }
 }
 
+void rai::Node::Notify(const rai::Account& account,
+                       rai::SubscriptionEvent event, const rai::Ptree& notify)
+{
+    if (!config_.callback_url_ && !websocket_server_) return;
+    Notify(account, event, rai::PtreeToJson(notify));
+}
+
+void rai::Node::Notify(const rai::Account& account,
+                       rai::SubscriptionEvent event, std::string&& notify)
+{
+    if (websocket_server_)
+    {
+        websocket_server_->Publish(account, event, notify);
+    }
+    SendCallback(std::move(notify));
+}
+
 void rai::Node::Broadcast(rai::Message& message)
 {
     std::vector<rai::Peer> peers =
@@ -1329,13 +1591,15 @@ void rai::Node::BroadcastConfirm(const rai::Account& representative,
     BroadcastAsync(message);
 }
 
+// Votes in fork elections go out at once, each under its own signature so
+// that a double vote can be proven with a conflict message
 void rai::Node::BroadcastConfirm(const rai::Account& account, uint64_t height)
 {
     rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
     rai::Transaction transaction(error_code, ledger_, false);
     if (error_code != rai::ErrorCode::SUCCESS)
     {
-        // stat
+        rai::Stats::Add(error_code, "Node::BroadcastConfirm");
         return;
     }
 
@@ -1352,6 +1616,31 @@ void rai::Node::BroadcastConfirm(const rai::Account& account, uint64_t height)
     BroadcastConfirm(account_, timestamp, Sign(message.Hash()), block);
 }
 
+// Peers older than PROTOCOL_VERSION_CONFIRM_BATCH can't verify the batch
+// signature and are skipped
+void rai::Node::BroadcastConfirmBatch(
+    const std::shared_ptr<rai::ConfirmBatchMessage>& message)
+{
+    std::weak_ptr<rai::Node> node_w(Shared());
+    Background([node_w, message]() {
+        auto node(node_w.lock());
+        if (!node)
+        {
+            return;
+        }
+
+        std::vector<rai::Peer> peers =
+            node->peers_.RandomPeers(rai::Node::PEERS_PER_BROADCAST);
+        for (const auto& peer : peers)
+        {
+            if (peer.version_ >= rai::PROTOCOL_VERSION_CONFIRM_BATCH)
+            {
+                node->SendToPeer(peer, *message);
+            }
+        }
+    });
+}
+
 void rai::Node::BroadcastConflict(
     const rai::Account& representative, uint64_t timestamp_first,
     uint64_t timestamp_second, const rai::Signature& signature_first,
@@ -1837,9 +2126,7 @@ void rai::Node::ResolvePreconfiguredPeers()
 
 rai::uint512_union rai::Node::Sign(const rai::uint256_union& data) const
 {
-    rai::RawKey private_key;
-    key_.Get(private_key);
-    return rai::SignMessage(private_key, account_, data);
+    return signer_.Sign(data);
 }
 
 void rai::Node::ReceiveBlock(const std::shared_ptr<rai::Block>& block,
@@ -1995,6 +2282,48 @@ void rai::Node::AgeGapCaches()
     }
 }
 
+void rai::Node::Prune()
+{
+    if (Status() != rai::NodeStatus::RUN)
+    {
+        return;
+    }
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code, ledger_, true);
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        rai::Stats::Add(error_code, "Node::Prune");
+        return;
+    }
+
+    size_t pruned = 0;
+    error_code =
+        ledger_.Prune(transaction, prune_next_, config_.pruning_depth_,
+                      rai::Node::PRUNE_BLOCKS_PER_TRANSACTION, pruned);
+    if (error_code == rai::ErrorCode::SUCCESS && prune_next_.IsZero())
+    {
+        // A full pass over the accounts is done
+        error_code = ledger_.PruneRollbacks(transaction, pruned);
+    }
+
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        transaction.Abort();
+        prune_next_.Clear();
+        rai::Stats::Add(error_code, "Node::Prune");
+    }
+}
+
+void rai::Node::SyncStorage()
+{
+    bool error = store_.Sync();
+    if (error)
+    {
+        rai::Stats::Add(rai::ErrorCode::MDB_ENV_SYNC, "Node::SyncStorage");
+    }
+}
+
 rai::Amount rai::Node::RepWeight(const rai::Account& account)
 {
     rai::Amount result;
@@ -2013,25 +2342,19 @@ rai::Amount rai::Node::RepWeightTotal()
     return weight;
 }
 
-void rai::Node::RepWeights(rai::RepWeights& result)
+std::shared_ptr<const rai::RepWeightsSnapshot> rai::Node::RepWeights() const
 {
-    ledger_.RepWeightsGet(result.total_, result.weights_);
+    return ledger_.RepWeightsSnapshot();
 }
 
 void rai::Node::UpdatePeerWeights()
 {
     auto peer_weights = peers_.PeerWeights();
-    rai::Amount rep_total;
-    std::unordered_map<rai::Account, rai::Amount> rep_weights;
-    ledger_.RepWeightsGet(rep_total, rep_weights);
+    auto rep_weights = RepWeights();
     for (const auto& i : peer_weights)
     {
         rai::Amount weight(0);
-        auto it = rep_weights.find(i.first);
-        if (it != rep_weights.end())
-        {
-            weight = it->second;
-        }
+        rep_weights->Get(i.first, weight);
         if (weight != i.second)
         {
             peers_.SetPeerWeight(i.first, weight);
@@ -2093,6 +2416,22 @@ rai::NodeStatus rai::Node::Status() const
 
 void rai::Node::SetStatus(rai::NodeStatus status)
 {
+    if (config_.storage_.bootstrap_on_sync_ && status != status_)
+    {
+        // Commit asynchronously while catching up, the store is flushed
+        // when it switches back to the configured profile
+        rai::StorageProfile profile = status == rai::NodeStatus::SYNC
+                                          ? rai::StorageProfile::BOOTSTRAP
+                                          : config_.storage_.profile_;
+        bool error = store_.SetProfile(profile);
+        if (error)
+        {
+            rai::Stats::Add(rai::ErrorCode::MDB_ENV_SET_FLAGS,
+                            "Node::SetStatus: profile=",
+                            rai::StorageProfileToString(profile));
+        }
+    }
+
     if (status == rai::NodeStatus::OFFLINE
         && status_ != rai::NodeStatus::OFFLINE)
     {
@@ -2144,10 +2483,7 @@ rai::Amount rai::Node::Supply()
 
 void rai::Node::ReceiveWsMessage(const std::shared_ptr<rai::Ptree>& message)
 {
-    std::stringstream ostream;
-    boost::property_tree::write_json(ostream, *message);
-    ostream.flush();
-    rai::NodeRpcHandler handler(*this, *rpc_, ostream.str(),
+    rai::NodeRpcHandler handler(*this, *rpc_, rai::PtreeToJson(*message),
                                 boost::asio::ip::address_v4::any(),
                                 [this](const rai::Ptree& response) {
                                     SendCallback(response);
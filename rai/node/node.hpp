@@ -16,12 +16,14 @@
 #include <rai/secure/rpc.hpp>
 #include <rai/secure/websocket.hpp>
 #include <rai/node/blockprocessor.hpp>
+#include <rai/node/callback.hpp>
 #include <rai/node/blockquery.hpp>
 #include <rai/node/gapcache.hpp>
 #include <rai/node/election.hpp>
 #include <rai/node/syncer.hpp>
 #include <rai/node/bootstrap.hpp>
 #include <rai/node/subscribe.hpp>
+#include <rai/node/websocket.hpp>
 #include <rai/node/dumper.hpp>
 #include <rai/node/rewarder.hpp>
 #include <rai/node/rpc.hpp>
@@ -38,8 +40,15 @@ public:
     rai::ErrorCode UpgradeJson(bool&, uint32_t, rai::Ptree&) const;
     rai::ErrorCode UpgradeV1V2(rai::Ptree&) const;
     rai::ErrorCode UpgradeV2V3(rai::Ptree&) const;
+    rai::ErrorCode UpgradeV3V4(rai::Ptree&) const;
+    rai::ErrorCode UpgradeV4V5(rai::Ptree&) const;
+    rai::ErrorCode UpgradeV5V6(rai::Ptree&) const;
+    rai::ErrorCode UpgradeV6V7(rai::Ptree&) const;
+    rai::ErrorCode UpgradeV7V8(rai::Ptree&) const;
 
     static uint32_t constexpr DEFAULT_DAILY_FORWARD_TIMES = 12;
+    static uint64_t constexpr DEFAULT_PRUNING_DEPTH = 4096;
+    static uint64_t constexpr DEFAULT_SIGNING_KEY_CACHE = 60;
 
     uint16_t port_;
     rai::LogConfig log_;
@@ -50,6 +59,12 @@ public:
     uint32_t daily_forward_times_;
     bool enable_rich_list_;
     bool enable_delegator_list_;
+    bool enable_pruning_;
+    uint64_t pruning_depth_;
+    rai::StorageConfig storage_;
+    uint64_t signing_key_cache_;
+    rai::CallbackConfig callback_;
+    rai::WebsocketServerConfig websocket_;
 };
 
 class RecentBlock
@@ -178,21 +193,20 @@ private:
 class Observers
 {
 public:
+    // ledger bookkeeping of the node, delivered without loss
     rai::ObserverContainer<const rai::BlockProcessResult&,
                            const std::shared_ptr<rai::Block>&>
         block_;
+
+    // client notifications, events are skipped when they fall behind
+    rai::ObserverContainer<const rai::BlockProcessResult&,
+                           const std::shared_ptr<rai::Block>&>
+        notify_block_;
     rai::ObserverContainer<bool, const std::shared_ptr<rai::Block>&,
                            const std::shared_ptr<rai::Block>&>
         fork_;
 };
 
-class RepWeights
-{
-public:
-    rai::Amount total_;
-    std::unordered_map<rai::Account, rai::Amount> weights_;
-};
-
 enum class NodeStatus
 {
     OFFLINE = 0,
@@ -221,6 +235,10 @@ public:
     void SendToPeer(const rai::Peer&, rai::Message&);
     void SendByRoute(const rai::Route&, rai::Message&);
     void SendCallback(const rai::Ptree&);
+    void SendCallback(std::string&&);
+    void Notify(const rai::Account&, rai::SubscriptionEvent,
+                const rai::Ptree&);
+    void Notify(const rai::Account&, rai::SubscriptionEvent, std::string&&);
     void Broadcast(rai::Message&);
     void BroadcastAsync(const std::shared_ptr<rai::Message>&);
     void BroadcastFork(const std::shared_ptr<rai::Block>&,
@@ -228,6 +246,8 @@ public:
     void BroadcastConfirm(const rai::Account&, uint64_t, const rai::Signature&,
                           const std::shared_ptr<rai::Block>&);
     void BroadcastConfirm(const rai::Account&, uint64_t);
+    void BroadcastConfirmBatch(
+        const std::shared_ptr<rai::ConfirmBatchMessage>&);
     void BroadcastConflict(const rai::Account&, uint64_t, uint64_t,
                            const rai::Signature&, const rai::Signature&,
                            const std::shared_ptr<rai::Block>&,
@@ -272,9 +292,11 @@ public:
     void ForceAppendBlock(std::shared_ptr<rai::Block>&);
     void QueueGapCaches(const rai::BlockHash&);
     void AgeGapCaches();
+    void Prune();
+    void SyncStorage();
     rai::Amount RepWeight(const rai::Account&);
     rai::Amount RepWeightTotal();
-    void RepWeights(rai::RepWeights&);
+    std::shared_ptr<const rai::RepWeightsSnapshot> RepWeights() const;
     void UpdatePeerWeights();
     bool IsQualifiedRepresentative();
     void InitLedger(rai::ErrorCode&);
@@ -291,15 +313,19 @@ public:
     }
 
     static size_t constexpr PEERS_PER_BROADCAST = 16;
+    static size_t constexpr PRUNE_BLOCKS_PER_TRANSACTION = 10000;
  
 private:
     std::atomic<rai::NodeStatus> status_;
+    rai::Account prune_next_;
 
 public:
     rai::NodeConfig config_;
     boost::asio::io_service& service_;
     rai::Alarm& alarm_;
     rai::Fan& key_;
+    rai::Signer signer_;
+    rai::RpcResponseCache rpc_cache_;
     std::shared_ptr<rai::Rpc> rpc_;
     rai::Genesis genesis_;
     rai::Account account_;
@@ -328,6 +354,9 @@ public:
     rai::Rewarder rewarder_;
     rai::ActiveAccounts active_accounts_;
     std::shared_ptr<rai::WebsocketClient> websocket_;
+    std::shared_ptr<rai::CallbackDispatcher> callback_dispatcher_;
+    std::shared_ptr<rai::CallbackOutbox> callback_outbox_;
+    std::unique_ptr<rai::WebsocketServer> websocket_server_;
 };
 
 } // namespace rai
\ No newline at end of file
@@ -1,11 +1,14 @@
 #include <rai/node/rpc.hpp>
 
+#include <algorithm>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <rai/common/json.hpp>
 #include <rai/common/log.hpp>
 #include <rai/common/stat.hpp>
 #include <rai/node/node.hpp>
 
+size_t constexpr rai::RpcResponseCache::MAX_ENTRIES;
 
 rai::NodeRpcConfig::NodeRpcConfig()
     : enable_(false),
@@ -14,7 +17,9 @@ rai::NodeRpcConfig::NodeRpcConfig()
       enable_control_(false),
       whitelist_({
           boost::asio::ip::address_v4::loopback(),
-      })
+      }),
+      workers_(rai::RpcConfig::DEFAULT_WORKERS),
+      queue_size_(rai::RpcConfig::DEFAULT_QUEUE_SIZE)
 {
 }
 
@@ -65,6 +70,16 @@ rai::ErrorCode rai::NodeRpcConfig::DeserializeJson(bool& upgraded,
             }
             whitelist_.push_back(ip);
         }
+
+        error_code = rai::ErrorCode::JSON_CONFIG_RPC_WORKERS;
+        workers_ = ptree.get<uint32_t>("workers");
+
+        error_code = rai::ErrorCode::JSON_CONFIG_RPC_QUEUE_SIZE;
+        queue_size_ = ptree.get<uint32_t>("queue_size");
+        if (queue_size_ == 0)
+        {
+            return error_code;
+        }
     }
     catch (const std::exception&)
     {
@@ -75,7 +90,7 @@ rai::ErrorCode rai::NodeRpcConfig::DeserializeJson(bool& upgraded,
 
 void rai::NodeRpcConfig::SerializeJson(rai::Ptree& ptree) const
 {
-    ptree.put("version", "1");
+    ptree.put("version", "2");
     ptree.put("enable", enable_);
     ptree.put("address", address_.to_string());
     ptree.put("port", port_);
@@ -88,6 +103,8 @@ void rai::NodeRpcConfig::SerializeJson(rai::Ptree& ptree) const
         whitelist.push_back(std::make_pair("", entry));
     }
     ptree.add_child("whitelist", whitelist);
+    ptree.put("workers", workers_);
+    ptree.put("queue_size", queue_size_);
 }
 
 rai::ErrorCode rai::NodeRpcConfig::UpgradeJson(bool& upgraded, uint32_t version,
@@ -96,6 +113,13 @@ rai::ErrorCode rai::NodeRpcConfig::UpgradeJson(bool& upgraded, uint32_t version,
     switch (version)
     {
         case 1:
+        {
+            upgraded = true;
+            ptree.put("version", 2);
+            ptree.put("workers", workers_);
+            ptree.put("queue_size", queue_size_);
+        }
+        case 2:
         {
             break;
         }
@@ -110,225 +134,272 @@ rai::ErrorCode rai::NodeRpcConfig::UpgradeJson(bool& upgraded, uint32_t version,
 
 rai::RpcConfig rai::NodeRpcConfig::RpcConfig() const
 {
-    return rai::RpcConfig{address_, port_, enable_control_, whitelist_};
+    return rai::RpcConfig{address_, port_, enable_control_, whitelist_,
+                          workers_, queue_size_};
 }
 
-rai::NodeRpcHandler::NodeRpcHandler(
-    rai::Node& node, rai::Rpc& rpc, const std::string& body,
-    const boost::asio::ip::address_v4& ip,
-    const std::function<void(const rai::Ptree&)>& send_response)
-    : RpcHandler(rpc, body, ip, send_response), node_(node)
+rai::RpcResponseCache::RpcResponseCache() : hits_(0), misses_(0)
 {
 }
 
-void rai::NodeRpcHandler::ProcessImpl()
+bool rai::RpcResponseCache::Get(const std::string& key, uint64_t version,
+                                rai::Ptree& response)
 {
-    std::string action = request_.get<std::string>("action");
-
-    if (action == "account_count")
-    {
-        AccountCount();
-    }
-    else if (action == "account_forks")
-    {
-        AccountForks();
-    }
-    else if (action == "account_info")
+    std::shared_ptr<const rai::Ptree> cached;
     {
-        AccountInfo();
-    }
-    else if (action == "account_subscribe")
-    {
-        AccountSubscribe();
-    }
-    else if (action == "account_unsubscribe")
-    {
-        AccountUnsubscribe();
-    }
-    else if (action == "block_confirm")
-    {
-        BlockConfirm();
-    }
-    else if (action == "block_count")
-    {
-        BlockCount();
-    }
-    else if (action == "block_dump")
-    {
-        BlockDump();
-    }
-    else if (action == "block_dump_off")
-    {
-        if (!CheckControl_())
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second.version_ == version
+            && std::chrono::steady_clock::now() < it->second.expiry_)
         {
-            BlockDumpOff();
+            cached = it->second.response_;
+            ++hits_;
         }
-    }
-    else if (action == "block_dump_on")
-    {
-        if (!CheckControl_())
+        else
         {
-            BlockDumpOn();
+            ++misses_;
         }
     }
-    else if (action == "block_processor_status")
-    {
-        BlockProcessorStatus();
-    }
-    else if (action == "block_publish")
-    {
-        BlockPublish();
-    }
-    else if (action == "block_query")
-    {
-        BlockQuery();
-    }
-    else if (action == "bootstrap_status")
-    {
-        BootstrapStatus();
-    }
-    else if (action == "confirm_manager_status")
-    {
-        ConfirmManagerStatus();
-    }
-    else if (action == "delegator_list")
-    {
-        DelegatorList();
-    }
-    else if (action == "election_count")
-    {
-        ElectionCount();
-    }
-    else if (action == "election_info")
-    {
-        ElectionInfo();
-    }
-    else if (action == "elections")
-    {
-        Elections();
-    }
-    else if (action == "event_subscribe")
-    {
-        EventSubscribe();
-    }
-    else if (action == "event_unsubscribe")
-    {
-        EventUnsubscribe();
-    }
-    else if (action == "forks")
-    {
-        Forks();
-    }
-    else if (action == "full_peer_count")
-    {
-        FullPeerCount();
-    }
-    else if (action == "message_dump")
-    {
-        MessageDump();
-    }
-    else if (action == "message_dump_off")
+
+    if (cached == nullptr)
     {
-        if (!CheckControl_())
-        {
-            MessageDumpOff();
-        }
+        return false;
     }
-    else if (action == "message_dump_on")
+    response = *cached;
+    return true;
+}
+
+void rai::RpcResponseCache::Put(const std::string& key, uint64_t version,
+                                std::chrono::milliseconds ttl,
+                                const rai::Ptree& response)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto response_l = std::make_shared<const rai::Ptree>(response);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= rai::RpcResponseCache::MAX_ENTRIES
+        && entries_.find(key) == entries_.end())
     {
-        if (!CheckControl_())
+        for (auto i = entries_.begin(); i != entries_.end();)
         {
-            MessageDumpOn();
+            if (now >= i->second.expiry_)
+            {
+                i = entries_.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
         }
-    }
-    else if (action == "node_account")
-    {
-        NodeAccount();
-    }
-    else if (action == "peer_count")
-    {
-        PeerCount();
-    }
-    else if (action == "peers")
-    {
-        Peers();
-    }
-    else if (action == "peers_verbose")
-    {
-        PeersVerbose();
-    }
-    else if (action == "querier_status")
-    {
-        QuerierStatus();
-    }
-    else if (action == "receivable_count")
-    {
-        ReceivableCount();
-    }
-    else if (action == "receivables")
-    {
-        Receivables();
-    }
-    else if (action == "rewardable")
-    {
-        Rewardable();
-    }
-    else if (action == "rewardables")
-    {
-        Rewardables();
-    }
-    else if (action == "rewarder_status")
-    {
-        RewarderStatus();
-    }
-    else if (action == "richlist")
-    {
-        RichList();
-    }
-    else if (action == "stats")
-    {
-        Stats();
-    }
-    else if (action == "stats_verbose")
-    {
-        StatsVerbose();
-    }
-    else if (action == "stats_clear")
-    {
-        StatsClear();
-    }
-    else if (action == "stop")
-    {
-        if (!CheckLocal_())
+        if (entries_.size() >= rai::RpcResponseCache::MAX_ENTRIES)
         {
-            Stop();
+            return;
         }
     }
-    else if (action == "subscriber_count")
-    {
-        SubscriberCount();
-    }
-    else if (action == "subscribers")
+    entries_[key] = Entry{version, now + ttl, response_l};
+}
+
+rai::RpcResponseCacheStat rai::RpcResponseCache::Stat() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rai::RpcResponseCacheStat{entries_.size(), hits_, misses_};
+}
+
+rai::NodeRpcHandler::NodeRpcHandler(
+    rai::Node& node, rai::Rpc& rpc, const std::string& body,
+    const boost::asio::ip::address_v4& ip,
+    const std::function<void(const rai::Ptree&)>& send_response)
+    : RpcHandler(rpc, body, ip, send_response),
+      node_(node),
+      transaction_(nullptr)
+{
+}
+
+void rai::NodeRpcHandler::ProcessImpl()
+{
+    std::string action = request_.get<std::string>("action");
+    auto limit = TimeLimits().find(action);
+    if (limit != TimeLimits().end())
     {
-        Subscribers();
+        // a batch sub-request also stays within the batch's deadline
+        deadline_ = std::min(deadline_,
+                             std::chrono::steady_clock::now() + limit->second);
     }
-    else if (action == "supply")
+
+    auto it = CachePolicies().find(action);
+    if (it == CachePolicies().end() || transaction_ != nullptr)
     {
-        Supply();
+        Call_(Actions());
+        return;
     }
-    else if (action == "syncer_status")
+
+    const rai::RpcCachePolicy& policy = it->second;
+    // sampled before the action opens its transaction
+    uint64_t version = policy.ledger_ ? node_.ledger_.Version() : 0;
+    std::string key = CacheKey_();
+    auto start = std::chrono::steady_clock::now();
+    if (node_.rpc_cache_.Get(key, version, response_))
     {
-        SyncerStatus();
+        AddStat_(action, start);
+        return;
     }
-    else
+
+    Call_(Actions());
+    if (error_code_ == rai::ErrorCode::SUCCESS)
     {
-        error_code_ = rai::ErrorCode::RPC_UNKNOWN_ACTION;
+        node_.rpc_cache_.Put(key, version, policy.ttl_, response_);
     }
 }
 
+const std::unordered_map<std::string, rai::RpcAction<rai::NodeRpcHandler>>&
+rai::NodeRpcHandler::Actions()
+{
+    // action: {handler, control, local, read only}
+    static const std::unordered_map<std::string,
+                                    rai::RpcAction<rai::NodeRpcHandler>>
+        actions = {
+            {"account_count",
+             {&rai::NodeRpcHandler::AccountCount, false, false, true}},
+            {"account_forks",
+             {&rai::NodeRpcHandler::AccountForks, false, false, true}},
+            {"account_info",
+             {&rai::NodeRpcHandler::AccountInfo, false, false, true}},
+            {"account_subscribe",
+             {&rai::NodeRpcHandler::AccountSubscribe, false, false, false}},
+            {"account_unsubscribe",
+             {&rai::NodeRpcHandler::AccountUnsubscribe, false, false, false}},
+            {"batch",
+             {&rai::NodeRpcHandler::Batch, false, false, false}},
+            {"block_confirm",
+             {&rai::NodeRpcHandler::BlockConfirm, false, false, false}},
+            {"block_count",
+             {&rai::NodeRpcHandler::BlockCount, false, false, true}},
+            {"block_dump",
+             {&rai::NodeRpcHandler::BlockDump, false, false, false}},
+            {"block_dump_off",
+             {&rai::NodeRpcHandler::BlockDumpOff, true, false, false}},
+            {"block_dump_on",
+             {&rai::NodeRpcHandler::BlockDumpOn, true, false, false}},
+            {"block_processor_status",
+             {&rai::NodeRpcHandler::BlockProcessorStatus, false, false, false}},
+            {"block_publish",
+             {&rai::NodeRpcHandler::BlockPublish, false, false, false}},
+            {"block_query",
+             {&rai::NodeRpcHandler::BlockQuery, false, false, true}},
+            {"bootstrap_status",
+             {&rai::NodeRpcHandler::BootstrapStatus, false, false, false}},
+            {"callback_outbox_events",
+             {&rai::NodeRpcHandler::CallbackOutboxEvents, false, false, false}},
+            {"callback_outbox_resume",
+             {&rai::NodeRpcHandler::CallbackOutboxResume, true, false, false}},
+            {"confirm_manager_status",
+             {&rai::NodeRpcHandler::ConfirmManagerStatus, false, false, false}},
+            {"delegator_list",
+             {&rai::NodeRpcHandler::DelegatorList, false, false, false}},
+            {"election_count",
+             {&rai::NodeRpcHandler::ElectionCount, false, false, false}},
+            {"election_info",
+             {&rai::NodeRpcHandler::ElectionInfo, false, false, false}},
+            {"elections",
+             {&rai::NodeRpcHandler::Elections, false, false, false}},
+            {"event_subscribe",
+             {&rai::NodeRpcHandler::EventSubscribe, false, false, false}},
+            {"event_unsubscribe",
+             {&rai::NodeRpcHandler::EventUnsubscribe, false, false, false}},
+            {"forks",
+             {&rai::NodeRpcHandler::Forks, false, false, true}},
+            {"full_peer_count",
+             {&rai::NodeRpcHandler::FullPeerCount, false, false, false}},
+            {"message_dump",
+             {&rai::NodeRpcHandler::MessageDump, false, false, false}},
+            {"message_dump_off",
+             {&rai::NodeRpcHandler::MessageDumpOff, true, false, false}},
+            {"message_dump_on",
+             {&rai::NodeRpcHandler::MessageDumpOn, true, false, false}},
+            {"node_account",
+             {&rai::NodeRpcHandler::NodeAccount, false, false, false}},
+            {"peer_count",
+             {&rai::NodeRpcHandler::PeerCount, false, false, false}},
+            {"peers",
+             {&rai::NodeRpcHandler::Peers, false, false, false}},
+            {"peers_verbose",
+             {&rai::NodeRpcHandler::PeersVerbose, false, false, false}},
+            {"querier_status",
+             {&rai::NodeRpcHandler::QuerierStatus, false, false, false}},
+            {"receivable_count",
+             {&rai::NodeRpcHandler::ReceivableCount, false, false, true}},
+            {"receivables",
+             {&rai::NodeRpcHandler::Receivables, false, false, true}},
+            {"rewardable",
+             {&rai::NodeRpcHandler::Rewardable, false, false, true}},
+            {"rewardables",
+             {&rai::NodeRpcHandler::Rewardables, false, false, true}},
+            {"rewarder_status",
+             {&rai::NodeRpcHandler::RewarderStatus, false, false, false}},
+            {"richlist",
+             {&rai::NodeRpcHandler::RichList, false, false, false}},
+            {"rpc_stats",
+             {&rai::NodeRpcHandler::RpcStats, false, false, false}},
+            {"rpc_stats_clear",
+             {&rai::RpcHandler::RpcStatsClear, true, false, false}},
+            {"stats",
+             {&rai::NodeRpcHandler::Stats, false, false, false}},
+            {"stats_clear",
+             {&rai::NodeRpcHandler::StatsClear, false, false, false}},
+            {"stats_verbose",
+             {&rai::NodeRpcHandler::StatsVerbose, false, false, false}},
+            {"stop",
+             {&rai::NodeRpcHandler::Stop, false, true, false}},
+            {"subscriber_count",
+             {&rai::NodeRpcHandler::SubscriberCount, false, false, false}},
+            {"subscribers",
+             {&rai::NodeRpcHandler::Subscribers, false, false, false}},
+            {"supply",
+             {&rai::NodeRpcHandler::Supply, false, false, false}},
+            {"syncer_status",
+             {&rai::NodeRpcHandler::SyncerStatus, false, false, false}}
+        };
+    return actions;
+}
+
+const std::unordered_map<std::string, rai::RpcCachePolicy>&
+rai::NodeRpcHandler::CachePolicies()
+{
+    using std::chrono::milliseconds;
+    // action: {ttl, ledger}
+    static const std::unordered_map<std::string, rai::RpcCachePolicy>
+        policies = {
+            {"account_count", {milliseconds(1000), true}},
+            {"block_count", {milliseconds(1000), true}},
+            {"delegator_list", {milliseconds(5000), true}},
+            {"elections", {milliseconds(1000), false}},
+            {"peers_verbose", {milliseconds(1000), false}},
+            {"richlist", {milliseconds(5000), true}},
+            {"stats_verbose", {milliseconds(1000), false}},
+            {"supply", {milliseconds(5000), true}}
+        };
+    return policies;
+}
+
+const std::unordered_map<std::string, std::chrono::milliseconds>&
+rai::NodeRpcHandler::TimeLimits()
+{
+    using std::chrono::milliseconds;
+    // unbounded ledger scans checked between entries, and batches between
+    // their sub-requests
+    static const std::unordered_map<std::string, milliseconds> limits = {
+        {"account_forks", milliseconds(1000)},
+        {"batch", milliseconds(2000)},
+        {"forks", milliseconds(2000)},
+        {"rewardables", milliseconds(2000)}
+    };
+    return limits;
+}
+
 void rai::NodeRpcHandler::AccountCount()
 {
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     IF_NOT_SUCCESS_RETURN_VOID(error_code_);
 
     size_t count = 0;
@@ -349,7 +420,8 @@ void rai::NodeRpcHandler::AccountForks()
     IF_ERROR_RETURN_VOID(error);
     response_.put("account", account.StringAccount());
 
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     if (error_code_ != rai::ErrorCode::SUCCESS)
     {
         return;
@@ -360,6 +432,11 @@ void rai::NodeRpcHandler::AccountForks()
     rai::Iterator n = node_.ledger_.ForkUpperBound(transaction, account);
     for (; i != n; ++i)
     {
+        if (Expired_())
+        {
+            return;
+        }
+
         std::shared_ptr<rai::Block> first(nullptr);
         std::shared_ptr<rai::Block> second(nullptr);
         error = node_.ledger_.ForkGet(i, first, second);
@@ -388,7 +465,8 @@ void rai::NodeRpcHandler::AccountInfo()
     IF_ERROR_RETURN_VOID(error);
     response_.put("account", account.StringAccount());
 
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     if (error_code_ != rai::ErrorCode::SUCCESS)
     {
         return;
@@ -513,6 +591,24 @@ void rai::NodeRpcHandler::AccountUnsubscribe()
     response_.put("success", "");
 }
 
+void rai::NodeRpcHandler::Batch()
+{
+    // every sub-request reads the same snapshot of the ledger
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
+    IF_NOT_SUCCESS_RETURN_VOID(error_code_);
+
+    Batch_<rai::NodeRpcHandler>(
+        Actions(),
+        [this, &transaction](
+            const std::function<void(const rai::Ptree&)>& send_response) {
+            std::unique_ptr<rai::NodeRpcHandler> handler(
+                new rai::NodeRpcHandler(node_, rpc_, "", ip_, send_response));
+            handler->transaction_ = &transaction;
+            return handler;
+        });
+}
+
 void rai::NodeRpcHandler::BlockConfirm()
 {
     rai::BlockHash hash;
@@ -568,7 +664,8 @@ void rai::NodeRpcHandler::BlockConfirm()
 
 void rai::NodeRpcHandler::BlockCount()
 {
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     IF_NOT_SUCCESS_RETURN_VOID(error_code_);
 
     size_t count = 0;
@@ -690,7 +787,8 @@ void rai::NodeRpcHandler::BlockQueryByPrevious()
     error = GetPrevious_(previous);
     IF_ERROR_RETURN_VOID(error);
 
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     if (error_code_ != rai::ErrorCode::SUCCESS)
     {
         return;
@@ -790,7 +888,8 @@ void rai::NodeRpcHandler::BlockQueryByHash()
         raw = true;
     }
 
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     if (error_code_ != rai::ErrorCode::SUCCESS)
     {
         return;
@@ -841,6 +940,81 @@ void rai::NodeRpcHandler::BootstrapStatus()
     response_.put("waiting_syncer", node_.bootstrap_.WaitingSyncer());
 }
 
+void rai::NodeRpcHandler::CallbackOutboxEvents()
+{
+    if (!node_.callback_outbox_)
+    {
+        error_code_ = rai::ErrorCode::RPC_CALLBACK_OUTBOX_OFF;
+        return;
+    }
+
+    uint64_t sequence = 0;
+    bool error = GetSequence_(sequence);
+    IF_ERROR_RETURN_VOID(error);
+
+    uint64_t count = 100;
+    error = GetCount_(count);
+    if (error && error_code_ != rai::ErrorCode::RPC_MISS_FIELD_COUNT)
+    {
+        return;
+    }
+    if (count > 1000)
+    {
+        count = 1000;
+    }
+
+    error_code_ = rai::ErrorCode::SUCCESS;
+    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    IF_NOT_SUCCESS_RETURN_VOID(error_code_);
+
+    std::vector<std::pair<uint64_t, std::string>> notifies;
+    error = node_.ledger_.CallbackGet(transaction, sequence, count, notifies);
+    if (error)
+    {
+        error_code_ = rai::ErrorCode::LEDGER_CALLBACK_GET;
+        return;
+    }
+
+    rai::Ptree events;
+    for (const auto& i : notifies)
+    {
+        rai::Ptree event;
+        std::stringstream stream(i.second);
+        try
+        {
+            boost::property_tree::read_json(stream, event);
+        }
+        catch (const std::exception&)
+        {
+            error_code_ = rai::ErrorCode::LEDGER_CALLBACK_GET;
+            return;
+        }
+        events.push_back(std::make_pair("", event));
+    }
+
+    uint64_t next = notifies.empty() ? sequence : notifies.back().first + 1;
+    response_.put("count", std::to_string(notifies.size()));
+    response_.put("next", std::to_string(next));
+    response_.put_child("events", events);
+}
+
+void rai::NodeRpcHandler::CallbackOutboxResume()
+{
+    if (!node_.callback_outbox_)
+    {
+        error_code_ = rai::ErrorCode::RPC_CALLBACK_OUTBOX_OFF;
+        return;
+    }
+
+    uint64_t sequence = 0;
+    bool error = GetSequence_(sequence);
+    IF_ERROR_RETURN_VOID(error);
+
+    error_code_ = node_.callback_outbox_->Resume(sequence);
+    IF_NOT_SUCCESS_RETURN_VOID(error_code_);
+    response_.put("sequence", std::to_string(sequence));
+}
+
 void rai::NodeRpcHandler::ConfirmManagerStatus()
 {
     response_ = node_.confirm_manager_.Status();
@@ -893,7 +1067,9 @@ void rai::NodeRpcHandler::DelegatorList()
 
 void rai::NodeRpcHandler::ElectionCount()
 {
-    response_.put("count", std::to_string(node_.elections_.Size()));
+    rai::Ptree status = node_.elections_.Status();
+    response_.put("count", status.get<std::string>("active"));
+    response_.put_child("scheduler", status);
 }
 
 void rai::NodeRpcHandler::ElectionInfo()
@@ -987,13 +1163,19 @@ void rai::NodeRpcHandler::Forks()
     }
 
     error_code_ = rai::ErrorCode::SUCCESS;
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     IF_NOT_SUCCESS_RETURN_VOID(error_code_);
 
     rai::Ptree forks;
     uint64_t i = 0;
     for (; i < count; ++i)
     {
+        if (Expired_())
+        {
+            return;
+        }
+
         std::shared_ptr<rai::Block> first(nullptr);
         std::shared_ptr<rai::Block> second(nullptr);
         bool error =
@@ -1108,7 +1290,8 @@ void rai::NodeRpcHandler::QuerierStatus()
 
 void rai::NodeRpcHandler::ReceivableCount()
 {
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     IF_NOT_SUCCESS_RETURN_VOID(error_code_);
 
     size_t count = 0;
@@ -1158,11 +1341,41 @@ void rai::NodeRpcHandler::Receivables()
         return;
     }
 
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    if (count > 10000)
+    {
+        count = 10000;
+    }
+
+    rai::ReceivableInfosCursor cursor;
+    auto cursor_o = request_.get_optional<std::string>("cursor");
+    if (cursor_o)
+    {
+        error = cursor.Decode(*cursor_o);
+        if (error)
+        {
+            error_code_ = rai::ErrorCode::RPC_INVALID_FIELD_CURSOR;
+            return;
+        }
+    }
+
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     IF_NOT_SUCCESS_RETURN_VOID(error_code_);
-    rai::ReceivableInfos receivables;
-    error = node_.ledger_.ReceivableInfosGet(transaction, account, type,
-                                             receivables, count);
+    std::vector<rai::ReceivableInfoEntry> receivables;
+    // an explicit zero count still lists nothing, only the totals
+    if (count > 0)
+    {
+        error = node_.ledger_.ReceivableInfosPage(transaction, account, type,
+                                                  count, cursor, receivables);
+        if (error)
+        {
+            error_code_ = rai::ErrorCode::LEDGER_RECEIVABLES_GET;
+            return;
+        }
+    }
+
+    rai::AmountSummary summary;
+    error = node_.ledger_.ReceivableSummaryGet(transaction, account, summary);
     if (error)
     {
         error_code_ = rai::ErrorCode::LEDGER_RECEIVABLES_GET;
@@ -1170,17 +1383,19 @@ void rai::NodeRpcHandler::Receivables()
     }
 
     response_.put("account", account.StringAccount());
+    response_.put("total_count", summary.count_);
+    response_.put("total_amount", summary.amount_.StringDec());
     rai::Ptree receivables_ptree;
     for (const auto& i : receivables)
     {
         rai::Ptree entry;
-        entry.put("source", i.first.source_.StringAccount());
-        entry.put("amount", i.first.amount_.StringDec());
-        entry.put("hash", i.second.StringHex());
-        entry.put("timestamp", std::to_string(i.first.timestamp_));
+        entry.put("source", i.info_.source_.StringAccount());
+        entry.put("amount", i.info_.amount_.StringDec());
+        entry.put("hash", i.hash_.StringHex());
+        entry.put("timestamp", std::to_string(i.info_.timestamp_));
 
         std::shared_ptr<rai::Block> block(nullptr);
-        error = node_.ledger_.BlockGet(transaction, i.second, block);
+        error = node_.ledger_.BlockGet(transaction, i.hash_, block);
         if (!error)
         {
             rai::Ptree ptree_block;
@@ -1191,6 +1406,10 @@ void rai::NodeRpcHandler::Receivables()
         receivables_ptree.push_back(std::make_pair("", entry));
     }
     response_.put_child("receivables", receivables_ptree);
+    if (cursor.more_)
+    {
+        response_.put("cursor", cursor.String());
+    }
 }
 
 void rai::NodeRpcHandler::Rewardable()
@@ -1203,7 +1422,8 @@ void rai::NodeRpcHandler::Rewardable()
     error = GetHash_(hash);
     IF_ERROR_RETURN_VOID(error);
 
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     IF_NOT_SUCCESS_RETURN_VOID(error_code_);
     rai::RewardableInfo rewardable;
     error =
@@ -1236,7 +1456,8 @@ void rai::NodeRpcHandler::Rewardables()
         count = 10000;
     }
 
-    rai::Transaction transaction(error_code_, node_.ledger_, false);
+    std::unique_ptr<rai::Transaction> transaction_l;
+    rai::Transaction& transaction = ReadTransaction_(transaction_l);
     IF_NOT_SUCCESS_RETURN_VOID(error_code_);
 
     std::multimap<rai::Amount, std::pair<rai::BlockHash, rai::RewardableInfo>,
@@ -1248,6 +1469,11 @@ void rai::NodeRpcHandler::Rewardables()
         node_.ledger_.RewardableInfoUpperBound(transaction, account);
     for (; i != n; ++i)
     {
+        if (Expired_())
+        {
+            return;
+        }
+
         rai::BlockHash hash;
         rai::RewardableInfo info;
         bool error = node_.ledger_.RewardableInfoGet(i, account, hash, info);
@@ -1264,7 +1490,17 @@ void rai::NodeRpcHandler::Rewardables()
         }
     }
 
+    rai::AmountSummary summary;
+    error = node_.ledger_.RewardableSummaryGet(transaction, account, summary);
+    if (error)
+    {
+        error_code_ = rai::ErrorCode::LEDGER_REWARDABLE_INFO_GET;
+        return;
+    }
+
     response_.put("account", account.StringAccount());
+    response_.put("total_count", summary.count_);
+    response_.put("total_amount", summary.amount_.StringDec());
     rai::Ptree rewardables_ptree;
     for (const auto& i : rewardables)
     {
@@ -1314,6 +1550,18 @@ void rai::NodeRpcHandler::RichList()
     response_.put("supply_in_rai", supply.StringBalance(rai::RAI) + " RAI");
 }
 
+void rai::NodeRpcHandler::RpcStats()
+{
+    rai::RpcHandler::RpcStats();
+
+    rai::RpcResponseCacheStat stat = node_.rpc_cache_.Stat();
+    rai::Ptree cache;
+    cache.put("entries", stat.entries_);
+    cache.put("hits", stat.hits_);
+    cache.put("misses", stat.misses_);
+    response_.put_child("response_cache", cache);
+}
+
 void rai::NodeRpcHandler::Stats()
 {
     boost::optional<std::string> type_o =
@@ -1345,6 +1593,9 @@ void rai::NodeRpcHandler::Stats()
 
     response_.put("type", "error");
     response_.put_child("stats", stats_ptree);
+    PutCryptoStats_();
+    PutCallbackStats_();
+    PutWebsocketStats_();
 }
 
 void rai::NodeRpcHandler::StatsVerbose()
@@ -1394,6 +1645,9 @@ void rai::NodeRpcHandler::StatsVerbose()
 
     response_.put("type", "error");
     response_.put_child("stats", stats_ptree);
+    PutCryptoStats_();
+    PutCallbackStats_();
+    PutWebsocketStats_();
 }
 
 void rai::NodeRpcHandler::StatsClear()
@@ -1456,6 +1710,110 @@ void rai::NodeRpcHandler::SyncerStatus()
     response_.put("queries", node_.syncer_.Queries());
 }
 
+void rai::NodeRpcHandler::PutCryptoStats_()
+{
+    rai::Ptree kernels;
+    kernels.put("blake2b", rai::Blake2bKernel());
+    kernels.put("ed25519", rai::Ed25519Kernel());
+    response_.put_child("kernels", kernels);
+
+    rai::SignatureCache& cache = rai::SignatureCache::Instance();
+    rai::Ptree signature_cache;
+    signature_cache.put("hits", cache.Hits());
+    signature_cache.put("misses", cache.Misses());
+    response_.put_child("signature_cache", signature_cache);
+}
+
+void rai::NodeRpcHandler::PutCallbackStats_()
+{
+    if (!node_.callback_dispatcher_)
+    {
+        return;
+    }
+
+    rai::CallbackStat stat = node_.callback_dispatcher_->Stat();
+    rai::Ptree callback;
+    callback.put("queue", stat.queue_);
+    callback.put("connections", stat.connections_);
+    callback.put("in_flight", stat.in_flight_);
+    callback.put("sent", stat.sent_);
+    callback.put("dropped", stat.dropped_);
+    callback.put("retried", stat.retried_);
+    callback.put("failed", stat.failed_);
+    if (node_.callback_outbox_)
+    {
+        rai::CallbackOutboxStat outbox;
+        rai::ErrorCode error_code = node_.callback_outbox_->Stat(outbox);
+        if (error_code == rai::ErrorCode::SUCCESS)
+        {
+            rai::Ptree outbox_ptree;
+            outbox_ptree.put("first", outbox.first_);
+            outbox_ptree.put("next", outbox.next_);
+            outbox_ptree.put("sending", outbox.sending_);
+            outbox_ptree.put("acked", outbox.acked_);
+            outbox_ptree.put("in_flight", outbox.in_flight_);
+            callback.put_child("outbox", outbox_ptree);
+        }
+    }
+    response_.put_child("callback", callback);
+}
+
+void rai::NodeRpcHandler::PutWebsocketStats_()
+{
+    if (!node_.websocket_server_)
+    {
+        return;
+    }
+
+    rai::WebsocketServerStat stat = node_.websocket_server_->Stat();
+    rai::Ptree websocket;
+    websocket.put("connections", stat.connections_);
+    websocket.put("accepted", stat.accepted_);
+    websocket.put("rejected", stat.rejected_);
+    websocket.put("sent", stat.sent_);
+    websocket.put("evicted", stat.evicted_);
+    response_.put_child("websocket", websocket);
+}
+
+std::string rai::NodeRpcHandler::CacheKey_() const
+{
+    rai::Ptree request(request_);
+    request.erase("request_id");
+    request.erase("client_id");
+    return rai::PtreeToJson(request);
+}
+
+rai::Transaction& rai::NodeRpcHandler::ReadTransaction_(
+    std::unique_ptr<rai::Transaction>& owned)
+{
+    if (transaction_ != nullptr)
+    {
+        return *transaction_;
+    }
+
+    owned.reset(new rai::Transaction(error_code_, node_.ledger_, false));
+    return *owned;
+}
+
+bool rai::NodeRpcHandler::GetSequence_(uint64_t& sequence)
+{
+    auto sequence_o = request_.get_optional<std::string>("sequence");
+    if (!sequence_o)
+    {
+        error_code_ = rai::ErrorCode::RPC_MISS_FIELD_SEQUENCE;
+        return true;
+    }
+
+    bool error = rai::StringToUint(*sequence_o, sequence);
+    if (error)
+    {
+        error_code_ = rai::ErrorCode::RPC_INVALID_FIELD_SEQUENCE;
+        return true;
+    }
+
+    return false;
+}
+
 void rai::NodeRpcHandler::AppendBlockAmount_(rai::Transaction& transaction,
                                              const rai::Block& block,
                                              const std::string& prefix)
@@ -1482,4 +1840,4 @@ void rai::NodeRpcHandler::AppendBlockAmount_(rai::Transaction& transaction,
         response_.put(prefix + "amount_in_rai",
                       amount.StringBalance(rai::RAI) + " RAI");
     }
-}
\ No newline at end of file
+}
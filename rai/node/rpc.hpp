@@ -1,6 +1,9 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <rai/common/parameters.hpp>
@@ -29,6 +32,52 @@ public:
     bool enable_control_;
     // only ips in the white list can access
     std::vector<boost::asio::ip::address_v4> whitelist_;
+    uint32_t workers_;
+    uint32_t queue_size_;
+};
+
+class RpcCachePolicy
+{
+public:
+    std::chrono::milliseconds ttl_;
+    // also dropped as soon as the ledger version changes
+    bool ledger_;
+};
+
+class RpcResponseCacheStat
+{
+public:
+    size_t entries_;
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+// Responses of expensive read only actions keyed by the request, so clients
+// polling the same query share one computation
+class RpcResponseCache
+{
+public:
+    RpcResponseCache();
+    bool Get(const std::string&, uint64_t, rai::Ptree&);
+    void Put(const std::string&, uint64_t, std::chrono::milliseconds,
+             const rai::Ptree&);
+    rai::RpcResponseCacheStat Stat() const;
+
+    static size_t constexpr MAX_ENTRIES = 1024;
+
+private:
+    class Entry
+    {
+    public:
+        uint64_t version_;
+        std::chrono::steady_clock::time_point expiry_;
+        std::shared_ptr<const rai::Ptree> response_;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    uint64_t hits_;
+    uint64_t misses_;
 };
 
 class Node;
@@ -47,6 +96,7 @@ public:
     void AccountInfo();
     void AccountSubscribe();
     void AccountUnsubscribe();
+    void Batch();
     void BlockConfirm();
     void BlockCount();
     void BlockDump();
@@ -58,6 +108,8 @@ public:
     void BlockQueryByPrevious();
     void BlockQueryByHash();
     void BootstrapStatus();
+    void CallbackOutboxEvents();
+    void CallbackOutboxResume();
     void ConfirmManagerStatus();
     void DelegatorList();
     void ElectionCount();
@@ -81,6 +133,7 @@ public:
     void Rewardables();
     void RewarderStatus();
     void RichList();
+    void RpcStats();
     void Stats();
     void StatsVerbose();
     void StatsClear();
@@ -90,11 +143,27 @@ public:
     void Supply();
     void SyncerStatus();
 
+    static const std::unordered_map<std::string,
+                                    rai::RpcAction<rai::NodeRpcHandler>>&
+    Actions();
+    static const std::unordered_map<std::string, rai::RpcCachePolicy>&
+    CachePolicies();
+    static const std::unordered_map<std::string, std::chrono::milliseconds>&
+    TimeLimits();
+
     rai::Node& node_;
+    // read transaction shared by the requests of a batch
+    rai::Transaction* transaction_;
 
 private:
     void AppendBlockAmount_(rai::Transaction&, const rai::Block&,
                             const std::string& = "");
+    void PutCryptoStats_();
+    void PutCallbackStats_();
+    void PutWebsocketStats_();
+    std::string CacheKey_() const;
+    rai::Transaction& ReadTransaction_(std::unique_ptr<rai::Transaction>&);
+    bool GetSequence_(uint64_t&);
 };
 
 }  // namespace rai
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include <rai/node/subscribe.hpp>
+
+#include <rai/common/json.hpp>
 #include <rai/node/node.hpp>
 
 std::chrono::seconds constexpr rai::Subscriptions::CUTOFF_TIME;
+size_t constexpr rai::Subscriptions::MAX_CONFIRM_RECEIVABLES;
+uint32_t constexpr rai::Subscriptions::MASK_ACCOUNTS;
 
 rai::SubscriptionEvent rai::StringToSubscriptionEvent(const std::string& str)
 {
@@ -23,9 +27,12 @@ rai::SubscriptionEvent rai::StringToSubscriptionEvent(const std::string& str)
     }
 }
 
-rai::Subscriptions::Subscriptions(rai::Node& node) : node_(node)
+rai::Subscriptions::Subscriptions(rai::Node& node)
+    : node_(node),
+      mask_(0),
+      accounts_(std::make_shared<const std::unordered_set<rai::Account>>())
 {
-    node_.observers_.block_.Add(
+    node_.observers_.notify_block_.Add(
         [this](const rai::BlockProcessResult& result,
                const std::shared_ptr<rai::Block>& block) {
             if (result.error_code_ != rai::ErrorCode::SUCCESS)
@@ -33,6 +40,18 @@ rai::Subscriptions::Subscriptions(rai::Node& node) : node_(node)
                 return;
             }
 
+            if (result.operation_ == rai::BlockOperation::CONFIRM
+                && node_.callback_outbox_)
+            {
+                // already appended to the outbox by the confirming transaction
+                node_.callback_outbox_->Notify();
+            }
+
+            if (!Active())
+            {
+                return;
+            }
+
             if (result.operation_ == rai::BlockOperation::APPEND)
             {
                 BlockAppend(block);
@@ -58,10 +77,19 @@ rai::Subscriptions::Subscriptions(rai::Node& node) : node_(node)
     node_.observers_.fork_.Add(
         [this](bool add, const std::shared_ptr<rai::Block>& first,
                const std::shared_ptr<rai::Block>& second) {
+            if (!Active())
+            {
+                return;
+            }
             BlockFork(add, first, second);
         });
 }
 
+bool rai::Subscriptions::Active() const
+{
+    return mask_.load(std::memory_order_acquire) != 0;
+}
+
 void rai::Subscriptions::Add(const rai::Account& account)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -76,30 +104,42 @@ void rai::Subscriptions::Add(const rai::Account& account)
     else
     {
         subscriptions_.insert(sub);
+        UpdateIndex_();
     }
 }
 
 void rai::Subscriptions::Add(rai::SubscriptionEvent event)
 {
     std::lock_guard<std::mutex> lock(mutex_);
+    auto it = event_subscriptions_.find(event);
+    if (it != event_subscriptions_.end())
+    {
+        it->second = std::chrono::steady_clock::now();
+        return;
+    }
     event_subscriptions_[event] = std::chrono::steady_clock::now();
+    UpdateIndex_();
 }
 
 void rai::Subscriptions::BlockAppend(const std::shared_ptr<rai::Block>& block)
 {
-    if (Exists(block->Account())
-        || Exists(rai::SubscriptionEvent::BLOCK_APPEND))
+    bool account = Exists(block->Account());
+    if (account || Exists(rai::SubscriptionEvent::BLOCK_APPEND))
     {
-        rai::Ptree ptree;
-        ptree.put("notify", "block_append");
-        ptree.put("account", block->Account().StringAccount());
-        rai::Ptree block_ptree;
-        block->SerializeJson(block_ptree);
-        ptree.put_child("block", block_ptree);
-        node_.SendCallback(ptree);
+        std::string notify;
+        notify.reserve(1024);
+        rai::JsonWriter writer(notify);
+        writer.StartObject();
+        writer.Put("notify", "block_append");
+        writer.Put("account", block->Account().StringAccount());
+        writer.Key("block");
+        block->SerializeJson(writer);
+        writer.EndObject();
+        node_.Notify(block->Account(), rai::SubscriptionEvent::BLOCK_APPEND,
+                     std::move(notify));
     }
 
-    if (Exists(block->Account()))
+    if (account)
     {
         node_.StartElection(block);
         node_.Push(block);
@@ -129,13 +169,16 @@ void rai::Subscriptions::BlockConfirm(const std::shared_ptr<rai::Block>& block,
         return;
     }
 
+    // the blocks of one confirm share an account, decide once for all
+    bool notify = Exists(block->Account())
+                  || Exists(rai::SubscriptionEvent::BLOCK_CONFIRM);
     do
     {
         if ((last_confirm_height == rai::Block::INVALID_HEIGHT
              && block->Height() == 0)
             || last_confirm_height + 1 == block->Height())
         {
-            BlockConfirm_(transaction, block, block->Height());
+            BlockConfirm_(transaction, block, block->Height(), notify);
             break;
         }
 
@@ -183,7 +226,7 @@ void rai::Subscriptions::BlockConfirm(const std::shared_ptr<rai::Block>& block,
                 break;
             }
 
-            BlockConfirm_(transaction, block_l, block->Height());
+            BlockConfirm_(transaction, block_l, block->Height(), notify);
 
             if (successor.IsZero())
             {
@@ -210,7 +253,8 @@ void rai::Subscriptions::BlockRollback(const std::shared_ptr<rai::Block>& block)
         rai::Ptree block_ptree;
         block->SerializeJson(block_ptree);
         ptree.put_child("block", block_ptree);
-        node_.SendCallback(ptree);
+        node_.Notify(block->Account(), rai::SubscriptionEvent::BLOCK_ROLLBACK,
+                     ptree);
     }
 }
 
@@ -224,7 +268,8 @@ void rai::Subscriptions::BlockDrop(const std::shared_ptr<rai::Block>& block)
         rai::Ptree block_ptree;
         block->SerializeJson(block_ptree);
         ptree.put_child("block", block_ptree);
-        node_.SendCallback(ptree);
+        node_.Notify(block->Account(), rai::SubscriptionEvent::INVALID,
+                     ptree);
     }
 }
 
@@ -246,7 +291,7 @@ void rai::Subscriptions::BlockFork(bool add,
     rai::Ptree ptree_second;
     second->SerializeJson(ptree_second);
     ptree.put_child("block_second", ptree_second);
-    node_.SendCallback(ptree);
+    node_.Notify(first->Account(), rai::SubscriptionEvent::INVALID, ptree);
 }
 
 void rai::Subscriptions::ConfirmReceivables(const rai::Account& account)
@@ -260,10 +305,13 @@ void rai::Subscriptions::ConfirmReceivables(const rai::Account& account)
         return;
     }
 
-    rai::ReceivableInfos receivables;
-    bool error = node_.ledger_.ReceivableInfosGet(
+    // Only the largest receivables are confirmed, the rest follow on the
+    // next request
+    rai::ReceivableInfosCursor cursor;
+    std::vector<rai::ReceivableInfoEntry> receivables;
+    bool error = node_.ledger_.ReceivableInfosPage(
         transaction, account, rai::ReceivableInfosType::NOT_CONFIRMED,
-        receivables);
+        rai::Subscriptions::MAX_CONFIRM_RECEIVABLES, cursor, receivables);
     if (error)
     {
         rai::Stats::Add(rai::ErrorCode::LEDGER_RECEIVABLES_GET,
@@ -274,7 +322,7 @@ void rai::Subscriptions::ConfirmReceivables(const rai::Account& account)
     std::unordered_set<rai::Account> accounts;
     for (const auto& i : receivables)
     {
-        accounts.insert(i.first.source_);
+        accounts.insert(i.info_.source_);
     }
     for (const auto& i : accounts)
     {
@@ -289,6 +337,7 @@ void rai::Subscriptions::Cutoff()
     std::chrono::steady_clock::time_point cutoff(
         now - rai::Subscriptions::CUTOFF_TIME);
 
+    size_t size = subscriptions_.size();
     auto begin = subscriptions_.get<rai::SubscriptionByTime>().begin();
     auto end = subscriptions_.get<rai::SubscriptionByTime>().lower_bound(cutoff);
     subscriptions_.get<rai::SubscriptionByTime>().erase(begin, end);
@@ -305,6 +354,11 @@ void rai::Subscriptions::Cutoff()
     {
         event_subscriptions_.erase(i);
     }
+
+    if (size != subscriptions_.size() || !events.empty())
+    {
+        UpdateIndex_();
+    }
 }
 
 void rai::Subscriptions::Erase(const rai::Account& account)
@@ -314,6 +368,7 @@ void rai::Subscriptions::Erase(const rai::Account& account)
     if (it != subscriptions_.end())
     {
         subscriptions_.erase(it);
+        UpdateIndex_();
     }
 }
 
@@ -324,19 +379,26 @@ void rai::Subscriptions::Erase(rai::SubscriptionEvent event)
     if (it != event_subscriptions_.end())
     {
         event_subscriptions_.erase(it);
+        UpdateIndex_();
     }
 }
 
 bool rai::Subscriptions::Exists(const rai::Account& account) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return subscriptions_.find(account) != subscriptions_.end();
+    if (!(mask_.load(std::memory_order_acquire)
+          & rai::Subscriptions::MASK_ACCOUNTS))
+    {
+        return false;
+    }
+    auto accounts = std::atomic_load(&accounts_);
+    return accounts->find(account) != accounts->end();
 }
 
 bool rai::Subscriptions::Exists(rai::SubscriptionEvent event) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return event_subscriptions_.find(event) != event_subscriptions_.end();
+    return (mask_.load(std::memory_order_acquire)
+            & (1U << static_cast<uint32_t>(event)))
+           != 0;
 }
 
 size_t rai::Subscriptions::Size() const
@@ -384,7 +446,7 @@ rai::ErrorCode rai::Subscriptions::Subscribe(const rai::Account& account,
         return rai::ErrorCode::SUBSCRIBE_TIMESTAMP;
     }
 
-    if (!node_.config_.callback_url_)
+    if (!node_.config_.callback_url_ && !node_.websocket_server_)
     {
         return rai::ErrorCode::SUBSCRIBE_NO_CALLBACK;
     }
@@ -432,7 +494,7 @@ rai::ErrorCode rai::Subscriptions::Subscribe(const rai::Account& account,
 
 rai::ErrorCode rai::Subscriptions::Subscribe(const std::string& str)
 {
-    if (!node_.config_.callback_url_)
+    if (!node_.config_.callback_url_ && !node_.websocket_server_)
     {
         return rai::ErrorCode::SUBSCRIBE_NO_CALLBACK;
     }
@@ -488,19 +550,31 @@ void rai::Subscriptions::StartElection_(rai::Transaction& transaction,
 
 void rai::Subscriptions::BlockConfirm_(rai::Transaction& transaction,
                                        const std::shared_ptr<rai::Block>& block,
-                                       uint64_t head_height)
+                                       uint64_t head_height, bool notify)
 {
-    if (block->Height() == head_height
-        && (Exists(block->Account())
-            || Exists(rai::SubscriptionEvent::BLOCK_CONFIRM)))
+    if (block->Height() == head_height && notify)
     {
-        rai::Ptree ptree;
-        ptree.put("notify", "block_confirm");
-        ptree.put("account", block->Account().StringAccount());
-        rai::Ptree block_ptree;
-        block->SerializeJson(block_ptree);
-        ptree.put_child("block", block_ptree);
-        node_.SendCallback(ptree);
+        if (!node_.callback_outbox_ || node_.websocket_server_)
+        {
+            std::string notify;
+            notify.reserve(1024);
+            rai::JsonWriter writer(notify);
+            writer.StartObject();
+            BlockConfirmNotify_(*block, writer);
+            writer.EndObject();
+            if (node_.callback_outbox_)
+            {
+                node_.websocket_server_->Publish(
+                    block->Account(), rai::SubscriptionEvent::BLOCK_CONFIRM,
+                    notify);
+            }
+            else
+            {
+                node_.Notify(block->Account(),
+                             rai::SubscriptionEvent::BLOCK_CONFIRM,
+                             std::move(notify));
+            }
+        }
     }
 
     if (block->Opcode() == rai::BlockOpcode::SEND && Exists(block->Link()))
@@ -520,11 +594,36 @@ void rai::Subscriptions::BlockConfirm_(rai::Transaction& transaction,
             rai::Ptree source_block;
             block->SerializeJson(source_block);
             ptree.put_child("source_block", source_block);
-            node_.SendCallback(ptree);
+            node_.Notify(block->Link(), rai::SubscriptionEvent::INVALID, ptree);
         }
     }
 }
 
+bool rai::Subscriptions::BlockConfirmOutbox(rai::Transaction& transaction,
+                                            const rai::Block& block)
+{
+    // every confirmation is recorded, subscriptions expire but the callback
+    // server must see the full stream
+    if (!node_.callback_outbox_)
+    {
+        return false;
+    }
+
+    uint64_t sequence = 0;
+    bool error = node_.ledger_.CallbackNext(transaction, sequence);
+    IF_ERROR_RETURN(error, error);
+
+    std::string notify;
+    notify.reserve(1024);
+    rai::JsonWriter writer(notify);
+    writer.StartObject();
+    BlockConfirmNotify_(block, writer);
+    writer.Put("sequence", sequence);
+    writer.EndObject();
+
+    return node_.ledger_.CallbackPut(transaction, sequence, notify);
+}
+
 bool rai::Subscriptions::NeedConfirm_(rai::Transaction& transaction,
                                       const rai::Account& account)
 {
@@ -575,3 +674,34 @@ bool rai::Subscriptions::NeedConfirm_(rai::Transaction& transaction,
 
     return false;
 }
+
+void rai::Subscriptions::BlockConfirmNotify_(const rai::Block& block,
+                                             rai::JsonWriter& writer) const
+{
+    writer.Put("notify", "block_confirm");
+    writer.Put("account", block.Account().StringAccount());
+    writer.Key("block");
+    block.SerializeJson(writer);
+}
+
+void rai::Subscriptions::UpdateIndex_()
+{
+    // mutex_ held by the caller
+    auto accounts = std::make_shared<std::unordered_set<rai::Account>>();
+    accounts->reserve(subscriptions_.size());
+    for (const auto& i : subscriptions_)
+    {
+        accounts->insert(i.account_);
+    }
+
+    uint32_t mask = accounts->empty() ? 0 : rai::Subscriptions::MASK_ACCOUNTS;
+    for (const auto& i : event_subscriptions_)
+    {
+        mask |= 1U << static_cast<uint32_t>(i.first);
+    }
+
+    std::atomic_store(
+        &accounts_,
+        std::shared_ptr<const std::unordered_set<rai::Account>>(accounts));
+    mask_.store(mask, std::memory_order_release);
+}
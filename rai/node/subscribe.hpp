@@ -1,5 +1,8 @@
 #pragma once
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <unordered_set>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
@@ -38,10 +41,12 @@ class Subscriptions
 {
 public:
     Subscriptions(rai::Node&);
+    bool Active() const;
     void Add(const rai::Account&);
     void Add(rai::SubscriptionEvent);
     void BlockAppend(const std::shared_ptr<rai::Block>&);
     void BlockConfirm(const std::shared_ptr<rai::Block>&, uint64_t);
+    bool BlockConfirmOutbox(rai::Transaction&, const rai::Block&);
     void BlockRollback(const std::shared_ptr<rai::Block>&);
     void BlockDrop(const std::shared_ptr<rai::Block>&);
     void BlockFork(bool, const std::shared_ptr<rai::Block>&,
@@ -65,12 +70,17 @@ public:
     static std::chrono::seconds constexpr CUTOFF_TIME =
         std::chrono::seconds(900);
     static uint64_t constexpr TIME_DIFF = 150;
+    static size_t constexpr MAX_CONFIRM_RECEIVABLES = 1024;
+    // set in the mask while any account is subscribed
+    static uint32_t constexpr MASK_ACCOUNTS = 1U << 31;
 
 private:
     void StartElection_(rai::Transaction&, const rai::Account&);
     void BlockConfirm_(rai::Transaction&, const std::shared_ptr<rai::Block>&,
-                       uint64_t);
+                       uint64_t, bool);
     bool NeedConfirm_(rai::Transaction&, const rai::Account&);
+    void BlockConfirmNotify_(const rai::Block&, rai::JsonWriter&) const;
+    void UpdateIndex_();
 
     rai::Node& node_;
     mutable std::mutex mutex_;
@@ -88,5 +98,11 @@ private:
     std::unordered_map<rai::SubscriptionEvent,
                        std::chrono::steady_clock::time_point>
         event_subscriptions_;
+
+    // Read side index, rebuilt under mutex_ whenever the subscribed set
+    // changes so lookups on the block observer path never lock. A zero mask
+    // means nobody is subscribed.
+    std::atomic<uint32_t> mask_;
+    std::shared_ptr<const std::unordered_set<rai::Account>> accounts_;
 };
 }
\ No newline at end of file
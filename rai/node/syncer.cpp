@@ -224,6 +224,29 @@ void rai::Syncer::ProcessorCallback(const rai::BlockProcessResult& result,
     }
 }
 
+void rai::Syncer::Resync()
+{
+    std::vector<std::pair<rai::Account, rai::SyncInfo>> queries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& i : syncs_)
+        {
+            if (i.second.status_ != rai::SyncStatus::PROCESS)
+            {
+                continue;
+            }
+            i.second.status_  = rai::SyncStatus::QUERY;
+            i.second.current_ = rai::BlockHash(0);
+            queries.emplace_back(i.first, i.second);
+        }
+    }
+
+    for (const auto& i : queries)
+    {
+        BlockQuery_(i.first, i.second, i.second.batch_id_);
+    }
+}
+
 void rai::Syncer::QueryCallback(const rai::Account& account,
                                 rai::QueryStatus status,
                                 const std::shared_ptr<rai::Block>& block)
@@ -64,6 +64,8 @@ public:
     void ResetStat();
     size_t Size() const;
     size_t Queries() const;
+    // Queries again accounts waiting for a processor callback that was lost
+    void Resync();
     void SyncAccount(rai::Transaction&, const rai::Account&, uint32_t);
     void SyncRelated(const std::shared_ptr<rai::Block>&, uint32_t);
 
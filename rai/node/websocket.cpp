@@ -0,0 +1,630 @@
+#include <rai/node/websocket.hpp>
+
+#include <rai/common/json.hpp>
+#include <rai/common/log.hpp>
+#include <rai/common/stat.hpp>
+#include <rai/node/node.hpp>
+#include <rai/secure/rpc.hpp>
+
+uint16_t constexpr rai::WebsocketServerConfig::DEFAULT_PORT;
+uint32_t constexpr rai::WebsocketServerConfig::DEFAULT_MAX_CONNECTIONS;
+uint32_t constexpr rai::WebsocketServerConfig::DEFAULT_QUEUE_SIZE;
+uint32_t constexpr rai::WebsocketServerConfig::DEFAULT_MAX_ACCOUNTS;
+
+rai::WebsocketServerConfig::WebsocketServerConfig()
+    : enable_(false),
+      address_(boost::asio::ip::address_v4::any()),
+      port_(rai::WebsocketServerConfig::DEFAULT_PORT),
+      max_connections_(rai::WebsocketServerConfig::DEFAULT_MAX_CONNECTIONS),
+      queue_size_(rai::WebsocketServerConfig::DEFAULT_QUEUE_SIZE),
+      max_accounts_(rai::WebsocketServerConfig::DEFAULT_MAX_ACCOUNTS)
+{
+}
+
+rai::ErrorCode rai::WebsocketServerConfig::DeserializeJson(bool& upgraded,
+                                                           rai::Ptree& ptree)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::JSON_CONFIG_WEBSOCKET;
+    try
+    {
+        enable_ = ptree.get<bool>("enable");
+
+        std::string address = ptree.get<std::string>("address");
+        boost::system::error_code ec;
+        address_ = boost::asio::ip::make_address_v4(address, ec);
+        if (ec)
+        {
+            return error_code;
+        }
+
+        port_ = ptree.get<uint16_t>("port");
+        max_connections_ = ptree.get<uint32_t>("max_connections");
+        queue_size_ = ptree.get<uint32_t>("queue_size");
+        max_accounts_ = ptree.get<uint32_t>("max_accounts");
+        if (max_connections_ == 0 || queue_size_ == 0)
+        {
+            return error_code;
+        }
+    }
+    catch (const std::exception&)
+    {
+        return error_code;
+    }
+    return rai::ErrorCode::SUCCESS;
+}
+
+void rai::WebsocketServerConfig::SerializeJson(rai::Ptree& ptree) const
+{
+    ptree.put("enable", enable_);
+    ptree.put("address", address_.to_string());
+    ptree.put("port", port_);
+    ptree.put("max_connections", max_connections_);
+    ptree.put("queue_size", queue_size_);
+    ptree.put("max_accounts", max_accounts_);
+}
+
+rai::WebsocketSession::WebsocketSession(rai::WebsocketServer& server,
+                                        boost::asio::io_service& service)
+    : ws_(service),
+      server_(server),
+      strand_(service),
+      closed_(false),
+      writing_(false),
+      events_(0)
+{
+}
+
+void rai::WebsocketSession::Start()
+{
+    auto session(shared_from_this());
+    ws_.read_message_max(rai::RpcHandler::MAX_BODY_SIZE);
+    strand_.dispatch([session]() {
+        session->ws_.async_accept(session->strand_.wrap(
+            [session](const boost::system::error_code& ec) {
+                session->OnAccept_(ec);
+            }));
+    });
+}
+
+void rai::WebsocketSession::Send(
+    const std::shared_ptr<const std::string>& message)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_)
+    {
+        return;
+    }
+
+    if (queue_.size() >= server_.config_.queue_size_)
+    {
+        // a slow consumer must not hold memory or delay other clients, it
+        // can reconnect and resubscribe once it catches up
+        closed_ = true;
+        queue_.clear();
+        server_.Evicted();
+        auto session(shared_from_this());
+        strand_.post([session]() { session->Close_(); });
+        return;
+    }
+
+    queue_.push_back(message);
+    if (!writing_)
+    {
+        writing_ = true;
+        auto session(shared_from_this());
+        strand_.post([session]() { session->Write_(); });
+    }
+}
+
+void rai::WebsocketSession::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        queue_.clear();
+    }
+    auto session(shared_from_this());
+    strand_.post([session]() { session->Close_(); });
+}
+
+bool rai::WebsocketSession::Wants(const rai::Account& account,
+                                  rai::SubscriptionEvent event) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_)
+    {
+        return false;
+    }
+    if (events_ & (1U << static_cast<uint32_t>(event)))
+    {
+        return true;
+    }
+    return accounts_.find(account) != accounts_.end();
+}
+
+void rai::WebsocketSession::Refresh(rai::Subscriptions& subscriptions) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& i : accounts_)
+    {
+        subscriptions.Add(i);
+    }
+    for (uint32_t i = static_cast<uint32_t>(rai::SubscriptionEvent::BLOCK_APPEND);
+         i <= static_cast<uint32_t>(rai::SubscriptionEvent::BLOCK_ROLLBACK);
+         ++i)
+    {
+        if (events_ & (1U << i))
+        {
+            subscriptions.Add(static_cast<rai::SubscriptionEvent>(i));
+        }
+    }
+}
+
+void rai::WebsocketSession::OnAccept_(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        Close_();
+        return;
+    }
+
+    Read_();
+}
+
+void rai::WebsocketSession::Read_()
+{
+    auto session(shared_from_this());
+    ws_.async_read(
+        buffer_, strand_.wrap([session](const boost::system::error_code& ec,
+                                        size_t) { session->OnRead_(ec); }));
+}
+
+void rai::WebsocketSession::OnRead_(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        Close_();
+        return;
+    }
+
+    std::string message(buffer_.size(), '\0');
+    boost::asio::buffer_copy(boost::asio::buffer(&message[0], message.size()),
+                             buffer_.data());
+    buffer_.consume(buffer_.size());
+
+    Process_(message);
+    Read_();
+}
+
+void rai::WebsocketSession::Write_()
+{
+    std::shared_ptr<const std::string> message;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || queue_.empty())
+        {
+            writing_ = false;
+            return;
+        }
+        message = queue_.front();
+    }
+
+    auto session(shared_from_this());
+    ws_.text(true);
+    ws_.async_write(boost::asio::buffer(*message),
+                    strand_.wrap([session, message](
+                                     const boost::system::error_code& ec,
+                                     size_t) { session->OnWrite_(ec); }));
+}
+
+void rai::WebsocketSession::OnWrite_(const boost::system::error_code& ec)
+{
+    if (ec)
+    {
+        Close_();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!queue_.empty())
+        {
+            queue_.pop_front();
+        }
+    }
+    server_.Sent();
+    Write_();
+}
+
+void rai::WebsocketSession::Close_()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        queue_.clear();
+    }
+
+    boost::system::error_code ec;
+    ws_.next_layer().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    ws_.next_layer().close(ec);
+    server_.Erase(this);
+}
+
+void rai::WebsocketSession::Process_(const std::string& message)
+{
+    rai::Ptree request;
+    rai::Ptree response;
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+
+    rai::JsonReader reader(rai::RpcHandler::MAX_JSON_DEPTH);
+    rai::JsonPtreeHandler handler(request);
+    if (reader.Parse(message, handler))
+    {
+        error_code = reader.DepthExceeded() ? rai::ErrorCode::RPC_JSON_DEPTH
+                                            : rai::ErrorCode::RPC_JSON;
+        Respond_(request, response, error_code);
+        return;
+    }
+
+    auto action_o = request.get_optional<std::string>("action");
+    if (!action_o)
+    {
+        error_code = rai::ErrorCode::RPC_MISS_FIELD_ACTION;
+    }
+    else if (*action_o == "account_subscribe")
+    {
+        error_code = AccountSubscribe_(request, response);
+    }
+    else if (*action_o == "account_unsubscribe")
+    {
+        error_code = AccountUnsubscribe_(request, response);
+    }
+    else if (*action_o == "event_subscribe")
+    {
+        error_code = EventSubscribe_(request, true);
+    }
+    else if (*action_o == "event_unsubscribe")
+    {
+        error_code = EventSubscribe_(request, false);
+    }
+    else
+    {
+        error_code = rai::ErrorCode::RPC_UNKNOWN_ACTION;
+    }
+
+    if (error_code == rai::ErrorCode::SUCCESS)
+    {
+        response.put("success", "");
+    }
+    Respond_(request, response, error_code);
+}
+
+rai::ErrorCode rai::WebsocketSession::AccountSubscribe_(
+    const rai::Ptree& request, rai::Ptree& response)
+{
+    auto account_o = request.get_optional<std::string>("account");
+    if (!account_o)
+    {
+        return rai::ErrorCode::RPC_MISS_FIELD_ACCOUNT;
+    }
+    rai::Account account;
+    if (account.DecodeAccount(*account_o))
+    {
+        return rai::ErrorCode::RPC_INVALID_FIELD_ACCOUNT;
+    }
+    response.put("account", account.StringAccount());
+
+    auto timestamp_o = request.get_optional<std::string>("timestamp");
+    if (!timestamp_o)
+    {
+        return rai::ErrorCode::RPC_MISS_FIELD_TIMESTAMP;
+    }
+    uint64_t timestamp;
+    if (rai::StringToUint(*timestamp_o, timestamp))
+    {
+        return rai::ErrorCode::RPC_INVALID_FIELD_TIMESTAMP;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (accounts_.find(account) == accounts_.end()
+            && accounts_.size() >= server_.config_.max_accounts_)
+        {
+            return rai::ErrorCode::WEBSOCKET_ACCOUNTS_FULL;
+        }
+    }
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    auto signature_o = request.get_optional<std::string>("signature");
+    if (signature_o)
+    {
+        rai::Signature signature;
+        if (signature.DecodeHex(*signature_o))
+        {
+            return rai::ErrorCode::RPC_INVALID_FIELD_SIGNATURE;
+        }
+        error_code = server_.node_.subscriptions_.Subscribe(account, timestamp,
+                                                            signature);
+    }
+    else
+    {
+        error_code = server_.node_.subscriptions_.Subscribe(account, timestamp);
+    }
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    accounts_.insert(account);
+    response.put("verified", signature_o ? "true" : "false");
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::WebsocketSession::AccountUnsubscribe_(
+    const rai::Ptree& request, rai::Ptree& response)
+{
+    auto account_o = request.get_optional<std::string>("account");
+    if (!account_o)
+    {
+        return rai::ErrorCode::RPC_MISS_FIELD_ACCOUNT;
+    }
+    rai::Account account;
+    if (account.DecodeAccount(*account_o))
+    {
+        return rai::ErrorCode::RPC_INVALID_FIELD_ACCOUNT;
+    }
+    response.put("account", account.StringAccount());
+
+    // the node wide subscription may be shared with other clients, it ages
+    // out once nobody refreshes it
+    std::lock_guard<std::mutex> lock(mutex_);
+    accounts_.erase(account);
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::WebsocketSession::EventSubscribe_(const rai::Ptree& request,
+                                                      bool subscribe)
+{
+    auto event_o = request.get_optional<std::string>("event");
+    if (!event_o)
+    {
+        return rai::ErrorCode::RPC_MISS_FIELD_EVENT;
+    }
+
+    rai::SubscriptionEvent event = rai::StringToSubscriptionEvent(*event_o);
+    if (event == rai::SubscriptionEvent::INVALID)
+    {
+        return rai::ErrorCode::SUBSCRIPTION_EVENT;
+    }
+
+    if (subscribe)
+    {
+        rai::ErrorCode error_code =
+            server_.node_.subscriptions_.Subscribe(*event_o);
+        IF_NOT_SUCCESS_RETURN(error_code);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (subscribe)
+    {
+        events_ |= 1U << static_cast<uint32_t>(event);
+    }
+    else
+    {
+        events_ &= ~(1U << static_cast<uint32_t>(event));
+    }
+    return rai::ErrorCode::SUCCESS;
+}
+
+void rai::WebsocketSession::Respond_(const rai::Ptree& request,
+                                     rai::Ptree& response,
+                                     rai::ErrorCode error_code)
+{
+    auto action_o = request.get_optional<std::string>("action");
+    if (action_o)
+    {
+        response.put("ack", *action_o);
+    }
+    auto request_id_o = request.get_optional<std::string>("request_id");
+    if (request_id_o)
+    {
+        response.put("request_id", *request_id_o);
+    }
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        response.put("error", rai::ErrorString(error_code));
+        response.put("error_code", static_cast<uint32_t>(error_code));
+        rai::Stats::Add(error_code);
+    }
+
+    Send(std::make_shared<const std::string>(rai::PtreeToJson(response)));
+}
+
+rai::WebsocketServer::WebsocketServer(rai::Node& node,
+                                      boost::asio::io_service& service,
+                                      const rai::WebsocketServerConfig& config)
+    : node_(node),
+      config_(config),
+      service_(service),
+      acceptor_(service),
+      stopped_(false),
+      accepted_(0),
+      rejected_(0),
+      sent_(0),
+      evicted_(0)
+{
+}
+
+void rai::WebsocketServer::Start()
+{
+    boost::asio::ip::tcp::endpoint endpoint(config_.address_, config_.port_);
+    acceptor_.open(endpoint.protocol());
+    acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+
+    boost::system::error_code ec;
+    acceptor_.bind(endpoint, ec);
+    if (ec)
+    {
+        rai::Log::Network(boost::str(
+            boost::format("Error while binding for websocket on port %1%: %2%")
+            % endpoint.port() % ec.message()));
+        throw std::runtime_error(ec.message());
+    }
+
+    acceptor_.listen();
+    Accept_();
+}
+
+void rai::WebsocketServer::Stop()
+{
+    std::vector<std::shared_ptr<rai::WebsocketSession>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            return;
+        }
+        stopped_ = true;
+        for (const auto& i : sessions_)
+        {
+            sessions.push_back(i.second);
+        }
+    }
+
+    boost::system::error_code ec;
+    acceptor_.close(ec);
+    for (const auto& i : sessions)
+    {
+        i->Close();
+    }
+}
+
+void rai::WebsocketServer::Publish(const rai::Account& account,
+                                   rai::SubscriptionEvent event,
+                                   const std::string& notify)
+{
+    std::vector<std::shared_ptr<rai::WebsocketSession>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions.reserve(sessions_.size());
+        for (const auto& i : sessions_)
+        {
+            sessions.push_back(i.second);
+        }
+    }
+
+    // serialized once, the buffer is shared by all matching sessions
+    std::shared_ptr<const std::string> message;
+    for (const auto& i : sessions)
+    {
+        if (!i->Wants(account, event))
+        {
+            continue;
+        }
+        if (!message)
+        {
+            message = std::make_shared<const std::string>(notify);
+        }
+        i->Send(message);
+    }
+}
+
+void rai::WebsocketServer::Refresh()
+{
+    std::vector<std::shared_ptr<rai::WebsocketSession>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& i : sessions_)
+        {
+            sessions.push_back(i.second);
+        }
+    }
+
+    // subscriptions of connected clients never age out
+    for (const auto& i : sessions)
+    {
+        i->Refresh(node_.subscriptions_);
+    }
+}
+
+void rai::WebsocketServer::Erase(const rai::WebsocketSession* session)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions_.erase(session);
+}
+
+void rai::WebsocketServer::Evicted()
+{
+    ++evicted_;
+    rai::Stats::Add(rai::ErrorCode::WEBSOCKET_SLOW_CONSUMER);
+}
+
+void rai::WebsocketServer::Sent()
+{
+    ++sent_;
+}
+
+rai::WebsocketServerStat rai::WebsocketServer::Stat() const
+{
+    rai::WebsocketServerStat stat;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stat.connections_ = sessions_.size();
+    }
+    stat.accepted_ = accepted_;
+    stat.rejected_ = rejected_;
+    stat.sent_ = sent_;
+    stat.evicted_ = evicted_;
+    return stat;
+}
+
+void rai::WebsocketServer::Accept_()
+{
+    auto session = std::make_shared<rai::WebsocketSession>(*this, service_);
+    acceptor_.async_accept(
+        session->ws_.next_layer(),
+        [this, session](const boost::system::error_code& ec) {
+            if (ec)
+            {
+                if (boost::asio::error::operation_aborted != ec)
+                {
+                    rai::Log::Network(boost::str(
+                        boost::format("Error accepting websocket: %1%")
+                        % ec.message()));
+                }
+            }
+            else
+            {
+                bool full = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (stopped_)
+                    {
+                        return;
+                    }
+                    full = sessions_.size() >= config_.max_connections_;
+                    if (!full)
+                    {
+                        sessions_[session.get()] = session;
+                    }
+                }
+
+                if (full)
+                {
+                    ++rejected_;
+                    rai::Stats::Add(
+                        rai::ErrorCode::WEBSOCKET_CONNECTIONS_FULL);
+                    boost::system::error_code ignore;
+                    session->ws_.next_layer().close(ignore);
+                }
+                else
+                {
+                    ++accepted_;
+                    session->Start();
+                }
+            }
+
+            if (acceptor_.is_open())
+            {
+                Accept_();
+            }
+        });
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+#include <rai/common/errors.hpp>
+#include <rai/common/numbers.hpp>
+#include <rai/common/parameters.hpp>
+#include <rai/common/util.hpp>
+#include <rai/node/subscribe.hpp>
+
+namespace rai
+{
+class Node;
+
+class WebsocketServerConfig
+{
+public:
+    WebsocketServerConfig();
+    rai::ErrorCode DeserializeJson(bool&, rai::Ptree&);
+    void SerializeJson(rai::Ptree&) const;
+
+    static uint16_t constexpr DEFAULT_PORT =
+        rai::RAI_NETWORK == rai::RaiNetworks::LIVE ? 7178 : 54303;
+    static uint32_t constexpr DEFAULT_MAX_CONNECTIONS = 1024;
+    static uint32_t constexpr DEFAULT_QUEUE_SIZE      = 256;
+    static uint32_t constexpr DEFAULT_MAX_ACCOUNTS    = 1024;
+
+    bool enable_;
+    boost::asio::ip::address_v4 address_;
+    uint16_t port_;
+    uint32_t max_connections_;
+    // messages waiting to be written, a client falling further behind is
+    // disconnected
+    uint32_t queue_size_;
+    // account subscriptions per connection
+    uint32_t max_accounts_;
+};
+
+class WebsocketServerStat
+{
+public:
+    size_t connections_;
+    uint64_t accepted_;
+    uint64_t rejected_;
+    uint64_t sent_;
+    uint64_t evicted_;
+};
+
+class WebsocketServer;
+
+// One client connection. The client subscribes to accounts and events with
+// the same requests the RPC takes, and only receives notifications matching
+// its own filters. All stream work runs on the session's strand.
+class WebsocketSession
+    : public std::enable_shared_from_this<rai::WebsocketSession>
+{
+public:
+    WebsocketSession(rai::WebsocketServer&, boost::asio::io_service&);
+    void Start();
+    void Send(const std::shared_ptr<const std::string>&);
+    void Close();
+    bool Wants(const rai::Account&, rai::SubscriptionEvent) const;
+    void Refresh(rai::Subscriptions&) const;
+
+    boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws_;
+
+private:
+    void OnAccept_(const boost::system::error_code&);
+    void Read_();
+    void OnRead_(const boost::system::error_code&);
+    void Write_();
+    void OnWrite_(const boost::system::error_code&);
+    void Close_();
+    void Process_(const std::string&);
+    rai::ErrorCode AccountSubscribe_(const rai::Ptree&, rai::Ptree&);
+    rai::ErrorCode AccountUnsubscribe_(const rai::Ptree&, rai::Ptree&);
+    rai::ErrorCode EventSubscribe_(const rai::Ptree&, bool);
+    void Respond_(const rai::Ptree&, rai::Ptree&, rai::ErrorCode);
+
+    rai::WebsocketServer& server_;
+    boost::asio::io_service::strand strand_;
+    boost::beast::flat_buffer buffer_;
+
+    mutable std::mutex mutex_;
+    bool closed_;
+    bool writing_;
+    std::deque<std::shared_ptr<const std::string>> queue_;
+    std::unordered_set<rai::Account> accounts_;
+    // bit per rai::SubscriptionEvent
+    uint32_t events_;
+};
+
+// Hosts push subscriptions for wallets and services directly in the node,
+// each notification is serialized once and shared by every matching client
+class WebsocketServer
+{
+public:
+    WebsocketServer(rai::Node&, boost::asio::io_service&,
+                    const rai::WebsocketServerConfig&);
+    void Start();
+    void Stop();
+    void Publish(const rai::Account&, rai::SubscriptionEvent,
+                 const std::string&);
+    void Refresh();
+    void Erase(const rai::WebsocketSession*);
+    void Evicted();
+    void Sent();
+    rai::WebsocketServerStat Stat() const;
+
+    rai::Node& node_;
+    rai::WebsocketServerConfig config_;
+
+private:
+    void Accept_();
+
+    boost::asio::io_service& service_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    mutable std::mutex mutex_;
+    bool stopped_;
+    std::unordered_map<const rai::WebsocketSession*,
+                       std::shared_ptr<rai::WebsocketSession>>
+        sessions_;
+    std::atomic<uint64_t> accepted_;
+    std::atomic<uint64_t> rejected_;
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> evicted_;
+};
+}  // namespace rai
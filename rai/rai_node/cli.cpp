@@ -3,6 +3,7 @@
 #include <iostream>
 #include <boost/filesystem.hpp>
 #include <rai/common/parameters.hpp>
+#include <rai/secure/ledger.hpp>
 #include <rai/secure/util.hpp>
 #include <rai/rai_node/daemon.hpp>
 
@@ -172,6 +173,8 @@ rai::ErrorCode ProcessVersion(const boost::program_options::variables_map& vm,
 {
     std::cout << rai::RAI_VERSION_STRING << " " << rai::NetworkString()
               << " network" << std::endl;
+    std::cout << "crypto kernels: blake2b " << rai::Blake2bKernel()
+              << ", ed25519 " << rai::Ed25519Kernel() << std::endl;
     return rai::ErrorCode::SUCCESS;
 }
 
@@ -217,6 +220,79 @@ rai::ErrorCode ProcessConfigCreate(
     return rai::ErrorCode::SUCCESS;
 }
 
+boost::filesystem::path SnapshotPath(
+    const boost::program_options::variables_map& vm,
+    const boost::filesystem::path& data_path)
+{
+    std::string file = vm["file"].as<std::string>();
+    if ((file.find("/") != std::string::npos)
+        || (file.find("\\") != std::string::npos))
+    {
+        return boost::filesystem::absolute(boost::filesystem::path(file));
+    }
+    return data_path / file;
+}
+
+rai::ErrorCode ProcessSnapshotExport(
+    const boost::program_options::variables_map& vm,
+    const boost::filesystem::path& data_path)
+{
+    if (!vm.count("file"))
+    {
+        std::cout << "Error: please specify the 'file' parameter" << std::endl;
+        return rai::ErrorCode::SUCCESS;
+    }
+    boost::filesystem::path snapshot_path = SnapshotPath(vm, data_path);
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, data_path / "data.ldb");
+    IF_NOT_SUCCESS_RETURN(error_code);
+    rai::Ledger ledger(error_code, store, true);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    // A single read transaction gives a consistent view of the ledger, so
+    // the snapshot can be exported while the daemon is running
+    rai::Transaction transaction(error_code, ledger, false);
+    IF_NOT_SUCCESS_RETURN(error_code);
+    error_code = ledger.SnapshotExport(transaction, snapshot_path);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    std::cout << "Success, the snapshot was saved to:" << snapshot_path
+              << std::endl;
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode ProcessSnapshotImport(
+    const boost::program_options::variables_map& vm,
+    const boost::filesystem::path& data_path)
+{
+    if (!vm.count("file"))
+    {
+        std::cout << "Error: please specify the 'file' parameter" << std::endl;
+        return rai::ErrorCode::SUCCESS;
+    }
+    boost::filesystem::path snapshot_path = SnapshotPath(vm, data_path);
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    rai::Store store(error_code, data_path / "data.ldb");
+    IF_NOT_SUCCESS_RETURN(error_code);
+    rai::Ledger ledger(error_code, store, true);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    rai::Transaction transaction(error_code, ledger, true);
+    IF_NOT_SUCCESS_RETURN(error_code);
+    error_code = ledger.SnapshotImport(transaction, snapshot_path);
+    if (error_code != rai::ErrorCode::SUCCESS)
+    {
+        transaction.Abort();
+        return error_code;
+    }
+
+    std::cout << "Success, the snapshot was imported to:"
+              << data_path / "data.ldb" << std::endl;
+    return rai::ErrorCode::SUCCESS;
+}
+
 }  // namespace
 
 void rai::CliAddOptions(boost::program_options::options_description& desc){
@@ -234,6 +310,8 @@ void rai::CliAddOptions(boost::program_options::options_description& desc){
         ("config_create", "Generate the config.json file")
         ("forward_reward_to", boost::program_options::value<std::string>(), "Specify a wallet account to receive node reward")
         ("raw_key", "Specify daemon to start with raw private key")
+        ("snapshot_export", "Export a compressed ledger snapshot to <file>")
+        ("snapshot_import", "Import a ledger snapshot from <file> into an empty <data_path>")
         ;
 
     // clang-format on
@@ -292,6 +370,14 @@ rai::ErrorCode rai::CliProcessOptions(
         {
             error_code = ProcessConfigCreate(vm, data_path);
         }
+        else if (vm.count("snapshot_export"))
+        {
+            error_code = ProcessSnapshotExport(vm, data_path);
+        }
+        else if (vm.count("snapshot_import"))
+        {
+            error_code = ProcessSnapshotImport(vm, data_path);
+        }
         else
         {
             error_code = rai::ErrorCode::UNKNOWN_COMMAND;
@@ -59,6 +59,11 @@ rai::ErrorCode rai::Daemon::Run(const boost::filesystem::path& data_path,
 
         rai::ServiceRunner runner(service, config.node_.io_threads_);
         runner.Join();
+        // requests still running on the RPC workers use the node
+        if (rpc != nullptr)
+        {
+            rpc->Stop();
+        }
     }
     catch (const std::exception& e)
     {
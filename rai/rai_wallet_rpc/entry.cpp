@@ -245,6 +245,7 @@ rai::ErrorCode Process(const boost::program_options::variables_map& vm,
 
         rai::ServiceRunner runner(service, 1);
         runner.Join();
+        rpc->Stop();
     }
     catch (const std::exception& e)
     {
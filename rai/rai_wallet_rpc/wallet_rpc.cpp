@@ -12,6 +12,8 @@ rai::WalletRpcConfig::WalletRpcConfig()
     rpc_.whitelist_ = {
         boost::asio::ip::address_v4::loopback(),
     };
+    rpc_.workers_ = rai::RpcConfig::DEFAULT_WORKERS;
+    rpc_.queue_size_ = rai::RpcConfig::DEFAULT_QUEUE_SIZE;
     rai::uint128_union api_key;
     rai::random_pool.GenerateBlock(api_key.bytes.data(), api_key.bytes.size());
     rai_api_key_ = api_key.StringHex();
@@ -180,39 +182,31 @@ void rai::WalletRpcHandler::ProcessImpl()
     CheckApiKey();
     IF_NOT_SUCCESS_RETURN_VOID(error_code_);
 
-    std::string action = request_.get<std::string>("action");
+    Call_(Actions());
+}
 
-    if (action == "account_info")
-    {
-        AccountInfo();
-    }
-    else if (action == "account_send")
-    {
-        AccountSend();
-    }
-    else if (action == "block_query")
-    {
-        BlockQuery();
-    }
-    else if (action == "current_account")
-    {
-        CurrentAccount();
-    }
-    else if (action == "status")
-    {
-        Status();
-    }
-    else if (action == "stop")
-    {
-        if (!CheckLocal_())
-        {
-            Stop();
-        }
-    }
-    else
-    {
-        error_code_ = rai::ErrorCode::RPC_UNKNOWN_ACTION;
-    }
+const std::unordered_map<std::string, rai::RpcAction<rai::WalletRpcHandler>>&
+rai::WalletRpcHandler::Actions()
+{
+    // action: {handler, control, local, read only}
+    static const std::unordered_map<std::string,
+                                    rai::RpcAction<rai::WalletRpcHandler>>
+        actions = {
+            {"account_info",
+             {&rai::WalletRpcHandler::AccountInfo, false, false, true}},
+            {"account_send",
+             {&rai::WalletRpcHandler::AccountSend, false, false, false}},
+            {"block_query",
+             {&rai::WalletRpcHandler::BlockQuery, false, false, true}},
+            {"current_account",
+             {&rai::WalletRpcHandler::CurrentAccount, false, false, true}},
+            {"rpc_stats", {&rai::RpcHandler::RpcStats, false, false, true}},
+            {"rpc_stats_clear",
+             {&rai::RpcHandler::RpcStatsClear, true, false, false}},
+            {"status", {&rai::WalletRpcHandler::Status, false, false, true}},
+            {"stop", {&rai::WalletRpcHandler::Stop, false, true, false}}
+        };
+    return actions;
 }
 
 void rai::WalletRpcHandler::CheckApiKey()
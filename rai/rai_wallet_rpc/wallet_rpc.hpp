@@ -58,6 +58,9 @@ public:
     void Status();
     void Stop();
 
+    static const std::unordered_map<std::string,
+                                    rai::RpcAction<rai::WalletRpcHandler>>&
+    Actions();
     static rai::ErrorCode ParseAccountSend(const rai::Ptree&, rai::Account&,
                                            rai::Amount&, std::vector<uint8_t>&);
 
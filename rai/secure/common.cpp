@@ -1,8 +1,12 @@
 #include <rai/secure/common.hpp>
 
+#include <ed25519-donna/ed25519.h>
 #include <phc-winner-argon2/include/argon2.h>
 #include <boost/endian/conversion.hpp>
+#include <rai/common/log.hpp>
 #include <rai/common/parameters.hpp>
+#include <rai/common/stat.hpp>
+#include <rai/secure/plat.hpp>
 
 rai::KeyPair::KeyPair()
 {
@@ -192,6 +196,129 @@ void rai::Fan::Set_(const rai::RawKey& key)
     *(values_[0]) ^= key.data_;
 }
 
+size_t constexpr rai::Signer::EXPANDED_KEY_SIZE;
+
+rai::Signer::Signer(const rai::Fan& key, uint64_t window)
+    : key_(key),
+      window_(window),
+      locked_(false),
+      loaded_(false),
+      expanded_(new uint8_t[rai::Signer::EXPANDED_KEY_SIZE])
+{
+    std::fill(expanded_.get(), expanded_.get() + EXPANDED_KEY_SIZE, 0);
+    locked_ = !rai::LockMemory(expanded_.get(), EXPANDED_KEY_SIZE);
+    if (!locked_ && window_.count() != 0)
+    {
+        window_ = std::chrono::seconds(0);
+        rai::Stats::Add(rai::ErrorCode::SIGNER_LOCK_MEMORY);
+        rai::Log::Error(rai::ErrorString(rai::ErrorCode::SIGNER_LOCK_MEMORY));
+    }
+
+    rai::RawKey private_key;
+    key_.Get(private_key);
+    public_key_ = rai::GeneratePublicKey(private_key.data_);
+}
+
+rai::Signer::~Signer()
+{
+    Wipe();
+    if (locked_)
+    {
+        rai::UnlockMemory(expanded_.get(), EXPANDED_KEY_SIZE);
+    }
+}
+
+rai::Signature rai::Signer::Sign(const rai::uint256_union& message) const
+{
+    rai::Signature result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    Load_();
+    Sign_(message, result);
+    if (window_.count() == 0)
+    {
+        Wipe_();
+    }
+    return result;
+}
+
+std::vector<rai::Signature> rai::Signer::Sign(
+    const std::vector<rai::uint256_union>& messages) const
+{
+    std::vector<rai::Signature> result(messages.size());
+    if (messages.empty())
+    {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Load_();
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        Sign_(messages[i], result[i]);
+    }
+    if (window_.count() == 0)
+    {
+        Wipe_();
+    }
+    return result;
+}
+
+void rai::Signer::Age() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loaded_)
+    {
+        return;
+    }
+    if (std::chrono::steady_clock::now() - last_use_ >= window_)
+    {
+        Wipe_();
+    }
+}
+
+void rai::Signer::Wipe() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Wipe_();
+}
+
+bool rai::Signer::Locked() const
+{
+    return locked_;
+}
+
+void rai::Signer::Load_() const
+{
+    last_use_ = std::chrono::steady_clock::now();
+    if (loaded_)
+    {
+        return;
+    }
+
+    rai::RawKey private_key;
+    key_.Get(private_key);
+    ed25519_expand_key(private_key.data_.bytes.data(), expanded_.get());
+    loaded_ = true;
+}
+
+void rai::Signer::Sign_(const rai::uint256_union& message,
+                        rai::Signature& signature) const
+{
+    ed25519_sign_expanded(message.bytes.data(), message.bytes.size(),
+                          expanded_.get(), public_key_.bytes.data(),
+                          signature.bytes.data());
+}
+
+void rai::Signer::Wipe_() const
+{
+    volatile uint8_t* data = expanded_.get();
+    for (size_t i = 0; i < EXPANDED_KEY_SIZE; ++i)
+    {
+        data[i] = 0;
+    }
+    loaded_ = false;
+}
+
 rai::Genesis::Genesis() : block_(nullptr)
 {
     std::string public_key_str = rai::GenesisPublicKey();
@@ -47,6 +47,39 @@ private:
     std::vector<std::unique_ptr<rai::uint256_union>> values_;
 };
 
+// Signs with a node key kept protected in a Fan. The expanded ed25519 key is
+// cached in locked memory while signing is frequent and wiped once it has been
+// idle for longer than the cache window (0 disables caching). If the memory
+// can't be locked the key is never cached.
+class Signer
+{
+public:
+    Signer(const rai::Fan&, uint64_t);
+    ~Signer();
+    rai::Signature Sign(const rai::uint256_union&) const;
+    std::vector<rai::Signature> Sign(
+        const std::vector<rai::uint256_union>&) const;
+    void Age() const;
+    void Wipe() const;
+    bool Locked() const;
+
+    static size_t constexpr EXPANDED_KEY_SIZE = 64;
+
+private:
+    void Load_() const;
+    void Sign_(const rai::uint256_union&, rai::Signature&) const;
+    void Wipe_() const;
+
+    const rai::Fan& key_;
+    rai::PublicKey public_key_;
+    std::chrono::seconds window_;
+    bool locked_;
+    mutable std::mutex mutex_;
+    mutable bool loaded_;
+    mutable std::chrono::steady_clock::time_point last_use_;
+    std::unique_ptr<uint8_t[]> expanded_;
+};
+
 class Genesis
 {
 public:
@@ -1,5 +1,65 @@
 #include <rai/secure/ledger.hpp>
 
+#include <algorithm>
+#include <blake2/blake2.h>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <rai/common/stat.hpp>
+
+uint32_t constexpr rai::Ledger::SNAPSHOT_MAGIC;
+uint32_t constexpr rai::Ledger::SNAPSHOT_VERSION;
+size_t constexpr rai::Ledger::PRUNE_ACCOUNTS_PER_BATCH;
+uint32_t constexpr rai::Ledger::SUMMARIES_VERSION;
+
+namespace
+{
+size_t constexpr SNAPSHOT_MAX_KEY_SIZE   = 511;
+size_t constexpr SNAPSHOT_MAX_VALUE_SIZE = 16 * 1024 * 1024;
+
+void SnapshotWrite(std::ostream& out, blake2b_state& state,
+                   const std::vector<uint8_t>& bytes)
+{
+    int ret = blake2b_update(&state, bytes.data(), bytes.size());
+    assert(0 == ret);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+bool SnapshotRead(std::istream& in, blake2b_state& state, uint8_t* data,
+                  size_t size)
+{
+    in.read(reinterpret_cast<char*>(data), size);
+    if (static_cast<size_t>(in.gcount()) != size)
+    {
+        return true;
+    }
+    int ret = blake2b_update(&state, data, size);
+    assert(0 == ret);
+    return false;
+}
+
+template <typename T>
+bool SnapshotRead(std::istream& in, blake2b_state& state, T& value)
+{
+    std::array<uint8_t, sizeof(T)> bytes;
+    bool error = SnapshotRead(in, state, bytes.data(), bytes.size());
+    IF_ERROR_RETURN(error, true);
+    rai::BufferStream stream(bytes.data(), bytes.size());
+    return rai::Read(stream, value);
+}
+
+// Only the ledger version is carried, the other meta records are derived or
+// local to the exporting node
+bool SnapshotMetaKey(const uint8_t* data, size_t size)
+{
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        rai::Write(stream, rai::MetaKey::VERSION);
+    }
+    return size == bytes.size() && std::equal(bytes.begin(), bytes.end(), data);
+}
+}  // namespace
+
 rai::RepWeightOpration::RepWeightOpration(bool add,
                                           const rai::Account& representative,
                                           const rai::Amount& weight)
@@ -7,6 +67,22 @@ rai::RepWeightOpration::RepWeightOpration(bool add,
 {
 }
 
+rai::RepWeightsSnapshot::RepWeightsSnapshot() : version_(0), total_(0)
+{
+}
+
+bool rai::RepWeightsSnapshot::Get(const rai::Account& representative,
+                                  rai::Amount& weight) const
+{
+    auto it = weights_.find(representative);
+    if (it == weights_.end())
+    {
+        return true;
+    }
+    weight = it->second;
+    return false;
+}
+
 rai::Transaction::Transaction(rai::ErrorCode& error_code, rai::Ledger& ledger,
                               bool write)
     : ledger_(ledger),
@@ -23,6 +99,13 @@ rai::Transaction::~Transaction()
         return;
     }
     ledger_.RepWeightsCommit_(rep_weight_operations_);
+    if (write_)
+    {
+        // bumped after the commit, anything read under the new version
+        // already sees this write
+        mdb_transaction_.Commit();
+        ++ledger_.version_;
+    }
 }
 
 void rai::Transaction::Abort()
@@ -160,6 +243,74 @@ bool rai::ReceivableInfo::operator>(const rai::ReceivableInfo& other) const
     return amount_ > other.amount_;
 }
 
+bool rai::ReceivableInfoEntry::operator<(
+    const rai::ReceivableInfoEntry& other) const
+{
+    if (info_.amount_ != other.info_.amount_)
+    {
+        return info_.amount_ > other.info_.amount_;
+    }
+    return hash_ < other.hash_;
+}
+
+rai::ReceivableInfosCursor::ReceivableInfosCursor()
+    : begin_(true), more_(false), amount_(0), hash_(0)
+{
+}
+
+bool rai::ReceivableInfosCursor::After(
+    const rai::ReceivableInfoEntry& entry) const
+{
+    if (begin_)
+    {
+        return true;
+    }
+
+    if (entry.info_.amount_ != amount_)
+    {
+        return entry.info_.amount_ < amount_;
+    }
+    return entry.hash_ > hash_;
+}
+
+void rai::ReceivableInfosCursor::Set(const rai::ReceivableInfoEntry& entry)
+{
+    begin_  = false;
+    amount_ = entry.info_.amount_;
+    hash_   = entry.hash_;
+}
+
+std::string rai::ReceivableInfosCursor::String() const
+{
+    if (begin_)
+    {
+        return "";
+    }
+    return amount_.StringHex() + hash_.StringHex();
+}
+
+bool rai::ReceivableInfosCursor::Decode(const std::string& str)
+{
+    if (str.empty())
+    {
+        *this = rai::ReceivableInfosCursor();
+        return false;
+    }
+
+    size_t amount_size = sizeof(amount_) * 2;
+    if (str.size() != amount_size + sizeof(hash_) * 2)
+    {
+        return true;
+    }
+    bool error = amount_.DecodeHex(str.substr(0, amount_size));
+    IF_ERROR_RETURN(error, true);
+    error = hash_.DecodeHex(str.substr(amount_size));
+    IF_ERROR_RETURN(error, true);
+    begin_ = false;
+    more_  = false;
+    return false;
+}
+
 void rai::ReceivableInfo::Serialize(rai::Stream& stream) const
 {
     rai::Write(stream, source_.bytes);
@@ -205,6 +356,26 @@ bool rai::RewardableInfo::Deserialize(rai::Stream& stream)
     return false;
 }
 
+rai::AmountSummary::AmountSummary() : count_(0), amount_(0)
+{
+}
+
+void rai::AmountSummary::Serialize(rai::Stream& stream) const
+{
+    rai::Write(stream, count_);
+    rai::Write(stream, amount_.bytes);
+}
+
+bool rai::AmountSummary::Deserialize(rai::Stream& stream)
+{
+    bool error = false;
+    error      = rai::Read(stream, count_);
+    IF_ERROR_RETURN(error, true);
+    error = rai::Read(stream, amount_.bytes);
+    IF_ERROR_RETURN(error, true);
+    return false;
+}
+
 rai::WalletInfo::WalletInfo()
     : version_(0), index_(0), salt_(0), key_(0), seed_(0), check_(0)
 {
@@ -264,20 +435,27 @@ bool rai::WalletAccountInfo::Deserialize(rai::Stream& stream)
 rai::Ledger::Ledger(rai::ErrorCode& error_code, rai::Store& store, bool is_node,
                     bool enable_rich_list, bool enable_delegator_list)
     : store_(store),
+      version_(0),
       total_rep_weight_(0),
+      rep_weights_version_(0),
+      rep_weights_snapshot_(std::make_shared<rai::RepWeightsSnapshot>()),
       enable_rich_list_(enable_rich_list),
       enable_delegator_list_(enable_delegator_list)
 {
     IF_NOT_SUCCESS_RETURN_VOID(error_code);
     rai::Transaction transaction(error_code, *this, true);
     IF_NOT_SUCCESS_RETURN_VOID(error_code);
-    if (is_node)
+    error_code = InitSummaries_(transaction);
+    if (error_code == rai::ErrorCode::SUCCESS)
     {
-        InitMemoryTables_(transaction);
-    }
-    else
-    {
-        error_code = UpgradeWallet(transaction);
+        if (is_node)
+        {
+            InitMemoryTables_(transaction);
+        }
+        else
+        {
+            error_code = UpgradeWallet(transaction);
+        }
     }
 
     if (error_code != rai::ErrorCode::SUCCESS)
@@ -1029,13 +1207,23 @@ bool rai::Ledger::ReceivableInfoPut(rai::Transaction& transaction,
         info.Serialize(stream);
     }
 
+    rai::ReceivableInfo previous;
+    bool exists = !ReceivableInfoGet(transaction, destination, hash, previous);
+
     rai::MdbVal key(bytes_key.size(), bytes_key.data());
     rai::MdbVal value(bytes_value.size(), bytes_value.data());
     bool error = store_.Put(transaction.mdb_transaction_, store_.receivables_,
                             key, value);
     IF_ERROR_RETURN(error, error);
 
-    return false;
+    if (exists)
+    {
+        error = SummaryUpdate_(transaction, store_.receivable_summaries_,
+                               destination, false, previous.amount_);
+        IF_ERROR_RETURN(error, error);
+    }
+    return SummaryUpdate_(transaction, store_.receivable_summaries_,
+                          destination, true, info.amount_);
 }
 
 bool rai::Ledger::ReceivableInfoGet(rai::Transaction& transaction,
@@ -1235,6 +1423,29 @@ bool rai::Ledger::ReceivableInfosGet(rai::Transaction& transaction,
     return false;
 }
 
+bool rai::Ledger::ReceivableInfosPage(
+    rai::Transaction& transaction, rai::ReceivableInfosType type,
+    size_t count, rai::ReceivableInfosCursor& cursor,
+    std::vector<rai::ReceivableInfoEntry>& page)
+{
+    rai::StoreIterator store_i(transaction.mdb_transaction_,
+                               store_.receivables_);
+    rai::Iterator i(std::move(store_i));
+    rai::Iterator n(rai::StoreIterator(nullptr));
+    return ReceivableInfosPage_(transaction, i, n, type, count, cursor, page);
+}
+
+bool rai::Ledger::ReceivableInfosPage(
+    rai::Transaction& transaction, const rai::Account& account,
+    rai::ReceivableInfosType type, size_t count,
+    rai::ReceivableInfosCursor& cursor,
+    std::vector<rai::ReceivableInfoEntry>& page)
+{
+    rai::Iterator i = ReceivableInfoLowerBound(transaction, account);
+    rai::Iterator n = ReceivableInfoUpperBound(transaction, account);
+    return ReceivableInfosPage_(transaction, i, n, type, count, cursor, page);
+}
+
 bool rai::Ledger::ReceivableInfoDel(rai::Transaction& transaction,
                                     const rai::Account& destination,
                                     const rai::BlockHash& hash)
@@ -1250,9 +1461,17 @@ bool rai::Ledger::ReceivableInfoDel(rai::Transaction& transaction,
         rai::Write(stream, destination.bytes);
         rai::Write(stream, hash.bytes);
     }
+    rai::ReceivableInfo info;
+    bool error = ReceivableInfoGet(transaction, destination, hash, info);
+    IF_ERROR_RETURN(error, error);
+
     rai::MdbVal key(bytes_key.size(), bytes_key.data());
-    return store_.Del(transaction.mdb_transaction_, store_.receivables_, key,
-                      nullptr);
+    error = store_.Del(transaction.mdb_transaction_, store_.receivables_, key,
+                       nullptr);
+    IF_ERROR_RETURN(error, error);
+
+    return SummaryUpdate_(transaction, store_.receivable_summaries_,
+                          destination, false, info.amount_);
 }
 
 bool rai::Ledger::ReceivableInfoCount(rai::Transaction& transaction,
@@ -1304,6 +1523,14 @@ rai::Iterator rai::Ledger::ReceivableInfoUpperBound(
     return rai::Iterator(std::move(store_it));
 }
 
+bool rai::Ledger::ReceivableSummaryGet(rai::Transaction& transaction,
+                                       const rai::Account& account,
+                                       rai::AmountSummary& summary) const
+{
+    return SummaryGet_(transaction, store_.receivable_summaries_, account,
+                       summary);
+}
+
 bool rai::Ledger::RewardableInfoPut(rai::Transaction& transaction,
                                     const rai::Account& representative,
                                     const rai::BlockHash& hash,
@@ -1326,13 +1553,24 @@ bool rai::Ledger::RewardableInfoPut(rai::Transaction& transaction,
         info.Serialize(stream);
     }
 
+    rai::RewardableInfo previous;
+    bool exists =
+        !RewardableInfoGet(transaction, representative, hash, previous);
+
     rai::MdbVal key(bytes_key.size(), bytes_key.data());
     rai::MdbVal value(bytes_value.size(), bytes_value.data());
     bool error = store_.Put(transaction.mdb_transaction_, store_.rewardables_,
                             key, value);
     IF_ERROR_RETURN(error, error);
 
-    return false;
+    if (exists)
+    {
+        error = SummaryUpdate_(transaction, store_.rewardable_summaries_,
+                               representative, false, previous.amount_);
+        IF_ERROR_RETURN(error, error);
+    }
+    return SummaryUpdate_(transaction, store_.rewardable_summaries_,
+                          representative, true, info.amount_);
 }
 
 bool rai::Ledger::RewardableInfoGet(rai::Transaction& transaction,
@@ -1402,9 +1640,17 @@ bool rai::Ledger::RewardableInfoDel(rai::Transaction& transaction,
         rai::Write(stream, representative.bytes);
         rai::Write(stream, hash.bytes);
     }
+    rai::RewardableInfo info;
+    bool error = RewardableInfoGet(transaction, representative, hash, info);
+    IF_ERROR_RETURN(error, error);
+
     rai::MdbVal key(bytes_key.size(), bytes_key.data());
-    return store_.Del(transaction.mdb_transaction_, store_.rewardables_, key,
-                      nullptr);
+    error = store_.Del(transaction.mdb_transaction_, store_.rewardables_, key,
+                       nullptr);
+    IF_ERROR_RETURN(error, error);
+
+    return SummaryUpdate_(transaction, store_.rewardable_summaries_,
+                          representative, false, info.amount_);
 }
 
 
@@ -1440,6 +1686,14 @@ rai::Iterator rai::Ledger::RewardableInfoUpperBound(
     return rai::Iterator(std::move(store_it));
 }
 
+bool rai::Ledger::RewardableSummaryGet(rai::Transaction& transaction,
+                                       const rai::Account& account,
+                                       rai::AmountSummary& summary) const
+{
+    return SummaryGet_(transaction, store_.rewardable_summaries_, account,
+                       summary);
+}
+
 bool rai::Ledger::RollbackBlockPut(rai::Transaction& transaction,
                                    const rai::BlockHash& hash,
                                    const rai::Block& block)
@@ -1484,6 +1738,19 @@ bool rai::Ledger::RollbackBlockGet(rai::Transaction& transaction,
     return false;
 }
 
+bool rai::Ledger::RollbackBlockDel(rai::Transaction& transaction,
+                                   const rai::BlockHash& hash)
+{
+    if (!transaction.write_)
+    {
+        return true;
+    }
+
+    rai::MdbVal key(hash);
+    return store_.Del(transaction.mdb_transaction_, store_.rollbacks_, key,
+                      nullptr);
+}
+
 void rai::Ledger::RepWeightAdd(rai::Transaction& transaction,
                                const rai::Account& representative,
                                const rai::Amount& weight)
@@ -1503,29 +1770,27 @@ void rai::Ledger::RepWeightSub(rai::Transaction& transaction,
 bool rai::Ledger::RepWeightGet(const rai::Account& representative,
                                rai::Amount& weight) const
 {
-    std::lock_guard<std::mutex> lock(rep_weights_mutex_);
-    auto it = rep_weights_.find(representative);
-    if (it == rep_weights_.end())
-    {
-        return true;
-    }
-    weight = it->second;
-    return false;
+    return RepWeightsSnapshot()->Get(representative, weight);
 }
 
 void rai::Ledger::RepWeightTotalGet(rai::Amount& total) const
 {
-    std::lock_guard<std::mutex> lock(rep_weights_mutex_);
-    total = total_rep_weight_;
+    total = RepWeightsSnapshot()->total_;
+}
+
+std::shared_ptr<const rai::RepWeightsSnapshot> rai::Ledger::RepWeightsSnapshot()
+    const
+{
+    return std::atomic_load(&rep_weights_snapshot_);
 }
 
 void rai::Ledger::RepWeightsGet(
     rai::Amount& total,
     std::unordered_map<rai::Account, rai::Amount>& weights) const
 {
-    std::lock_guard<std::mutex> lock(rep_weights_mutex_);
-    total = total_rep_weight_;
-    weights = rep_weights_;
+    auto snapshot = RepWeightsSnapshot();
+    total = snapshot->total_;
+    weights = snapshot->weights_;
 }
 
 bool rai::Ledger::SourcePut(rai::Transaction& transaction,
@@ -1968,105 +2233,305 @@ bool rai::Ledger::VersionGet(rai::Transaction& transaction,
     return false;
 }
 
-void rai::Ledger::UpdateRichList(const rai::Block& block)
+bool rai::Ledger::CallbackNext(rai::Transaction& transaction,
+                               uint64_t& sequence) const
 {
-    if (!enable_rich_list_ || block.Type() != rai::BlockType::TX_BLOCK)
+    uint64_t acked = 0;
+    bool error = CallbackAckedGet(transaction, acked);
+    if (error)
     {
-        return;
+        acked = 0;
     }
+    sequence = acked + 1;
 
-    std::lock_guard<std::mutex> lock(rich_list_mutex_);
-    UpdateRichList_(block.Account(), block.Balance());
-}
-
-std::vector<rai::RichListEntry> rai::Ledger::GetRichList(uint64_t max)
-{
-    size_t size = max;
-    std::vector<rai::RichListEntry> result;
-    std::lock_guard<std::mutex> lock(rich_list_mutex_);
+    MDB_cursor* cursor = nullptr;
+    auto ret =
+        mdb_cursor_open(transaction.mdb_transaction_, store_.callbacks_, &cursor);
+    IF_ERROR_RETURN(ret != MDB_SUCCESS, true);
 
-    if (rich_list_.size() < size)
+    rai::MdbVal key;
+    rai::MdbVal value;
+    ret = mdb_cursor_get(cursor, key, value, MDB_LAST);
+    mdb_cursor_close(cursor);
+    if (ret == MDB_NOTFOUND)
     {
-        size = rich_list_.size();
+        return false;
     }
-    result.reserve(size);
+    IF_ERROR_RETURN(ret != MDB_SUCCESS, true);
 
-    size_t count = 0;
-    for (auto i = rich_list_.begin(), n = rich_list_.end(); i != n; ++i)
+    uint64_t last = 0;
+    rai::BufferStream stream(key.Data(), key.Size());
+    error = rai::Read(stream, last);
+    IF_ERROR_RETURN(error, error);
+    if (last >= sequence)
     {
-        if (count >= max)
-        {
-            break;
-        }
-
-        result.push_back(*i);
-        ++count;
+        sequence = last + 1;
     }
 
-    return result;
+    return false;
 }
 
-void rai::Ledger::UpdateDelegatorList(const rai::Block& block)
+bool rai::Ledger::CallbackPut(rai::Transaction& transaction, uint64_t sequence,
+                              const std::string& notify)
 {
-    if (!enable_delegator_list_ || !block.HasRepresentative())
+    if (!transaction.write_)
     {
-        return;
+        return true;
     }
 
-    std::lock_guard<std::mutex> lock(delegator_list_mutex_);
-    UpdateDelegatorList_(block.Account(), block.Representative(),
-                         block.Balance(), block.Type());
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, sequence);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+    rai::MdbVal value(notify.size(), const_cast<char*>(notify.data()));
+    bool error = store_.Append(transaction.mdb_transaction_, store_.callbacks_,
+                               key, value);
+    IF_ERROR_RETURN(error, error);
+
+    return false;
 }
 
-std::vector<rai::DelegatorListEntry> rai::Ledger::GetDelegatorList(
-    const rai::Account& rep, uint64_t max)
+bool rai::Ledger::CallbackGet(
+    rai::Transaction& transaction, uint64_t sequence, size_t count,
+    std::vector<std::pair<uint64_t, std::string>>& notifies) const
 {
-    std::multimap<rai::Amount, rai::DelegatorListEntry,
-                  std::greater<rai::Amount>>
-        delegators;
-    std::vector<rai::DelegatorListEntry> result;
-    std::lock_guard<std::mutex> lock(delegator_list_mutex_);
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, sequence);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
 
-    auto i = delegator_list_.get<1>().lower_bound(rep);
-    auto n = delegator_list_.get<1>().upper_bound(rep);
-    for (; i != n; ++i)
+    rai::StoreIterator i(transaction.mdb_transaction_, store_.callbacks_, key);
+    rai::StoreIterator n(nullptr);
+    for (; i != n && notifies.size() < count; ++i)
     {
-        delegators.insert(std::make_pair(i->weight_, *i));
-        if (delegators.size() > max)
-        {
-            delegators.erase(std::prev(delegators.end()));
-        }
+        uint64_t sequence_l = 0;
+        rai::BufferStream stream(i->first.Data(), i->first.Size());
+        bool error = rai::Read(stream, sequence_l);
+        IF_ERROR_RETURN(error, error);
+        notifies.emplace_back(
+            sequence_l,
+            std::string(reinterpret_cast<const char*>(i->second.Data()),
+                        i->second.Size()));
     }
 
-    result.reserve(delegators.size());
+    return false;
+}
 
-    for (const auto& i : delegators)
+bool rai::Ledger::CallbackFirst(rai::Transaction& transaction,
+                                uint64_t& sequence) const
+{
+    rai::StoreIterator i(transaction.mdb_transaction_, store_.callbacks_);
+    rai::StoreIterator n(nullptr);
+    if (i == n)
     {
-        result.push_back(i.second);
+        return true;
     }
-    return result;
+
+    rai::BufferStream stream(i->first.Data(), i->first.Size());
+    return rai::Read(stream, sequence);
 }
 
-rai::ErrorCode rai::Ledger::UpgradeWallet(rai::Transaction& transaction)
+bool rai::Ledger::CallbackPrune(rai::Transaction& transaction, uint64_t below,
+                                size_t max, size_t& pruned)
 {
-    uint32_t version = 0;
-    bool error = VersionGet(transaction, version);
-    if (error)
+    if (!transaction.write_)
     {
-        version = 1;
+        return true;
     }
 
-    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
-    switch (version)
+    std::vector<uint64_t> sequences;
     {
-        case 1:
+        rai::StoreIterator i(transaction.mdb_transaction_, store_.callbacks_);
+        rai::StoreIterator n(nullptr);
+        for (; i != n && sequences.size() < max; ++i)
         {
-            error_code = UpgradeWalletV1V2(transaction);
-            IF_NOT_SUCCESS_RETURN(error_code);
+            uint64_t sequence = 0;
+            rai::BufferStream stream(i->first.Data(), i->first.Size());
+            bool error = rai::Read(stream, sequence);
+            IF_ERROR_RETURN(error, error);
+            if (sequence >= below)
+            {
+                break;
+            }
+            sequences.push_back(sequence);
         }
-        case 2:
+    }
+
+    for (auto sequence : sequences)
+    {
+        std::vector<uint8_t> bytes_key;
         {
-            break;
+            rai::VectorStream stream(bytes_key);
+            rai::Write(stream, sequence);
+        }
+        rai::MdbVal key(bytes_key.size(), bytes_key.data());
+        bool error = store_.Del(transaction.mdb_transaction_,
+                                store_.callbacks_, key, nullptr);
+        IF_ERROR_RETURN(error, error);
+        ++pruned;
+    }
+
+    return false;
+}
+
+bool rai::Ledger::CallbackAckedPut(rai::Transaction& transaction,
+                                   uint64_t sequence)
+{
+    if (!transaction.write_)
+    {
+        return true;
+    }
+
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::CALLBACK_ACKED);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+
+    std::vector<uint8_t> bytes_value;
+    {
+        rai::VectorStream stream(bytes_value);
+        rai::Write(stream, sequence);
+    }
+    rai::MdbVal value(bytes_value.size(), bytes_value.data());
+    bool error =
+        store_.Put(transaction.mdb_transaction_, store_.meta_, key, value);
+    IF_ERROR_RETURN(error, error);
+
+    return false;
+}
+
+bool rai::Ledger::CallbackAckedGet(rai::Transaction& transaction,
+                                   uint64_t& sequence) const
+{
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::CALLBACK_ACKED);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+
+    rai::MdbVal value;
+    bool error =
+        store_.Get(transaction.mdb_transaction_, store_.meta_, key, value);
+    IF_ERROR_RETURN(error, error);
+
+    rai::BufferStream stream(value.Data(), value.Size());
+    error = rai::Read(stream, sequence);
+    IF_ERROR_RETURN(error, error);
+
+    return false;
+}
+
+void rai::Ledger::UpdateRichList(const rai::Block& block)
+{
+    if (!enable_rich_list_ || block.Type() != rai::BlockType::TX_BLOCK)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(rich_list_mutex_);
+    UpdateRichList_(block.Account(), block.Balance());
+}
+
+std::vector<rai::RichListEntry> rai::Ledger::GetRichList(uint64_t max)
+{
+    size_t size = max;
+    std::vector<rai::RichListEntry> result;
+    std::lock_guard<std::mutex> lock(rich_list_mutex_);
+
+    if (rich_list_.size() < size)
+    {
+        size = rich_list_.size();
+    }
+    result.reserve(size);
+
+    size_t count = 0;
+    for (auto i = rich_list_.begin(), n = rich_list_.end(); i != n; ++i)
+    {
+        if (count >= max)
+        {
+            break;
+        }
+
+        result.push_back(*i);
+        ++count;
+    }
+
+    return result;
+}
+
+void rai::Ledger::UpdateDelegatorList(const rai::Block& block)
+{
+    if (!enable_delegator_list_ || !block.HasRepresentative())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(delegator_list_mutex_);
+    UpdateDelegatorList_(block.Account(), block.Representative(),
+                         block.Balance(), block.Type());
+}
+
+std::vector<rai::DelegatorListEntry> rai::Ledger::GetDelegatorList(
+    const rai::Account& rep, uint64_t max)
+{
+    std::multimap<rai::Amount, rai::DelegatorListEntry,
+                  std::greater<rai::Amount>>
+        delegators;
+    std::vector<rai::DelegatorListEntry> result;
+    std::lock_guard<std::mutex> lock(delegator_list_mutex_);
+
+    auto i = delegator_list_.get<1>().lower_bound(rep);
+    auto n = delegator_list_.get<1>().upper_bound(rep);
+    for (; i != n; ++i)
+    {
+        delegators.insert(std::make_pair(i->weight_, *i));
+        if (delegators.size() > max)
+        {
+            delegators.erase(std::prev(delegators.end()));
+        }
+    }
+
+    result.reserve(delegators.size());
+
+    for (const auto& i : delegators)
+    {
+        result.push_back(i.second);
+    }
+    return result;
+}
+
+uint64_t rai::Ledger::Version() const
+{
+    return version_;
+}
+
+rai::ErrorCode rai::Ledger::UpgradeWallet(rai::Transaction& transaction)
+{
+    uint32_t version = 0;
+    bool error = VersionGet(transaction, version);
+    if (error)
+    {
+        version = 1;
+    }
+
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    switch (version)
+    {
+        case 1:
+        {
+            error_code = UpgradeWalletV1V2(transaction);
+            IF_NOT_SUCCESS_RETURN(error_code);
+        }
+        case 2:
+        {
+            break;
         }
         default:
         {
@@ -2132,6 +2597,441 @@ rai::ErrorCode rai::Ledger::UpgradeWalletV1V2(rai::Transaction& transaction)
     return rai::ErrorCode::SUCCESS;
 }
 
+rai::ErrorCode rai::Ledger::SnapshotExport(rai::Transaction& transaction,
+                                           const boost::filesystem::path& path)
+{
+    std::ofstream file(path.string(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return rai::ErrorCode::OPEN_OR_CREATE_FILE;
+    }
+
+    boost::iostreams::filtering_ostream out;
+    out.push(
+        boost::iostreams::zlib_compressor(boost::iostreams::zlib::best_speed));
+    out.push(file);
+
+    blake2b_state state;
+    int ret = blake2b_init(&state, sizeof(rai::uint256_union));
+    assert(0 == ret);
+
+    rai::Genesis genesis;
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        rai::Write(stream, rai::Ledger::SNAPSHOT_MAGIC);
+        rai::Write(stream, rai::Ledger::SNAPSHOT_VERSION);
+        rai::Write(stream, static_cast<uint8_t>(rai::RAI_NETWORK));
+        rai::Write(stream, genesis.block_->Hash().bytes);
+    }
+    SnapshotWrite(out, state, bytes);
+
+    for (const auto& table : SnapshotTables_())
+    {
+        rai::StoreIterator i(transaction.mdb_transaction_, table.second);
+        rai::StoreIterator n(nullptr);
+        for (; i != n; ++i)
+        {
+            if (table.first == rai::SnapshotTable::META
+                && !SnapshotMetaKey(
+                    reinterpret_cast<const uint8_t*>(i->first.Data()),
+                    i->first.Size()))
+            {
+                continue;
+            }
+
+            bytes.clear();
+            {
+                rai::VectorStream stream(bytes);
+                rai::Write(stream, table.first);
+                rai::Write(stream, static_cast<uint32_t>(i->first.Size()));
+                stream.sputn(i->first.Data(), i->first.Size());
+                rai::Write(stream, static_cast<uint32_t>(i->second.Size()));
+                stream.sputn(i->second.Data(), i->second.Size());
+            }
+            SnapshotWrite(out, state, bytes);
+        }
+    }
+
+    bytes.clear();
+    {
+        rai::VectorStream stream(bytes);
+        rai::Write(stream, rai::SnapshotTable::END);
+    }
+    SnapshotWrite(out, state, bytes);
+
+    rai::uint256_union checksum;
+    ret = blake2b_final(&state, checksum.bytes.data(), checksum.bytes.size());
+    assert(0 == ret);
+    out.write(reinterpret_cast<const char*>(checksum.bytes.data()),
+              checksum.bytes.size());
+    out.reset();
+
+    if (!file.good())
+    {
+        return rai::ErrorCode::WRITE_FILE;
+    }
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::Ledger::SnapshotImport(rai::Transaction& transaction,
+                                           const boost::filesystem::path& path)
+{
+    if (!transaction.write_)
+    {
+        return rai::ErrorCode::LEDGER_PUT;
+    }
+
+    if (!Empty(transaction))
+    {
+        return rai::ErrorCode::SNAPSHOT_LEDGER_NOT_EMPTY;
+    }
+
+    std::ifstream file(path.string(), std::ios::in | std::ios::binary);
+    if (!file)
+    {
+        return rai::ErrorCode::OPEN_OR_CREATE_FILE;
+    }
+
+    boost::iostreams::filtering_istream in;
+    in.push(boost::iostreams::zlib_decompressor());
+    in.push(file);
+
+    blake2b_state state;
+    int ret = blake2b_init(&state, sizeof(rai::uint256_union));
+    assert(0 == ret);
+
+    try
+    {
+        uint32_t magic = 0;
+        bool error = SnapshotRead(in, state, magic);
+        if (error || magic != rai::Ledger::SNAPSHOT_MAGIC)
+        {
+            return rai::ErrorCode::SNAPSHOT_FORMAT;
+        }
+
+        uint32_t version = 0;
+        error = SnapshotRead(in, state, version);
+        IF_ERROR_RETURN(error, rai::ErrorCode::SNAPSHOT_FORMAT);
+        if (version != rai::Ledger::SNAPSHOT_VERSION)
+        {
+            return rai::ErrorCode::SNAPSHOT_VERSION;
+        }
+
+        uint8_t network = 0;
+        error = SnapshotRead(in, state, network);
+        IF_ERROR_RETURN(error, rai::ErrorCode::SNAPSHOT_FORMAT);
+        if (network != static_cast<uint8_t>(rai::RAI_NETWORK))
+        {
+            return rai::ErrorCode::SNAPSHOT_NETWORK;
+        }
+
+        rai::BlockHash genesis_hash;
+        error = SnapshotRead(in, state, genesis_hash.bytes.data(),
+                             genesis_hash.bytes.size());
+        IF_ERROR_RETURN(error, rai::ErrorCode::SNAPSHOT_FORMAT);
+        rai::Genesis genesis;
+        if (genesis_hash != genesis.block_->Hash())
+        {
+            return rai::ErrorCode::SNAPSHOT_GENESIS;
+        }
+
+        auto tables = SnapshotTables_();
+        std::vector<uint8_t> key;
+        std::vector<uint8_t> value;
+        while (true)
+        {
+            rai::SnapshotTable table;
+            error = SnapshotRead(in, state, table);
+            IF_ERROR_RETURN(error, rai::ErrorCode::SNAPSHOT_FORMAT);
+            if (table == rai::SnapshotTable::END)
+            {
+                break;
+            }
+
+            auto it = std::find_if(
+                tables.begin(), tables.end(),
+                [table](const std::pair<rai::SnapshotTable, MDB_dbi>& i) {
+                    return i.first == table;
+                });
+            if (it == tables.end())
+            {
+                return rai::ErrorCode::SNAPSHOT_FORMAT;
+            }
+
+            uint32_t size = 0;
+            error = SnapshotRead(in, state, size);
+            if (error || size == 0 || size > SNAPSHOT_MAX_KEY_SIZE)
+            {
+                return rai::ErrorCode::SNAPSHOT_FORMAT;
+            }
+            key.resize(size);
+            error = SnapshotRead(in, state, key.data(), key.size());
+            IF_ERROR_RETURN(error, rai::ErrorCode::SNAPSHOT_FORMAT);
+
+            error = SnapshotRead(in, state, size);
+            if (error || size > SNAPSHOT_MAX_VALUE_SIZE)
+            {
+                return rai::ErrorCode::SNAPSHOT_FORMAT;
+            }
+            value.resize(size);
+            error = SnapshotRead(in, state, value.data(), value.size());
+            IF_ERROR_RETURN(error, rai::ErrorCode::SNAPSHOT_FORMAT);
+
+            // Records are exported in key order, so they can be appended,
+            // except meta which the store already holds records of
+            rai::MdbVal key_l(key.size(), key.data());
+            rai::MdbVal value_l(value.size(), value.data());
+            if (table == rai::SnapshotTable::META)
+            {
+                if (!SnapshotMetaKey(key.data(), key.size()))
+                {
+                    return rai::ErrorCode::SNAPSHOT_FORMAT;
+                }
+                error = store_.Put(transaction.mdb_transaction_, it->second,
+                                   key_l, value_l);
+            }
+            else
+            {
+                error = store_.Append(transaction.mdb_transaction_,
+                                      it->second, key_l, value_l);
+            }
+            IF_ERROR_RETURN(error, rai::ErrorCode::SNAPSHOT_FORMAT);
+        }
+
+        rai::uint256_union expected;
+        ret = blake2b_final(&state, expected.bytes.data(),
+                            expected.bytes.size());
+        assert(0 == ret);
+        rai::uint256_union checksum;
+        in.read(reinterpret_cast<char*>(checksum.bytes.data()),
+                checksum.bytes.size());
+        if (static_cast<size_t>(in.gcount()) != checksum.bytes.size()
+            || checksum != expected)
+        {
+            return rai::ErrorCode::SNAPSHOT_CHECKSUM;
+        }
+    }
+    catch (const boost::iostreams::zlib_error&)
+    {
+        return rai::ErrorCode::SNAPSHOT_FORMAT;
+    }
+
+    rai::ErrorCode error_code = SnapshotVerify_(transaction);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    // The summaries aren't exported, rebuild them from the imported tables
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::SUMMARIES_VERSION);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+    bool error =
+        store_.Del(transaction.mdb_transaction_, store_.meta_, key, nullptr);
+    IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PUT);
+    error_code = InitSummaries_(transaction);
+    IF_NOT_SUCCESS_RETURN(error_code);
+
+    ClearMemoryTables_();
+    return InitMemoryTables_(transaction);
+}
+
+rai::ErrorCode rai::Ledger::Prune(rai::Transaction& transaction,
+                                  rai::Account& next, uint64_t depth,
+                                  size_t max_blocks, size_t& pruned)
+{
+    if (!transaction.write_)
+    {
+        return rai::ErrorCode::LEDGER_PRUNE;
+    }
+
+    while (pruned < max_blocks)
+    {
+        // Collect a batch first, account infos are rewritten while pruning
+        std::vector<rai::Account> accounts;
+        {
+            rai::MdbVal key(next);
+            rai::StoreIterator i(transaction.mdb_transaction_,
+                                store_.accounts_, key);
+            rai::StoreIterator n(nullptr);
+            for (; i != n && accounts.size() < PRUNE_ACCOUNTS_PER_BATCH; ++i)
+            {
+                accounts.push_back(i->first.uint256_union());
+            }
+        }
+        if (accounts.empty())
+        {
+            next.Clear();
+            return rai::ErrorCode::SUCCESS;
+        }
+
+        for (const auto& account : accounts)
+        {
+            rai::ErrorCode error_code =
+                PruneAccount(transaction, account, depth, max_blocks, pruned);
+            IF_NOT_SUCCESS_RETURN(error_code);
+            if (pruned >= max_blocks)
+            {
+                // The account may still have blocks to prune, resume from it
+                next = account;
+                return rai::ErrorCode::SUCCESS;
+            }
+        }
+
+        next = accounts.back() + 1;
+        if (next.IsZero())
+        {
+            return rai::ErrorCode::SUCCESS;
+        }
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+rai::ErrorCode rai::Ledger::PruneAccount(rai::Transaction& transaction,
+                                         const rai::Account& account,
+                                         uint64_t depth, size_t max_blocks,
+                                         size_t& pruned)
+{
+    if (!transaction.write_)
+    {
+        return rai::ErrorCode::LEDGER_PRUNE;
+    }
+
+    rai::AccountInfo info;
+    bool error = AccountInfoGet(transaction, account, info);
+    if (error || !info.Valid())
+    {
+        return rai::ErrorCode::LEDGER_PRUNE;
+    }
+
+    // Only confirmed blocks deeper than <depth> below the confirmed height
+    // are dropped, the new tail is never above the head
+    if (info.confirmed_height_ == rai::Block::INVALID_HEIGHT
+        || info.confirmed_height_ < depth)
+    {
+        return rai::ErrorCode::SUCCESS;
+    }
+    uint64_t target = std::min(info.confirmed_height_ - depth,
+                               info.head_height_);
+    if (target <= info.tail_height_)
+    {
+        return rai::ErrorCode::SUCCESS;
+    }
+
+    rai::BlockHash hash(info.tail_);
+    uint64_t height = info.tail_height_;
+    while (height < target && pruned < max_blocks)
+    {
+        std::shared_ptr<rai::Block> block(nullptr);
+        rai::BlockHash successor;
+        error = BlockGet(transaction, hash, block, successor);
+        if (error || successor.IsZero() || block->Height() != height)
+        {
+            rai::Stats::AddDetail(rai::ErrorCode::LEDGER_PRUNE,
+                                  "Ledger::PruneAccount: account=",
+                                  account.StringAccount(), ", height=",
+                                  height);
+            return rai::ErrorCode::LEDGER_PRUNE;
+        }
+
+        // The tail stops at a block still needed to receive or reward it
+        if (PruneReferenced_(transaction, hash, *block))
+        {
+            break;
+        }
+
+        error = BlockDel(transaction, hash);
+        IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PRUNE);
+
+        hash = successor;
+        ++height;
+        ++pruned;
+    }
+
+    if (height == info.tail_height_)
+    {
+        return rai::ErrorCode::SUCCESS;
+    }
+
+    info.tail_ = hash;
+    info.tail_height_ = height;
+    error = AccountInfoPut(transaction, account, info);
+    IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PRUNE);
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+bool rai::Ledger::PruneReferenced_(rai::Transaction& transaction,
+                                   const rai::BlockHash& hash,
+                                   const rai::Block& block) const
+{
+    if (block.Opcode() == rai::BlockOpcode::SEND
+        && ReceivableInfoExists(transaction, block.Link(), hash))
+    {
+        return true;
+    }
+
+    if (block.HasRepresentative())
+    {
+        rai::RewardableInfo info;
+        bool error = RewardableInfoGet(transaction, block.Representative(),
+                                       hash, info);
+        if (!error)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+rai::ErrorCode rai::Ledger::PruneRollbacks(rai::Transaction& transaction,
+                                           size_t& pruned)
+{
+    if (!transaction.write_)
+    {
+        return rai::ErrorCode::LEDGER_PRUNE;
+    }
+
+    std::vector<rai::BlockHash> hashs;
+    {
+        rai::StoreIterator i(transaction.mdb_transaction_, store_.rollbacks_);
+        rai::StoreIterator n(nullptr);
+        for (; i != n; ++i)
+        {
+            rai::BlockHash hash = i->first.uint256_union();
+            rai::BufferStream stream(i->second.Data(), i->second.Size());
+            rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+            std::shared_ptr<rai::Block> block =
+                rai::DeserializeBlockUnverify(error_code, stream);
+            if (error_code != rai::ErrorCode::SUCCESS || block == nullptr)
+            {
+                hashs.push_back(hash);
+                continue;
+            }
+
+            rai::AccountInfo info;
+            bool error = AccountInfoGet(transaction, block->Account(), info);
+            if (!error && info.Valid() && block->Height() < info.tail_height_)
+            {
+                hashs.push_back(hash);
+            }
+        }
+    }
+
+    for (const auto& hash : hashs)
+    {
+        bool error = RollbackBlockDel(transaction, hash);
+        IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PRUNE);
+        ++pruned;
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
 bool rai::Ledger::BlockIndexPut_(rai::Transaction& transaction,
                                  const rai::Account& account, uint64_t height,
                                  const rai::BlockHash& hash)
@@ -2235,6 +3135,23 @@ void rai::Ledger::RepWeightsCommit_(
             }
         }
     }
+
+    if (!ops.empty())
+    {
+        RepWeightsPublish_();
+    }
+}
+
+// rep_weights_mutex_ must be held by the caller
+void rai::Ledger::RepWeightsPublish_()
+{
+    auto snapshot = std::make_shared<rai::RepWeightsSnapshot>();
+    snapshot->version_ = ++rep_weights_version_;
+    snapshot->total_ = total_rep_weight_;
+    snapshot->weights_ = rep_weights_;
+    std::atomic_store(
+        &rep_weights_snapshot_,
+        std::shared_ptr<const rai::RepWeightsSnapshot>(std::move(snapshot)));
 }
 
 rai::ErrorCode rai::Ledger::InitMemoryTables_(rai::Transaction& transaction)
@@ -2278,6 +3195,325 @@ rai::ErrorCode rai::Ledger::InitMemoryTables_(rai::Transaction& transaction)
             UpdateRichList_(block->Account(), block->Balance());
         }
     }
+    RepWeightsPublish_();
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+bool rai::Ledger::ReceivableInfosPage_(
+    rai::Transaction& transaction, rai::Iterator& i, rai::Iterator& n,
+    rai::ReceivableInfosType type, size_t count,
+    rai::ReceivableInfosCursor& cursor,
+    std::vector<rai::ReceivableInfoEntry>& page)
+{
+    page.clear();
+    if (count == 0)
+    {
+        cursor.more_ = false;
+        return false;
+    }
+
+    // Max-heap on the page order: the top is the worst entry kept so far,
+    // one extra entry is kept to know whether another page follows
+    std::vector<rai::ReceivableInfoEntry> heap;
+    heap.reserve(count + 1);
+    for (; i != n; ++i)
+    {
+        rai::ReceivableInfoEntry entry;
+        bool error = ReceivableInfoGet(i, entry.destination_, entry.hash_,
+                                       entry.info_);
+        IF_ERROR_RETURN(error, true);
+
+        if (!cursor.After(entry))
+        {
+            continue;
+        }
+        if (heap.size() > count && !(entry < heap.front()))
+        {
+            continue;
+        }
+
+        if (type != rai::ReceivableInfosType::ALL)
+        {
+            bool match = false;
+            error = ReceivableInfoMatch_(transaction, entry.hash_, type, match);
+            IF_ERROR_RETURN(error, true);
+            if (!match)
+            {
+                continue;
+            }
+        }
+
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end());
+        if (heap.size() > count + 1)
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.pop_back();
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    cursor.more_ = heap.size() > count;
+    if (cursor.more_)
+    {
+        heap.pop_back();
+    }
+    if (!heap.empty())
+    {
+        cursor.Set(heap.back());
+    }
+    page = std::move(heap);
+
+    return false;
+}
+
+bool rai::Ledger::ReceivableInfoMatch_(rai::Transaction& transaction,
+                                       const rai::BlockHash& hash,
+                                       rai::ReceivableInfosType type,
+                                       bool& match) const
+{
+    std::shared_ptr<rai::Block> block;
+    bool error = BlockGet(transaction, hash, block);
+    if (error || block == nullptr)
+    {
+        return true;
+    }
+
+    rai::AccountInfo account_info;
+    error = AccountInfoGet(transaction, block->Account(), account_info);
+    if (error || !account_info.Valid())
+    {
+        return true;
+    }
+
+    bool confirmed = account_info.Confirmed(block->Height());
+    match = (type == rai::ReceivableInfosType::CONFIRMED) == confirmed;
+    return false;
+}
+
+rai::ErrorCode rai::Ledger::InitSummaries_(rai::Transaction& transaction)
+{
+    std::vector<uint8_t> bytes_key;
+    {
+        rai::VectorStream stream(bytes_key);
+        rai::Write(stream, rai::MetaKey::SUMMARIES_VERSION);
+    }
+    rai::MdbVal key(bytes_key.size(), bytes_key.data());
+    rai::MdbVal value;
+    bool error =
+        store_.Get(transaction.mdb_transaction_, store_.meta_, key, value);
+    if (!error)
+    {
+        return rai::ErrorCode::SUCCESS;
+    }
+
+    // One-time build of the summary tables for existing ledgers
+    std::vector<std::pair<MDB_dbi, MDB_dbi>> tables{
+        {store_.receivables_, store_.receivable_summaries_},
+        {store_.rewardables_, store_.rewardable_summaries_}};
+    for (const auto& table : tables)
+    {
+        auto ret = mdb_drop(transaction.mdb_transaction_, table.second, 0);
+        IF_ERROR_RETURN(ret != MDB_SUCCESS, rai::ErrorCode::LEDGER_PUT);
+
+        rai::Account current;
+        rai::AmountSummary summary;
+        rai::StoreIterator i(transaction.mdb_transaction_, table.first);
+        rai::StoreIterator n(nullptr);
+        for (; i != n; ++i)
+        {
+            // Both tables are keyed by account and hash, with the amount
+            // following the source account in the value
+            rai::BufferStream stream_key(i->first.Data(), i->first.Size());
+            rai::Account account;
+            error = rai::Read(stream_key, account.bytes);
+            IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PUT);
+            rai::BufferStream stream_value(i->second.Data(), i->second.Size());
+            rai::Account source;
+            rai::Amount amount;
+            error = rai::Read(stream_value, source.bytes);
+            IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PUT);
+            error = rai::Read(stream_value, amount.bytes);
+            IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PUT);
+
+            if (summary.count_ > 0 && account != current)
+            {
+                error = SummaryPut_(transaction, table.second, current,
+                                    summary);
+                IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PUT);
+                summary = rai::AmountSummary();
+            }
+            current = account;
+            ++summary.count_;
+            summary.amount_ += amount;
+        }
+
+        if (summary.count_ > 0)
+        {
+            error = SummaryPut_(transaction, table.second, current, summary);
+            IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PUT);
+        }
+    }
+
+    std::vector<uint8_t> bytes_value;
+    {
+        rai::VectorStream stream(bytes_value);
+        rai::Write(stream, rai::Ledger::SUMMARIES_VERSION);
+    }
+    rai::MdbVal value_l(bytes_value.size(), bytes_value.data());
+    error = store_.Put(transaction.mdb_transaction_, store_.meta_, key,
+                       value_l);
+    IF_ERROR_RETURN(error, rai::ErrorCode::LEDGER_PUT);
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+bool rai::Ledger::SummaryGet_(rai::Transaction& transaction, MDB_dbi dbi,
+                              const rai::Account& account,
+                              rai::AmountSummary& summary) const
+{
+    rai::MdbVal key(account);
+    rai::MdbVal value;
+    bool error = store_.Get(transaction.mdb_transaction_, dbi, key, value);
+    if (error)
+    {
+        // No entries for the account
+        summary = rai::AmountSummary();
+        return false;
+    }
+
+    rai::BufferStream stream(value.Data(), value.Size());
+    return summary.Deserialize(stream);
+}
+
+bool rai::Ledger::SummaryUpdate_(rai::Transaction& transaction, MDB_dbi dbi,
+                                 const rai::Account& account, bool add,
+                                 const rai::Amount& amount)
+{
+    rai::AmountSummary summary;
+    bool error = SummaryGet_(transaction, dbi, account, summary);
+    IF_ERROR_RETURN(error, error);
+
+    if (add)
+    {
+        ++summary.count_;
+        summary.amount_ += amount;
+    }
+    else
+    {
+        if (summary.count_ == 0 || summary.amount_ < amount)
+        {
+            assert(0);
+            return true;
+        }
+        --summary.count_;
+        summary.amount_ -= amount;
+    }
+
+    if (summary.count_ == 0)
+    {
+        rai::MdbVal key(account);
+        return store_.Del(transaction.mdb_transaction_, dbi, key, nullptr);
+    }
+    return SummaryPut_(transaction, dbi, account, summary);
+}
+
+bool rai::Ledger::SummaryPut_(rai::Transaction& transaction, MDB_dbi dbi,
+                              const rai::Account& account,
+                              const rai::AmountSummary& summary)
+{
+    std::vector<uint8_t> bytes;
+    {
+        rai::VectorStream stream(bytes);
+        summary.Serialize(stream);
+    }
+    rai::MdbVal key(account);
+    rai::MdbVal value(bytes.size(), bytes.data());
+    return store_.Put(transaction.mdb_transaction_, dbi, key, value);
+}
+
+void rai::Ledger::ClearMemoryTables_()
+{
+    std::lock_guard<std::mutex> lock_rep_weights(rep_weights_mutex_);
+    std::lock_guard<std::mutex> lock_rich_list(rich_list_mutex_);
+    std::lock_guard<std::mutex> lock_delegator_list(delegator_list_mutex_);
+
+    total_rep_weight_ = rai::Amount(0);
+    rep_weights_.clear();
+    RepWeightsPublish_();
+    rich_list_.clear();
+    delegator_list_.clear();
+}
+
+std::vector<std::pair<rai::SnapshotTable, MDB_dbi>>
+    rai::Ledger::SnapshotTables_() const
+{
+    // The wallets table is local to a wallet and the callbacks outbox local to
+    // a node, neither is exported, nor is the CALLBACK_ACKED meta record. The
+    // summaries are rebuilt on import.
+    return {{rai::SnapshotTable::ACCOUNTS, store_.accounts_},
+            {rai::SnapshotTable::BLOCKS, store_.blocks_},
+            {rai::SnapshotTable::BLOCKS_INDEX, store_.blocks_index_},
+            {rai::SnapshotTable::META, store_.meta_},
+            {rai::SnapshotTable::RECEIVABLES, store_.receivables_},
+            {rai::SnapshotTable::REWARDABLES, store_.rewardables_},
+            {rai::SnapshotTable::ROLLBACKS, store_.rollbacks_},
+            {rai::SnapshotTable::FORKS, store_.forks_},
+            {rai::SnapshotTable::SOURCES, store_.sources_}};
+}
+
+rai::ErrorCode rai::Ledger::SnapshotVerify_(rai::Transaction& transaction)
+{
+    rai::Genesis genesis;
+    const rai::Block& genesis_block = *genesis.block_;
+    rai::AccountInfo genesis_info;
+    bool error =
+        AccountInfoGet(transaction, genesis_block.Account(), genesis_info);
+    if (error || !genesis_info.Valid())
+    {
+        return rai::ErrorCode::SNAPSHOT_GENESIS;
+    }
+    if (genesis_info.tail_height_ == 0
+        && genesis_info.tail_ != genesis_block.Hash())
+    {
+        return rai::ErrorCode::SNAPSHOT_GENESIS;
+    }
+
+    for (auto i = AccountInfoBegin(transaction),
+              n = AccountInfoEnd(transaction);
+         i != n; ++i)
+    {
+        rai::Account account;
+        rai::AccountInfo info;
+        error = AccountInfoGet(i, account, info);
+        if (error || !info.Valid() || info.tail_height_ > info.head_height_)
+        {
+            return rai::ErrorCode::SNAPSHOT_ACCOUNT_HEAD;
+        }
+
+        if (info.confirmed_height_ != rai::Block::INVALID_HEIGHT
+            && info.confirmed_height_ > info.head_height_)
+        {
+            return rai::ErrorCode::SNAPSHOT_ACCOUNT_HEAD;
+        }
+
+        std::shared_ptr<rai::Block> head(nullptr);
+        error = BlockGet(transaction, info.head_, head);
+        if (error || head->Account() != account
+            || head->Height() != info.head_height_)
+        {
+            return rai::ErrorCode::SNAPSHOT_ACCOUNT_HEAD;
+        }
+
+        std::shared_ptr<rai::Block> tail(nullptr);
+        error = BlockGet(transaction, info.tail_, tail);
+        if (error || tail->Account() != account
+            || tail->Height() != info.tail_height_)
+        {
+            return rai::ErrorCode::SNAPSHOT_ACCOUNT_HEAD;
+        }
+    }
 
     return rai::ErrorCode::SUCCESS;
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
@@ -26,6 +28,20 @@ private:
     rai::Amount weight_;
 };
 
+// Immutable, versioned copy of the representative weights. A new snapshot is
+// published after every commit that changes a weight, readers just keep a
+// reference to the one they loaded.
+class RepWeightsSnapshot
+{
+public:
+    RepWeightsSnapshot();
+    bool Get(const rai::Account&, rai::Amount&) const;
+
+    uint64_t version_;
+    rai::Amount total_;
+    std::unordered_map<rai::Account, rai::Amount> weights_;
+};
+
 class Transaction
 {
 public:
@@ -111,6 +127,17 @@ public:
     uint64_t valid_timestamp_;
 };
 
+class AmountSummary
+{
+public:
+    AmountSummary();
+    void Serialize(rai::Stream&) const;
+    bool Deserialize(rai::Stream&);
+
+    uint64_t count_;
+    rai::Amount amount_;
+};
+
 class WalletInfo
 {
 public:
@@ -142,6 +169,22 @@ enum class MetaKey : uint32_t
 {
     VERSION            = 0,
     SELECTED_WALLET_ID = 1,
+    SUMMARIES_VERSION  = 2,
+    CALLBACK_ACKED     = 3,
+};
+
+enum class SnapshotTable : uint8_t
+{
+    END          = 0,
+    ACCOUNTS     = 1,
+    BLOCKS       = 2,
+    BLOCKS_INDEX = 3,
+    META         = 4,
+    RECEIVABLES  = 5,
+    REWARDABLES  = 6,
+    ROLLBACKS    = 7,
+    FORKS        = 8,
+    SOURCES      = 9,
 };
 
 typedef std::multimap<rai::ReceivableInfo, rai::BlockHash,
@@ -160,6 +203,33 @@ enum class ReceivableInfosType
     ALL           = 2
 };
 
+class ReceivableInfoEntry
+{
+public:
+    bool operator<(const rai::ReceivableInfoEntry&) const;
+
+    rai::Account destination_;
+    rai::BlockHash hash_;
+    rai::ReceivableInfo info_;
+};
+
+// Continuation token of a receivable page, entries are ordered by amount
+// descending and then by hash
+class ReceivableInfosCursor
+{
+public:
+    ReceivableInfosCursor();
+    bool After(const rai::ReceivableInfoEntry&) const;
+    void Set(const rai::ReceivableInfoEntry&);
+    std::string String() const;
+    bool Decode(const std::string&);
+
+    bool begin_;
+    bool more_;
+    rai::Amount amount_;
+    rai::BlockHash hash_;
+};
+
 class RichListEntry
 {
 public:
@@ -265,6 +335,13 @@ public:
     bool ReceivableInfosGet(rai::Transaction&, const rai::Account&,
                             rai::ReceivableInfosType, rai::ReceivableInfos&,
                             size_t = std::numeric_limits<size_t>::max());
+    bool ReceivableInfosPage(rai::Transaction&, rai::ReceivableInfosType,
+                             size_t, rai::ReceivableInfosCursor&,
+                             std::vector<rai::ReceivableInfoEntry>&);
+    bool ReceivableInfosPage(rai::Transaction&, const rai::Account&,
+                             rai::ReceivableInfosType, size_t,
+                             rai::ReceivableInfosCursor&,
+                             std::vector<rai::ReceivableInfoEntry>&);
     bool ReceivableInfoDel(rai::Transaction&, const rai::Account&,
                            const rai::BlockHash&);
     bool ReceivableInfoCount(rai::Transaction&, size_t&) const;
@@ -272,6 +349,8 @@ public:
                                            const rai::Account&);
     rai::Iterator ReceivableInfoUpperBound(rai::Transaction&,
                                            const rai::Account&);
+    bool ReceivableSummaryGet(rai::Transaction&, const rai::Account&,
+                              rai::AmountSummary&) const;
     bool RewardableInfoPut(rai::Transaction&, const rai::Account&,
                            const rai::BlockHash&, const rai::RewardableInfo&);
     bool RewardableInfoGet(rai::Transaction&, const rai::Account&,
@@ -284,10 +363,13 @@ public:
                                            const rai::Account&);
     rai::Iterator RewardableInfoUpperBound(rai::Transaction&,
                                            const rai::Account&);
+    bool RewardableSummaryGet(rai::Transaction&, const rai::Account&,
+                              rai::AmountSummary&) const;
     bool RollbackBlockPut(rai::Transaction&, const rai::BlockHash&,
                           const rai::Block&);
     bool RollbackBlockGet(rai::Transaction&, const rai::BlockHash&,
                           std::shared_ptr<rai::Block>&) const;
+    bool RollbackBlockDel(rai::Transaction&, const rai::BlockHash&);
 
     void RepWeightAdd(rai::Transaction&, const rai::Account&,
                       const rai::Amount&);
@@ -295,6 +377,7 @@ public:
                       const rai::Amount&);
     bool RepWeightGet(const rai::Account&, rai::Amount&) const;
     void RepWeightTotalGet(rai::Amount&) const;
+    std::shared_ptr<const rai::RepWeightsSnapshot> RepWeightsSnapshot() const;
     void RepWeightsGet(rai::Amount&,
                        std::unordered_map<rai::Account, rai::Amount>&) const;
     bool SourcePut(rai::Transaction&, const rai::BlockHash&);
@@ -319,14 +402,36 @@ public:
     bool SelectedWalletIdGet(rai::Transaction&, uint32_t&) const;
     bool VersionPut(rai::Transaction&, uint32_t);
     bool VersionGet(rai::Transaction&, uint32_t&) const;
+    bool CallbackNext(rai::Transaction&, uint64_t&) const;
+    bool CallbackPut(rai::Transaction&, uint64_t, const std::string&);
+    bool CallbackGet(rai::Transaction&, uint64_t, size_t,
+                     std::vector<std::pair<uint64_t, std::string>>&) const;
+    bool CallbackFirst(rai::Transaction&, uint64_t&) const;
+    bool CallbackPrune(rai::Transaction&, uint64_t, size_t, size_t&);
+    bool CallbackAckedPut(rai::Transaction&, uint64_t);
+    bool CallbackAckedGet(rai::Transaction&, uint64_t&) const;
     void UpdateRichList(const rai::Block&);
     std::vector<rai::RichListEntry> GetRichList(uint64_t);
     void UpdateDelegatorList(const rai::Block&);
     std::vector<rai::DelegatorListEntry> GetDelegatorList(const rai::Account&,
                                                           uint64_t);
+    // Changes with every committed write transaction
+    uint64_t Version() const;
 
     rai::ErrorCode UpgradeWallet(rai::Transaction&);
     rai::ErrorCode UpgradeWalletV1V2(rai::Transaction&);
+    rai::ErrorCode SnapshotExport(rai::Transaction&,
+                                  const boost::filesystem::path&);
+    rai::ErrorCode SnapshotImport(rai::Transaction&,
+                                  const boost::filesystem::path&);
+    rai::ErrorCode Prune(rai::Transaction&, rai::Account&, uint64_t, size_t,
+                         size_t&);
+    rai::ErrorCode PruneAccount(rai::Transaction&, const rai::Account&,
+                                uint64_t, size_t, size_t&);
+    rai::ErrorCode PruneRollbacks(rai::Transaction&, size_t&);
+
+    static uint32_t constexpr SNAPSHOT_MAGIC   = 0x52414953;  // "RAIS"
+    static uint32_t constexpr SNAPSHOT_VERSION = 1;
 
 private:
     friend class rai::Transaction;
@@ -337,18 +442,44 @@ private:
                         rai::BlockHash&) const;
     bool BlockIndexDel_(rai::Transaction&, const rai::Account&, uint64_t);
     void RepWeightsCommit_(const std::vector<rai::RepWeightOpration>&);
+    void RepWeightsPublish_();
     rai::ErrorCode InitMemoryTables_(rai::Transaction&);
+    rai::ErrorCode InitSummaries_(rai::Transaction&);
+    bool ReceivableInfosPage_(rai::Transaction&, rai::Iterator&,
+                              rai::Iterator&, rai::ReceivableInfosType,
+                              size_t, rai::ReceivableInfosCursor&,
+                              std::vector<rai::ReceivableInfoEntry>&);
+    bool ReceivableInfoMatch_(rai::Transaction&, const rai::BlockHash&,
+                              rai::ReceivableInfosType, bool&) const;
+    bool SummaryGet_(rai::Transaction&, MDB_dbi, const rai::Account&,
+                     rai::AmountSummary&) const;
+    bool SummaryUpdate_(rai::Transaction&, MDB_dbi, const rai::Account&,
+                        bool, const rai::Amount&);
+    bool SummaryPut_(rai::Transaction&, MDB_dbi, const rai::Account&,
+                     const rai::AmountSummary&);
+    void ClearMemoryTables_();
+    bool PruneReferenced_(rai::Transaction&, const rai::BlockHash&,
+                          const rai::Block&) const;
+    std::vector<std::pair<rai::SnapshotTable, MDB_dbi>> SnapshotTables_()
+        const;
+    rai::ErrorCode SnapshotVerify_(rai::Transaction&);
     void UpdateRichList_(const rai::Account&, const rai::Amount&);
     void UpdateDelegatorList_(const rai::Account&, const rai::Account&,
                               const rai::Amount&, rai::BlockType);
 
     static uint32_t constexpr BLOCKS_PER_INDEX = 8;
+    static size_t constexpr PRUNE_ACCOUNTS_PER_BATCH = 1024;
+    static uint32_t constexpr SUMMARIES_VERSION = 1;
     const rai::Amount RICH_LIST_MINIMUM = rai::Amount(10 * rai::RAI);
 
     rai::Store& store_;
+    std::atomic<uint64_t> version_;
     mutable std::mutex rep_weights_mutex_;
     rai::Amount total_rep_weight_;
     std::unordered_map<rai::Account, rai::Amount> rep_weights_;
+    uint64_t rep_weights_version_;
+    // Accessed only through std::atomic_load/std::atomic_store
+    std::shared_ptr<const rai::RepWeightsSnapshot> rep_weights_snapshot_;
 
     bool enable_rich_list_;
     mutable std::mutex rich_list_mutex_;
@@ -1,7 +1,10 @@
 #include <rai/secure/lmdb.hpp>
 
+uint64_t constexpr rai::MdbEnv::DEFAULT_MAP_SIZE;
+
 rai::MdbEnv::MdbEnv(rai::ErrorCode& error_code,
-                    const boost::filesystem::path& path, int max_dbs)
+                    const boost::filesystem::path& path, int max_dbs,
+                    uint64_t map_size, unsigned int flags)
 {
     if (!path.has_parent_path())
     {
@@ -24,15 +27,15 @@ rai::MdbEnv::MdbEnv(rai::ErrorCode& error_code,
         return;
     }
 
-    error = mdb_env_set_mapsize(env_, 1ULL * 1024 * 1024 * 1024 * 128);
+    error = mdb_env_set_mapsize(env_, map_size);
     if (error)
     {
         error_code = rai::ErrorCode::MDB_ENV_SET_MAPSIZE;
         return;
     }
 
-    error = mdb_env_open(env_, path.string().c_str(), MDB_NOSUBDIR | MDB_NOTLS,
-                         00600);
+    error = mdb_env_open(env_, path.string().c_str(),
+                         MDB_NOSUBDIR | MDB_NOTLS | flags, 00600);
     if (error)
     {
         error_code = rai::ErrorCode::MDB_ENV_OPEN;
@@ -54,6 +57,38 @@ rai::MdbEnv::operator MDB_env*() const
     return env_;
 }
 
+bool rai::MdbEnv::SetFlags(unsigned int flags, bool on)
+{
+    if (env_ == nullptr)
+    {
+        return true;
+    }
+
+    auto ret = mdb_env_set_flags(env_, flags, on ? 1 : 0);
+    if (ret != MDB_SUCCESS)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+bool rai::MdbEnv::Sync(bool force)
+{
+    if (env_ == nullptr)
+    {
+        return true;
+    }
+
+    auto ret = mdb_env_sync(env_, force ? 1 : 0);
+    if (ret != MDB_SUCCESS)
+    {
+        return true;
+    }
+
+    return false;
+}
+
 rai::MdbVal::MdbVal() : value_{0, nullptr}
 {
 }
@@ -122,10 +157,7 @@ rai::MdbTransaction::MdbTransaction(rai::ErrorCode& error_code,
 
 rai::MdbTransaction::~MdbTransaction()
 {
-    if (handle_)
-    {
-        mdb_txn_commit(handle_);
-    }
+    Commit();
 }
 
 rai::MdbTransaction::operator MDB_txn*() const
@@ -133,6 +165,15 @@ rai::MdbTransaction::operator MDB_txn*() const
     return handle_;
 }
 
+void rai::MdbTransaction::Commit()
+{
+    if (handle_)
+    {
+        mdb_txn_commit(handle_);
+        handle_ = nullptr;
+    }
+}
+
 void rai::MdbTransaction::Abort()
 {
     if (handle_)
@@ -10,9 +10,15 @@ namespace rai
 class MdbEnv
 {
 public:
-    MdbEnv(rai::ErrorCode&, const boost::filesystem::path&, int);
+    MdbEnv(rai::ErrorCode&, const boost::filesystem::path&, int,
+           uint64_t = rai::MdbEnv::DEFAULT_MAP_SIZE, unsigned int = 0);
     ~MdbEnv();
     operator MDB_env*() const;
+    bool SetFlags(unsigned int, bool);
+    bool Sync(bool);
+
+    static uint64_t constexpr DEFAULT_MAP_SIZE = 1ULL * 1024 * 1024 * 1024 * 128;
+
     MDB_env* env_;
 };
 
@@ -42,6 +48,7 @@ public:
     ~MdbTransaction();
     rai::MdbTransaction& operator=(const rai::MdbTransaction&) = delete;
     operator MDB_txn*() const;
+    void Commit();
     void Abort();
 
     MDB_txn* handle_;
@@ -7,4 +7,7 @@ namespace rai
 boost::filesystem::path AppPath();
 void SetStdinEcho(bool);
 std::string PemPath();
+// Keep the pages of a buffer out of swap, return true on error
+bool LockMemory(void*, size_t);
+void UnlockMemory(void*, size_t);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <limits.h>
 #include <boost/filesystem.hpp>
 #include <pwd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <termios.h>
 #include <unistd.h>
@@ -44,4 +45,14 @@ std::string rai::PemPath()
   path = path.parent_path() / result;
   result = path.string();
   return result;
-}
\ No newline at end of file
+}
+
+bool rai::LockMemory(void* data, size_t size)
+{
+  return mlock(data, size) != 0;
+}
+
+void rai::UnlockMemory(void* data, size_t size)
+{
+  munlock(data, size);
+}
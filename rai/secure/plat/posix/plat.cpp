@@ -1,6 +1,7 @@
 #include <rai/secure/plat.hpp>
 
 #include <pwd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <termios.h>
 #include <unistd.h>
@@ -32,3 +33,13 @@ std::string rai::PemPath()
   std::string result = "cacert.pem";
   return result;
 }
+
+bool rai::LockMemory(void* data, size_t size)
+{
+  return mlock(data, size) != 0;
+}
+
+void rai::UnlockMemory(void* data, size_t size)
+{
+  munlock(data, size);
+}
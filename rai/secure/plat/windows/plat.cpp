@@ -36,4 +36,14 @@ std::string rai::PemPath()
 {
   std::string result = "cacert.pem";
   return result;
-}
\ No newline at end of file
+}
+
+bool rai::LockMemory(void* data, size_t size)
+{
+  return VirtualLock(data, size) == 0;
+}
+
+void rai::UnlockMemory(void* data, size_t size)
+{
+  VirtualUnlock(data, size);
+}
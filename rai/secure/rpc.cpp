@@ -1,18 +1,125 @@
 #include <rai/secure/rpc.hpp>
 
+#include <algorithm>
+#include <limits>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <rai/common/json.hpp>
 #include <rai/common/log.hpp>
 #include <rai/common/stat.hpp>
 
+rai::RpcActionStat::RpcActionStat()
+    : count_(0), errors_(0), total_us_(0), max_us_(0), histogram_()
+{
+}
+
+size_t constexpr rai::RpcActionStat::BUCKETS;
+
+uint64_t rai::RpcActionStat::BucketBound(size_t index)
+{
+    if (index + 1 >= rai::RpcActionStat::BUCKETS)
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return uint64_t(16) << (2 * index);
+}
+
+void rai::RpcActionStats::Add(const std::string& action, bool error,
+                              uint64_t us)
+{
+    size_t bucket = 0;
+    while (bucket + 1 < rai::RpcActionStat::BUCKETS
+           && us > rai::RpcActionStat::BucketBound(bucket))
+    {
+        ++bucket;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    rai::RpcActionStat& stat = stats_[action];
+    ++stat.count_;
+    if (error)
+    {
+        ++stat.errors_;
+    }
+    stat.total_us_ += us;
+    if (us > stat.max_us_)
+    {
+        stat.max_us_ = us;
+    }
+    ++stat.histogram_[bucket];
+}
+
+std::vector<std::pair<std::string, rai::RpcActionStat>>
+rai::RpcActionStats::Get() const
+{
+    std::vector<std::pair<std::string, rai::RpcActionStat>> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.assign(stats_.begin(), stats_.end());
+    }
+    // most time consuming first
+    std::sort(result.begin(), result.end(),
+              [](const std::pair<std::string, rai::RpcActionStat>& lhs,
+                 const std::pair<std::string, rai::RpcActionStat>& rhs) {
+                  return lhs.second.total_us_ > rhs.second.total_us_;
+              });
+    return result;
+}
+
+void rai::RpcActionStats::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.clear();
+}
+
+uint32_t constexpr rai::RpcConfig::DEFAULT_WORKERS;
+uint32_t constexpr rai::RpcConfig::DEFAULT_QUEUE_SIZE;
+
 rai::Rpc::Rpc(boost::asio::io_service& service, const rai::RpcConfig& config,
               const rai::RpcHandlerMaker& maker)
     : service_(service),
       acceptor_(service),
       config_(config),
       make_handler_(maker),
-      stopped_{ATOMIC_FLAG_INIT}
+      stopped_{ATOMIC_FLAG_INIT},
+      stopping_(false),
+      rejected_(0)
+{
+}
+
+rai::Rpc::~Rpc()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+
+    for (auto& i : workers_)
+    {
+        if (!i.joinable())
+        {
+            continue;
+        }
+        if (i.get_id() == std::this_thread::get_id())
+        {
+            i.detach();
+            continue;
+        }
+        i.join();
+    }
+}
+
+bool rai::Rpc::Worker_() const
 {
+    for (const auto& i : workers_)
+    {
+        if (i.get_id() == std::this_thread::get_id())
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 void rai::Rpc::Start()
@@ -34,15 +141,42 @@ void rai::Rpc::Start()
     acceptor_.listen();
 
     Accept();
+
+    uint32_t workers = std::max(config_.workers_, uint32_t(1));
+    for (uint32_t i = 0; i < workers; ++i)
+    {
+        workers_.push_back(std::thread([this]() { Run_(); }));
+    }
 }
 
 void rai::Rpc::Stop()
 {
-    if (stopped_.test_and_set())
+    if (!stopped_.test_and_set())
+    {
+        acceptor_.close();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            queue_.clear();
+        }
+        condition_.notify_all();
+    }
+
+    // the stop action runs on a worker and can't wait for the pool, the
+    // owner calls Stop again before the handlers' state is destroyed
+    if (Worker_())
     {
         return;
     }
-    acceptor_.close();
+
+    std::lock_guard<std::mutex> lock(join_mutex_);
+    for (auto& i : workers_)
+    {
+        if (i.joinable())
+        {
+            i.join();
+        }
+    }
 }
 
 
@@ -71,6 +205,58 @@ void rai::Rpc::Accept()
         });
 }
 
+bool rai::Rpc::Post(const std::function<void()>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.size() >= config_.queue_size_)
+        {
+            ++rejected_;
+            return true;
+        }
+        queue_.push_back(task);
+    }
+    condition_.notify_one();
+    return false;
+}
+
+rai::RpcPoolStat rai::Rpc::PoolStat() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rai::RpcPoolStat{workers_.size(), queue_.size(), rejected_};
+}
+
+void rai::Rpc::Run_()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        if (queue_.empty())
+        {
+            condition_.wait(lock);
+            continue;
+        }
+
+        std::function<void()> task(std::move(queue_.front()));
+        queue_.pop_front();
+        lock.unlock();
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            rai::Log::Error(std::string("RPC worker throw exception:")
+                            + e.what());
+        }
+        catch (...)
+        {
+            rai::Log::Error("RPC worker throw exception");
+        }
+        lock.lock();
+    }
+}
+
 bool rai::Rpc::CheckWhitelist(const boost::asio::ip::address_v4& ip) const
 {
     bool error = true;
@@ -85,8 +271,15 @@ bool rai::Rpc::CheckWhitelist(const boost::asio::ip::address_v4& ip) const
     return error;
 }
 
+std::chrono::seconds constexpr rai::RpcConnection::KEEPALIVE_TIMEOUT;
+
 rai::RpcConnection::RpcConnection(rai::Rpc& rpc)
-    : rpc_(rpc), socket_(rpc.service_)
+    : rpc_(rpc),
+      socket_(rpc.service_),
+      strand_(rpc.service_),
+      timer_(rpc.service_),
+      reading_(false),
+      keep_alive_(false)
 {
     responded_.clear();
 }
@@ -107,23 +300,47 @@ void rai::RpcConnection::Parse()
         return;
     }
 
-    Read();
+    // reading_ and timer_ are only touched on the strand
+    auto connection = shared_from_this();
+    strand_.dispatch([connection]() { connection->Read(); });
 }
 
 void rai::RpcConnection::Read()
 {
     auto connection = shared_from_this();
+    reading_ = true;
+    timer_.expires_from_now(rai::RpcConnection::KEEPALIVE_TIMEOUT);
+    timer_.async_wait(
+        strand_.wrap([connection](const boost::system::error_code& ec) {
+            if (!ec && connection->reading_)
+            {
+                boost::system::error_code ignore;
+                connection->socket_.close(ignore);
+            }
+        }));
+
     boost::beast::http::async_read(
         socket_, buffer_, request_,
-        [connection](const boost::system::error_code& ec, size_t size) {
+        strand_.wrap([connection](const boost::system::error_code& ec,
+                                  size_t size) {
+            connection->reading_ = false;
+            boost::system::error_code ignore;
+            connection->timer_.cancel(ignore);
             if (ec)
             {
-                rai::Log::Rpc(boost::str(boost::format("RPC read error:%1%")
-                                         % ec.message()));
+                if (ec != boost::beast::http::error::end_of_stream
+                    && ec != boost::asio::error::operation_aborted)
+                {
+                    rai::Log::Rpc(boost::str(
+                        boost::format("RPC read error:%1%") % ec.message()));
+                }
                 return;
             }
+            connection->keep_alive_ = connection->request_.keep_alive();
 
-            connection->rpc_.service_.post([connection]() {
+            // executed by the RPC workers so slow requests never hold the io
+            // threads serving the network
+            auto task = [connection]() {
                 auto start = std::chrono::steady_clock::now();
                 auto version = connection->request_.version();
                 std::string unique_id = boost::str(
@@ -135,23 +352,7 @@ void rai::RpcConnection::Read()
                 auto response_handler =
                     [connection, version, start,
                      unique_id](const boost::property_tree::ptree& ptree) {
-                        std::stringstream ostream;
-                        boost::property_tree::write_json(ostream, ptree);
-                        ostream.flush();
-                        std::string body = ostream.str();
-                        connection->Write(body, version);
-                        boost::beast::http::async_write(
-                            connection->socket_, connection->response_,
-                            [connection](const boost::system::error_code& ec,
-                                         size_t size) {
-                                if (ec)
-                                {
-                                    rai::Log::Rpc(boost::str(
-                                        boost::format("RPC write error:%1%")
-                                        % ec.message()));
-                                    return;
-                                }
-                            });
+                        connection->Respond(rai::PtreeToJson(ptree), version);
                         rai::Log::Rpc(boost::str(
                             boost::format("RPC request %1% completed in: "
                                           "%2% microseconds")
@@ -179,10 +380,56 @@ void rai::RpcConnection::Read()
                     response.put("error", "Only POST requests are allowed");
                     response_handler(response);
                 }
-            });
+            };
+
+            if (connection->rpc_.Post(task))
+            {
+                rai::ErrorCode error_code = rai::ErrorCode::RPC_BUSY;
+                rai::Ptree response;
+                response.put("error", rai::ErrorString(error_code));
+                response.put("error_code", static_cast<uint32_t>(error_code));
+                connection->Respond(rai::PtreeToJson(response),
+                                    connection->request_.version());
+                rai::Stats::Add(error_code);
+            }
+        }));
+}
+
+void rai::RpcConnection::Respond(const std::string& body, unsigned version)
+{
+    Write(body, version);
+    auto connection = shared_from_this();
+    boost::beast::http::async_write(
+        socket_, response_,
+        [connection](const boost::system::error_code& ec, size_t size) {
+            if (ec)
+            {
+                rai::Log::Rpc(boost::str(boost::format("RPC write error:%1%")
+                                         % ec.message()));
+                return;
+            }
+            connection->Next();
         });
 }
 
+void rai::RpcConnection::Next()
+{
+    boost::system::error_code ec;
+    if (!keep_alive_)
+    {
+        socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+        return;
+    }
+
+    // one request at a time, the next is read once the response is written
+    request_ = boost::beast::http::request<boost::beast::http::string_body>();
+    response_ =
+        boost::beast::http::response<boost::beast::http::string_body>();
+    responded_.clear();
+    auto connection = shared_from_this();
+    strand_.dispatch([connection]() { connection->Read(); });
+}
+
 void rai::RpcConnection::Write(const std::string& body, unsigned version)
 {
     if (responded_.test_and_set())
@@ -195,13 +442,15 @@ void rai::RpcConnection::Write(const std::string& body, unsigned version)
     response_.set("Access-Control-Allow-Origin", "*");
     response_.set("Access-Control-Allow-Headers",
                   "Accept, Accept-Language, Content-Language, Content-Type");
-    response_.set("Connection", "close");
+    response_.keep_alive(keep_alive_);
     response_.result(boost::beast::http::status::ok);
     response_.body() = body;
     response_.version(version);
     response_.prepare_payload();
 }
 
+size_t constexpr rai::RpcHandler::MAX_BATCH_REQUESTS;
+
 rai::RpcHandler::RpcHandler(
     rai::Rpc& rpc, const std::string& body,
     const boost::asio::ip::address_v4& ip,
@@ -210,7 +459,8 @@ rai::RpcHandler::RpcHandler(
       body_(body),
       ip_(ip),
       send_response_(send_response),
-      error_code_(rai::ErrorCode::SUCCESS)
+      error_code_(rai::ErrorCode::SUCCESS),
+      deadline_(std::chrono::steady_clock::time_point::max())
 {
 }
 
@@ -222,49 +472,33 @@ void rai::RpcHandler::Check()
         return;
     }
 
-    int depth = 0;
-    for (auto ch : body_)
+    // parse and depth check in one pass, deep input is rejected before the
+    // tree below the limit is built
+    rai::JsonReader reader(rai::RpcHandler::MAX_JSON_DEPTH);
+    rai::JsonPtreeHandler handler(request_);
+    bool error = reader.Parse(body_, handler);
+    if (error)
     {
-        if (ch == '[' || ch == '{')
-        {
-            ++depth;
-        }
-        else if (ch == ']' || ch == '}')
-        {
-            --depth;
-        }
-        else
-        {
-            continue;
-        }
-
-        if (depth < 0)
-        {
-            error_code_ = rai::ErrorCode::RPC_JSON;
-            return;
-        }
-
-        if (depth > rai::RpcHandler::MAX_JSON_DEPTH)
-        {
-            error_code_ = rai::ErrorCode::RPC_JSON_DEPTH;
-            return;
-        }
+        error_code_ = reader.DepthExceeded() ? rai::ErrorCode::RPC_JSON_DEPTH
+                                             : rai::ErrorCode::RPC_JSON;
+        return;
     }
 }
 
 void rai::RpcHandler::Process()
 {
-    try
+    Check();
+    if (error_code_ == rai::ErrorCode::SUCCESS)
     {
-        Check();
-        if (error_code_ != rai::ErrorCode::SUCCESS)
-        {
-            Response();
-            return;
-        }
+        Dispatch();
+    }
+    Response();
+}
 
-        std::stringstream stream(body_);
-        boost::property_tree::read_json(stream, request_);
+void rai::RpcHandler::Dispatch()
+{
+    try
+    {
         std::string action = request_.get<std::string>("action");
         if (action == "stop")
         {
@@ -297,8 +531,6 @@ void rai::RpcHandler::Process()
     {
         error_code_ = rai::ErrorCode::RPC_GENERIC;
     }
-
-    Response();
 }
 
 void rai::RpcHandler::Response()
@@ -314,7 +546,10 @@ void rai::RpcHandler::Response()
         response_.put("error_code", static_cast<uint32_t>(error_code_));
     }
 
-    send_response_(response_);
+    if (send_response_)
+    {
+        send_response_(response_);
+    }
 
     if (error_code_ != rai::ErrorCode::SUCCESS)
     {
@@ -327,6 +562,56 @@ void rai::RpcHandler::Stop()
     rpc_.Stop();
 }
 
+void rai::RpcHandler::RpcStats()
+{
+    rai::Ptree actions;
+    for (const auto& i : rpc_.stats_.Get())
+    {
+        const rai::RpcActionStat& stat = i.second;
+        rai::Ptree entry;
+        entry.put("action", i.first);
+        entry.put("count", stat.count_);
+        entry.put("errors", stat.errors_);
+        entry.put("total_us", stat.total_us_);
+        entry.put("average_us",
+                  stat.count_ == 0 ? 0 : stat.total_us_ / stat.count_);
+        entry.put("max_us", stat.max_us_);
+
+        rai::Ptree histogram;
+        for (size_t j = 0; j < rai::RpcActionStat::BUCKETS; ++j)
+        {
+            rai::Ptree bucket;
+            if (j + 1 < rai::RpcActionStat::BUCKETS)
+            {
+                bucket.put("le_us", rai::RpcActionStat::BucketBound(j));
+            }
+            else
+            {
+                bucket.put("le_us", "inf");
+            }
+            bucket.put("count", stat.histogram_[j]);
+            histogram.push_back(std::make_pair("", bucket));
+        }
+        entry.put_child("histogram", histogram);
+        actions.push_back(std::make_pair("", entry));
+    }
+    response_.put_child("actions", actions);
+
+    rai::RpcPoolStat stat = rpc_.PoolStat();
+    rai::Ptree pool;
+    pool.put("workers", stat.workers_);
+    pool.put("queue", stat.queue_);
+    pool.put("queue_size", rpc_.config_.queue_size_);
+    pool.put("rejected", stat.rejected_);
+    response_.put_child("pool", pool);
+}
+
+void rai::RpcHandler::RpcStatsClear()
+{
+    rpc_.stats_.Clear();
+    response_.put("success", "");
+}
+
 
 bool rai::RpcHandler::CheckControl_()
 {
@@ -355,6 +640,28 @@ bool rai::RpcHandler::CheckLocal_()
     return true;
 }
 
+void rai::RpcHandler::AddStat_(const std::string& action,
+                               std::chrono::steady_clock::time_point start)
+{
+    // only called for actions found in a handler's registry
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    rpc_.stats_.Add(action, error_code_ != rai::ErrorCode::SUCCESS,
+                    static_cast<uint64_t>(us));
+}
+
+bool rai::RpcHandler::Expired_()
+{
+    if (std::chrono::steady_clock::now() < deadline_)
+    {
+        return false;
+    }
+
+    error_code_ = rai::ErrorCode::RPC_ACTION_TIMEOUT;
+    return true;
+}
+
 bool rai::RpcHandler::GetAccount_(rai::Account& account)
 {
     auto account_o = request_.get_optional<std::string>("account");
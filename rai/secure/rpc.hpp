@@ -1,6 +1,14 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <rai/common/parameters.hpp>
@@ -17,6 +25,44 @@ public:
     bool enable_control_;
     // only ips in the white list can access
     std::vector<boost::asio::ip::address_v4> whitelist_;
+    // threads executing requests, off the io_service shared with the network
+    uint32_t workers_;
+    // requests waiting for a worker, more are rejected as busy
+    uint32_t queue_size_;
+
+    static uint32_t constexpr DEFAULT_WORKERS    = 2;
+    static uint32_t constexpr DEFAULT_QUEUE_SIZE = 64;
+};
+
+class RpcActionStat
+{
+public:
+    RpcActionStat();
+
+    // upper bounds in microseconds are 16, 64, 256, ... 4^12, the last bucket
+    // is unbounded
+    static size_t constexpr BUCKETS = 12;
+    static uint64_t BucketBound(size_t);
+
+    uint64_t count_;
+    uint64_t errors_;
+    uint64_t total_us_;
+    uint64_t max_us_;
+    std::array<uint64_t, rai::RpcActionStat::BUCKETS> histogram_;
+};
+
+// Calls, errors and latency per action, only actions known to a handler are
+// recorded so the table can't be grown by clients
+class RpcActionStats
+{
+public:
+    void Add(const std::string&, bool, uint64_t);
+    std::vector<std::pair<std::string, rai::RpcActionStat>> Get() const;
+    void Clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, rai::RpcActionStat> stats_;
 };
 
 class Rpc;
@@ -27,21 +73,47 @@ typedef std::function<std::unique_ptr<RpcHandler>(
     const std::function<void(const rai::Ptree&)>&)>
     RpcHandlerMaker;
 
+class RpcPoolStat
+{
+public:
+    size_t workers_;
+    size_t queue_;
+    uint64_t rejected_;
+};
+
 class Rpc
 {
 public:
     Rpc(boost::asio::io_service&, const rai::RpcConfig&,
         const rai::RpcHandlerMaker&);
+    virtual ~Rpc();
     void Start();
+    // Waits for running requests unless called from a worker
     void Stop();
     virtual void Accept();
     bool CheckWhitelist(const boost::asio::ip::address_v4&) const;
+    // Queues a request for the worker pool, returns true if it is full
+    bool Post(const std::function<void()>&);
+    rai::RpcPoolStat PoolStat() const;
 
     boost::asio::io_service& service_;
     boost::asio::ip::tcp::acceptor acceptor_;
     rai::RpcConfig config_;
     std::atomic_flag stopped_;
     rai::RpcHandlerMaker make_handler_;
+    rai::RpcActionStats stats_;
+
+private:
+    void Run_();
+    bool Worker_() const;
+
+    std::mutex join_mutex_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+    std::deque<std::function<void()>> queue_;
+    uint64_t rejected_;
+    std::vector<std::thread> workers_;
 };
 
 class RpcConnection : public std::enable_shared_from_this<rai::RpcConnection>
@@ -51,15 +123,40 @@ public:
     virtual void Parse();
     virtual void Read();
     virtual void Write(const std::string&, unsigned);
+    void Respond(const std::string&, unsigned);
+    void Next();
+
+    // idle time allowed between requests on a keep-alive connection
+    static std::chrono::seconds constexpr KEEPALIVE_TIMEOUT =
+        std::chrono::seconds(30);
 
     rai::Rpc& rpc_;
     boost::asio::ip::tcp::socket socket_;
+    boost::asio::io_service::strand strand_;
+    boost::asio::steady_timer timer_;
+    // waiting for the next request, guarded by strand_
+    bool reading_;
+    bool keep_alive_;
     boost::beast::flat_buffer buffer_;
     boost::beast::http::request<boost::beast::http::string_body> request_;
     boost::beast::http::response<boost::beast::http::string_body> response_;
     std::atomic_flag responded_;
 };
 
+// Registry entry of a handler's action table
+template <typename T>
+class RpcAction
+{
+public:
+    void (T::*handler_)();
+    // requires enable_control unless the client is local
+    bool control_;
+    // local clients only
+    bool local_;
+    // only reads the ledger, may run in a batch's shared transaction
+    bool read_only_;
+};
+
 class RpcHandler
 {
 public:
@@ -69,13 +166,17 @@ public:
     virtual ~RpcHandler() = default;
     void Check();
     void Process();
+    void Dispatch();
     virtual void ProcessImpl() = 0;
     void Response();
 
     void Stop();
+    void RpcStats();
+    void RpcStatsClear();
 
     static int constexpr MAX_JSON_DEPTH = 20;
     static uint32_t constexpr MAX_BODY_SIZE = 64 * 1024;
+    static size_t constexpr MAX_BATCH_REQUESTS = 256;
 
     rai::Rpc& rpc_;
     std::string body_;
@@ -89,6 +190,8 @@ public:
 protected:
     bool CheckControl_();
     bool CheckLocal_();
+    // Long scans poll this and give up with RPC_ACTION_TIMEOUT
+    bool Expired_();
     bool GetAccount_(rai::Account&);
     bool GetCount_(uint64_t&);
     bool GetHash_(rai::BlockHash&);
@@ -96,8 +199,105 @@ protected:
     bool GetPrevious_(rai::BlockHash&);
     bool GetSignature_(rai::Signature&);
     bool GetTimestamp_(uint64_t&);
+
+    template <typename T>
+    void Call_(const std::unordered_map<std::string, rai::RpcAction<T>>&);
+    void AddStat_(const std::string&, std::chrono::steady_clock::time_point);
+    // Runs the "requests" of a batch in order on handlers built by the
+    // maker, only read only actions are allowed
+    template <typename T>
+    void Batch_(
+        const std::unordered_map<std::string, rai::RpcAction<T>>&,
+        const std::function<std::unique_ptr<T>(
+            const std::function<void(const rai::Ptree&)>&)>&);
+
+    // no limit unless the handler sets one for the action
+    std::chrono::steady_clock::time_point deadline_;
 };
 
+template <typename T>
+void RpcHandler::Call_(
+    const std::unordered_map<std::string, rai::RpcAction<T>>& actions)
+{
+    std::string action = request_.get<std::string>("action");
+    auto it = actions.find(action);
+    if (it == actions.end())
+    {
+        error_code_ = rai::ErrorCode::RPC_UNKNOWN_ACTION;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const rai::RpcAction<T>& entry = it->second;
+    if (entry.control_ && CheckControl_())
+    {
+        AddStat_(action, start);
+        return;
+    }
+    if (entry.local_ && CheckLocal_())
+    {
+        AddStat_(action, start);
+        return;
+    }
+    (static_cast<T*>(this)->*entry.handler_)();
+    AddStat_(action, start);
+}
+
+template <typename T>
+void RpcHandler::Batch_(
+    const std::unordered_map<std::string, rai::RpcAction<T>>& actions,
+    const std::function<std::unique_ptr<T>(
+        const std::function<void(const rai::Ptree&)>&)>& make)
+{
+    auto requests_o = request_.get_child_optional("requests");
+    if (!requests_o)
+    {
+        error_code_ = rai::ErrorCode::RPC_MISS_FIELD_REQUESTS;
+        return;
+    }
+    if (requests_o->empty()
+        || requests_o->size() > rai::RpcHandler::MAX_BATCH_REQUESTS)
+    {
+        error_code_ = rai::ErrorCode::RPC_INVALID_FIELD_REQUESTS;
+        return;
+    }
+
+    rai::Ptree responses;
+    for (const auto& i : *requests_o)
+    {
+        std::unique_ptr<T> handler =
+            make([&responses](const rai::Ptree& response) {
+                responses.push_back(std::make_pair("", response));
+            });
+        handler->header_api_key_ = header_api_key_;
+        handler->request_ = i.second;
+        // sub-requests can't outlive the batch's deadline
+        handler->deadline_ = deadline_;
+
+        auto action_o = i.second.get_optional<std::string>("action");
+        if (!action_o)
+        {
+            handler->error_code_ = rai::ErrorCode::RPC_MISS_FIELD_ACTION;
+        }
+        else if (actions.count(*action_o) == 0
+                 || !actions.at(*action_o).read_only_)
+        {
+            handler->error_code_ = rai::ErrorCode::RPC_BATCH_ACTION;
+            handler->response_.put("ack", *action_o);
+        }
+        else if (handler->Expired_())
+        {
+            handler->response_.put("ack", *action_o);
+        }
+        else
+        {
+            handler->Dispatch();
+        }
+        handler->Response();
+    }
+    response_.put_child("responses", responses);
+}
+
 std::unique_ptr<rai::Rpc> MakeRpc(boost::asio::io_service&,
                                   const rai::RpcConfig&,
                                   const rai::RpcHandlerMaker&);
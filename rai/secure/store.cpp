@@ -1,8 +1,199 @@
 #include <rai/secure/store.hpp>
 
+uint64_t constexpr rai::StorageConfig::DEFAULT_MAP_SIZE_GB;
+uint32_t constexpr rai::StorageConfig::DEFAULT_SYNC_INTERVAL;
+unsigned int constexpr rai::Store::PROFILE_FLAGS;
+
+namespace
+{
+unsigned int ProfileFlags(rai::StorageProfile profile, bool write_map)
+{
+    unsigned int flags = 0;
+    switch (profile)
+    {
+        case rai::StorageProfile::FAST_SYNC:
+        {
+            flags = MDB_NOSYNC;
+            break;
+        }
+        case rai::StorageProfile::BOOTSTRAP:
+        {
+            flags = MDB_NOSYNC | MDB_NOMETASYNC;
+            break;
+        }
+        default:
+        {
+            return 0;
+        }
+    }
+
+    if (write_map)
+    {
+        flags |= MDB_MAPASYNC;
+    }
+    return flags;
+}
+}  // namespace
+
+std::string rai::StorageProfileToString(rai::StorageProfile profile)
+{
+    switch (profile)
+    {
+        case rai::StorageProfile::DURABLE:
+        {
+            return "durable";
+        }
+        case rai::StorageProfile::FAST_SYNC:
+        {
+            return "fast_sync";
+        }
+        case rai::StorageProfile::BOOTSTRAP:
+        {
+            return "bootstrap";
+        }
+        default:
+        {
+            return "invalid";
+        }
+    }
+}
+
+rai::StorageProfile rai::StringToStorageProfile(const std::string& str)
+{
+    if (str == "durable")
+    {
+        return rai::StorageProfile::DURABLE;
+    }
+    else if (str == "fast_sync")
+    {
+        return rai::StorageProfile::FAST_SYNC;
+    }
+    else if (str == "bootstrap")
+    {
+        return rai::StorageProfile::BOOTSTRAP;
+    }
+    else
+    {
+        return rai::StorageProfile::INVALID;
+    }
+}
+
+rai::StorageConfig::StorageConfig()
+    : profile_(rai::StorageProfile::DURABLE),
+      map_size_gb_(rai::StorageConfig::DEFAULT_MAP_SIZE_GB),
+      write_map_(false),
+      no_read_ahead_(false),
+      sync_interval_(rai::StorageConfig::DEFAULT_SYNC_INTERVAL),
+      bootstrap_on_sync_(true)
+{
+}
+
+rai::ErrorCode rai::StorageConfig::DeserializeJson(bool& upgraded,
+                                                   rai::Ptree& ptree)
+{
+    rai::ErrorCode error_code = rai::ErrorCode::SUCCESS;
+    try
+    {
+        error_code = rai::ErrorCode::JSON_CONFIG_STORAGE_VERSION;
+        std::string version_str = ptree.get<std::string>("version");
+        uint32_t version = 0;
+        bool error = rai::StringToUint(version_str, version);
+        IF_ERROR_RETURN(error, error_code);
+
+        error_code = UpgradeJson(upgraded, version, ptree);
+        IF_NOT_SUCCESS_RETURN(error_code);
+
+        error_code = rai::ErrorCode::JSON_CONFIG_STORAGE_PROFILE;
+        profile_ = rai::StringToStorageProfile(ptree.get<std::string>("profile"));
+        if (profile_ == rai::StorageProfile::INVALID)
+        {
+            return error_code;
+        }
+
+        error_code = rai::ErrorCode::JSON_CONFIG_STORAGE_MAP_SIZE;
+        map_size_gb_ = ptree.get<uint64_t>("map_size_gb");
+        if (map_size_gb_ == 0)
+        {
+            return error_code;
+        }
+
+        error_code = rai::ErrorCode::JSON_CONFIG_STORAGE_SYNC_INTERVAL;
+        sync_interval_ = ptree.get<uint32_t>("sync_interval");
+        sync_interval_ = (0 == sync_interval_) ? 1 : sync_interval_;
+
+        error_code = rai::ErrorCode::JSON_CONFIG_STORAGE_OPTIONS;
+        write_map_ = ptree.get<bool>("write_map");
+        no_read_ahead_ = ptree.get<bool>("no_read_ahead");
+        bootstrap_on_sync_ = ptree.get<bool>("bootstrap_on_sync");
+    }
+    catch (const std::exception&)
+    {
+        return error_code;
+    }
+    return rai::ErrorCode::SUCCESS;
+}
+
+void rai::StorageConfig::SerializeJson(rai::Ptree& ptree) const
+{
+    ptree.put("version", "1");
+    ptree.put("profile", rai::StorageProfileToString(profile_));
+    ptree.put("map_size_gb", map_size_gb_);
+    ptree.put("sync_interval", sync_interval_);
+    ptree.put("write_map", write_map_);
+    ptree.put("no_read_ahead", no_read_ahead_);
+    ptree.put("bootstrap_on_sync", bootstrap_on_sync_);
+}
+
+rai::ErrorCode rai::StorageConfig::UpgradeJson(bool& upgraded,
+                                               uint32_t version,
+                                               rai::Ptree& ptree) const
+{
+    switch (version)
+    {
+        case 1:
+        {
+            break;
+        }
+        default:
+        {
+            return rai::ErrorCode::CONFIG_STORAGE_VERSION;
+        }
+    }
+
+    return rai::ErrorCode::SUCCESS;
+}
+
+uint64_t rai::StorageConfig::MapSize() const
+{
+    return map_size_gb_ * 1024 * 1024 * 1024;
+}
+
+unsigned int rai::StorageConfig::OpenFlags() const
+{
+    unsigned int flags = ProfileFlags(profile_, write_map_);
+    if (write_map_)
+    {
+        flags |= MDB_WRITEMAP;
+    }
+    if (no_read_ahead_)
+    {
+        flags |= MDB_NORDAHEAD;
+    }
+    return flags;
+}
+
 rai::Store::Store(rai::ErrorCode& error_code,
                   const boost::filesystem::path& path)
-    : env_(error_code, path, 128),
+    : Store(error_code, path, rai::StorageConfig())
+{
+}
+
+rai::Store::Store(rai::ErrorCode& error_code,
+                  const boost::filesystem::path& path,
+                  const rai::StorageConfig& config)
+    : profile_(config.profile_),
+      write_map_(config.write_map_),
+      env_(error_code, path, 128, config.MapSize(), config.OpenFlags()),
       accounts_(0),
       blocks_(0),
       blocks_index_(0),
@@ -12,7 +203,10 @@ rai::Store::Store(rai::ErrorCode& error_code,
       rollbacks_(0),
       forks_(0),
       wallets_(0),
-      sources_(0)
+      sources_(0),
+      receivable_summaries_(0),
+      rewardable_summaries_(0),
+      callbacks_(0)
 {
     if (error_code != rai::ErrorCode::SUCCESS)
     {
@@ -94,6 +288,70 @@ rai::Store::Store(rai::ErrorCode& error_code,
         error_code = rai::ErrorCode::MDB_DBI_OPEN;
         return;
     }
+
+    ret = mdb_dbi_open(transaction, "receivable_summaries", MDB_CREATE,
+                       &receivable_summaries_);
+    if (ret != MDB_SUCCESS)
+    {
+        error_code = rai::ErrorCode::MDB_DBI_OPEN;
+        return;
+    }
+
+    ret = mdb_dbi_open(transaction, "rewardable_summaries", MDB_CREATE,
+                       &rewardable_summaries_);
+    if (ret != MDB_SUCCESS)
+    {
+        error_code = rai::ErrorCode::MDB_DBI_OPEN;
+        return;
+    }
+
+    ret = mdb_dbi_open(transaction, "callbacks", MDB_CREATE, &callbacks_);
+    if (ret != MDB_SUCCESS)
+    {
+        error_code = rai::ErrorCode::MDB_DBI_OPEN;
+        return;
+    }
+}
+
+bool rai::Store::SetProfile(rai::StorageProfile profile)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (profile == profile_)
+    {
+        return false;
+    }
+
+    // Flush commits made under the previous profile before the switch
+    bool error = env_.Sync(true);
+    IF_ERROR_RETURN(error, true);
+
+    error = env_.SetFlags(rai::Store::PROFILE_FLAGS, false);
+    IF_ERROR_RETURN(error, true);
+    unsigned int flags = ProfileFlags(profile, write_map_);
+    if (flags != 0)
+    {
+        error = env_.SetFlags(flags, true);
+        IF_ERROR_RETURN(error, true);
+    }
+
+    profile_ = profile;
+    return false;
+}
+
+rai::StorageProfile rai::Store::Profile() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return profile_;
+}
+
+bool rai::Store::Sync()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (profile_ == rai::StorageProfile::DURABLE)
+    {
+        return false;
+    }
+    return env_.Sync(true);
 }
 
 bool rai::Store::Put(MDB_txn* txn, MDB_dbi dbi, MDB_val* key, MDB_val* value)
@@ -107,6 +365,18 @@ bool rai::Store::Put(MDB_txn* txn, MDB_dbi dbi, MDB_val* key, MDB_val* value)
     return false;
 }
 
+bool rai::Store::Append(MDB_txn* txn, MDB_dbi dbi, MDB_val* key,
+                        MDB_val* value)
+{
+    auto ret = mdb_put(txn, dbi, key, value, MDB_APPEND);
+    if (ret != MDB_SUCCESS)
+    {
+        return true;
+    }
+
+    return false;
+}
+
 bool rai::Store::Get(MDB_txn* txn, MDB_dbi dbi, MDB_val* key,
                      MDB_val* value) const
 {
@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include <boost/filesystem.hpp>
 #include <lmdb/libraries/liblmdb/lmdb.h>
 #include <rai/common/errors.hpp>
@@ -8,16 +9,63 @@
 
 namespace rai
 {
+enum class StorageProfile : uint8_t
+{
+    INVALID   = 0,
+    DURABLE   = 1,  // sync on every commit
+    FAST_SYNC = 2,  // async commits, flushed every sync_interval_
+    BOOTSTRAP = 3,  // async commits, flushed when leaving the profile
+
+    MAX
+};
+std::string StorageProfileToString(rai::StorageProfile);
+rai::StorageProfile StringToStorageProfile(const std::string&);
+
+class StorageConfig
+{
+public:
+    StorageConfig();
+    rai::ErrorCode DeserializeJson(bool&, rai::Ptree&);
+    void SerializeJson(rai::Ptree&) const;
+    rai::ErrorCode UpgradeJson(bool&, uint32_t, rai::Ptree&) const;
+    uint64_t MapSize() const;
+    unsigned int OpenFlags() const;
+
+    static uint64_t constexpr DEFAULT_MAP_SIZE_GB  = 128;
+    static uint32_t constexpr DEFAULT_SYNC_INTERVAL = 10;
+
+    rai::StorageProfile profile_;
+    uint64_t map_size_gb_;
+    bool write_map_;
+    bool no_read_ahead_;
+    uint32_t sync_interval_;
+    bool bootstrap_on_sync_;
+};
 
 class Store
 {
 public:
     Store(rai::ErrorCode&, const boost::filesystem::path&);
+    Store(rai::ErrorCode&, const boost::filesystem::path&,
+          const rai::StorageConfig&);
     Store(const rai::Store&) = delete;
     bool Put(MDB_txn*, MDB_dbi, MDB_val*, MDB_val*);
+    bool Append(MDB_txn*, MDB_dbi, MDB_val*, MDB_val*);
     bool Get(MDB_txn*, MDB_dbi, MDB_val*, MDB_val*) const;
     bool Del(MDB_txn*, MDB_dbi, MDB_val*, MDB_val*);
+    bool SetProfile(rai::StorageProfile);
+    rai::StorageProfile Profile() const;
+    bool Sync();
 
+    static unsigned int constexpr PROFILE_FLAGS =
+        MDB_NOSYNC | MDB_NOMETASYNC | MDB_MAPASYNC;
+
+private:
+    mutable std::mutex mutex_;
+    rai::StorageProfile profile_;
+    bool write_map_;
+
+public:
     rai::MdbEnv env_;
 
     /***************************************************************************
@@ -80,5 +128,26 @@ public:
      Value: rai::Block/junk
      **************************************************************************/
     MDB_dbi sources_;
+
+    /***************************************************************************
+     Per-account count and sum of receivables_, maintained on write
+     Key: rai::Account
+     Value: rai::AmountSummary
+     **************************************************************************/
+    MDB_dbi receivable_summaries_;
+
+    /***************************************************************************
+     Per-account count and sum of rewardables_, maintained on write
+     Key: rai::Account
+     Value: rai::AmountSummary
+     **************************************************************************/
+    MDB_dbi rewardable_summaries_;
+
+    /***************************************************************************
+     Callback outbox, appended in the transaction that confirms the block
+     Key: uint64_t sequence
+     Value: JSON notification
+     **************************************************************************/
+    MDB_dbi callbacks_;
 };
 } // namespace rai
\ No newline at end of file
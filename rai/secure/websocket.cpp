@@ -1,6 +1,7 @@
 #include <rai/secure/websocket.hpp>
 
 #include <boost/property_tree/json_parser.hpp>
+#include <rai/common/json.hpp>
 #include <rai/common/util.hpp>
 #include <rai/secure/plat.hpp>
 
@@ -246,10 +247,7 @@ void rai::WebsocketClient::Send(const std::string& message)
 
 void rai::WebsocketClient::Send(const rai::Ptree& message)
 {
-    std::stringstream ostream;
-    boost::property_tree::write_json(ostream, message);
-    ostream.flush();
-    Send(ostream.str());
+    Send(rai::PtreeToJson(message));
 }
 
 std::shared_ptr<rai::WebsocketClient> rai::WebsocketClient::Shared()
@@ -699,26 +699,17 @@ void rai::Wallets::AccountBalanceAll(const rai::Account& account,
         return;
     }
 
-    rai::Amount sum(0);
-    rai::Iterator i = ledger_.ReceivableInfoLowerBound(transaction, account);
-    rai::Iterator n = ledger_.ReceivableInfoUpperBound(transaction, account);
-    for (; i != n; ++i)
+    rai::AmountSummary summary;
+    bool error = ledger_.ReceivableSummaryGet(transaction, account, summary);
+    if (error)
     {
-        rai::Account account_l;
-        rai::BlockHash hash;
-        rai::ReceivableInfo info;
-        bool error = ledger_.ReceivableInfoGet(i, account_l, hash, info);
-        if (error)
-        {
-            // log
-            return;
-        }
-        sum += info.amount_;
+        // log
+        return;
     }
-    receivable = sum;
+    receivable = summary.amount_;
 
     rai::AccountInfo info;
-    bool error = ledger_.AccountInfoGet(transaction, account, info);
+    error = ledger_.AccountInfoGet(transaction, account, info);
     IF_ERROR_RETURN_VOID(error);
 
     std::shared_ptr<rai::Block> head(nullptr);